@@ -80,4 +80,10 @@ protected:
 	UFUNCTION(Category="KeshUI|Component|Canvas Item", BlueprintCallable)
 	virtual void ConstructNewItem();
 
+	/* Returns the texture the item draws, if any.  Reported to the render backend. */
+	virtual const FTexture* GetItemTexture() const;
+
+	/* Positions the item and draws it through the render backend. */
+	virtual void RenderItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size, UKUIInterfaceElement* oRenderCacheObject );
+
 };
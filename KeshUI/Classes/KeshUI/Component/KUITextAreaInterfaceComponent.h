@@ -0,0 +1,148 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#include "KeshUI/Component/KUITextInterfaceComponent.h"
+#include "KeshUI/KUIMacros.h"
+#include "KUITextAreaInterfaceComponent.generated.h"
+
+#define KUI_TEXT_AREA_NO_MAX_PARAGRAPHS 0
+
+/* A paragraph of a text area and the lines it wraps to. */
+struct FKUITextAreaParagraph
+{
+	FString strText;
+	TArray<FKUITextLineSpan> arLines;
+	int32 iFirstLine;
+};
+
+
+/**
+ * KeshUI UI Framework (KUI) multi-line text render component.  Holds its text as paragraphs that are
+ * wrapped to a fixed width as they are added and only draws the lines that are visible, either on the
+ * canvas or in the sub container it's placed in.  Paragraphs can be appended without rewrapping the
+ * existing text and the history can be capped, discarding the oldest paragraphs, for logs and chat.
+ */
+UCLASS(ClassGroup="KeshUI|Component", Blueprintable, BlueprintType)
+class KESHUI_API UKUITextAreaInterfaceComponent : public UKUITextInterfaceComponent
+{
+	GENERATED_BODY()
+	KUI_CLASS_HEADER( UKUITextAreaInterfaceComponent )
+
+	UKUITextAreaInterfaceComponent( const class FObjectInitializer& oObjectInitializer );
+
+public:
+
+	/* Replaces the text, splitting it into paragraphs on new lines. */
+	virtual void SetText( const FText& txText ) override;
+
+	/* Adds a paragraph to the end of the text.  Only the new paragraph is wrapped. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual void AppendParagraph( const FString& strParagraph );
+
+	/* Removes all the text. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual void ClearParagraphs();
+
+	/* Gets the number of paragraphs. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual int32 GetParagraphCount() const;
+
+	/* Gets a paragraph, the oldest being 0. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual const FString& GetParagraph( int32 iIndex ) const;
+
+	/* Gets the maximum number of paragraphs kept.  KUI_TEXT_AREA_NO_MAX_PARAGRAPHS for no max. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual int32 GetMaxParagraphs() const;
+
+	/* Sets the maximum number of paragraphs kept, discarding the oldest.  KUI_TEXT_AREA_NO_MAX_PARAGRAPHS for no max. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual void SetMaxParagraphs( int32 iMaxParagraphs );
+
+	/* Gets the width text is wrapped to.  0 for no wrapping. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual float GetWrapWidth() const;
+
+	/* Sets the width text is wrapped to.  0 for no wrapping. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual void SetWrapWidth( float fWrapWidth );
+
+	/* Gets the string that wrapped lines are indented by. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual const FString& GetIndentString() const;
+
+	/* Sets the string that wrapped lines are indented by. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual void SetIndentString( const FString& strIndentString );
+
+	/* Gets the extra space between lines. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual float GetLineSpacing() const;
+
+	/* Sets the extra space between lines. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual void SetLineSpacing( float fLineSpacing );
+
+	/* Gets the height of a line, including spacing. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual float GetLineHeight() const;
+
+	/* Gets the number of wrapped lines. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual int32 GetLineCount() const;
+
+	/* Gets a wrapped line, the first being 0. */
+	UFUNCTION(Category="KeshUI|Component|Text Area", BlueprintCallable)
+	virtual FString GetLine( int32 iLine ) const;
+
+	/* Gets the size of the wrapped text. */
+	virtual const FVector2D& GetSize() const override;
+
+	/* Returns true if there's enough information to render. */
+	virtual bool HasValidComponents() const override;
+
+protected:
+
+	TArray<FKUITextAreaParagraph> arParagraphs;
+	int32 iParagraphHead;
+	int32 iParagraphCount;
+	int32 iMaxParagraphs;
+	FString strIndentString;
+	float fWrapWidth;
+	float fLineSpacing;
+	float fMaxLineWidth;
+	float fIndentWidth;
+	bool bValidWrap;
+	UFont* foWrapFont;
+	float fWrapScale;
+
+	/* Returns the paragraph at the given index, the oldest being 0. */
+	virtual FKUITextAreaParagraph& GetParagraphAt( int32 iIndex );
+	virtual const FKUITextAreaParagraph& GetParagraphAt( int32 iIndex ) const;
+
+	/* Returns the index of the paragraph containing the given line. */
+	virtual int32 GetParagraphForLine( int32 iLine ) const;
+
+	/* Wraps a paragraph starting at the given line. */
+	virtual void WrapParagraph( FKUITextAreaParagraph& stParagraph, int32 iFirstLine );
+
+	/* Rewraps every paragraph if the wrapping settings have changed. */
+	virtual void UpdateWrap();
+
+	/* Marks the text as needing rewrapping. */
+	virtual void InvalidateWrap();
+
+	/* Sends the size change to the container and invalidates the render cache. */
+	virtual void OnLinesChanged();
+
+	/* Puts the paragraphs in order from the start of the array. */
+	virtual void NormalizeParagraphs();
+
+	/* Gets the range of lines that intersect the canvas being drawn into. */
+	virtual void GetVisibleLines( UCanvas* oCanvas, const FVector2D& v2RenderLocation, int32& iFirstLine, int32& iLastLine ) const;
+
+	/* Draws each visible line. */
+	virtual void RenderItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size, UKUIInterfaceElement* oRenderCacheObject ) override;
+
+};
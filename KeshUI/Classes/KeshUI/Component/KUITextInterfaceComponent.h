@@ -4,8 +4,34 @@
 
 #include "KeshUI/Component/KUICanvasItemInterfaceComponent.h"
 #include "KeshUI/KUIMacros.h"
+#include "KeshUI/KUITextAtlas.h"
 #include "KUITextInterfaceComponent.generated.h"
 
+/* A wrapped line of text, referring back into the source string. */
+struct FKUITextLineSpan
+{
+	int32 iStart;
+	int32 iLength;
+	float fWidth;
+	bool bHyphenated;
+};
+
+
+/* Groups of text item properties that are copied to the FCanvasTextItem together. */
+namespace EKUITextItemSync
+{
+	enum Type
+	{
+		S_None   = 0,
+		S_Style  = 1 << 0,
+		S_Text   = 1 << 1,
+		S_Shadow = 1 << 2,
+		S_Clip   = 1 << 3,
+		S_All    = S_Style | S_Text | S_Shadow | S_Clip
+	};
+}
+
+
 /**
  * KeshUI UI Framework (KUI) Text render component.
  */
@@ -169,6 +195,31 @@ public:
 	UFUNCTION( Category = "KeshUI|Component|Text", BlueprintCallable )
 	virtual const FVector2D GetSizeString( const FString& strString ) const;
 
+	/**
+	 * Fills the array with the x offset at which each character of the string starts, followed by the
+	 * offset of the end of the string, using this component's settings.
+	 */
+	UFUNCTION( Category = "KeshUI|Component|Text", BlueprintCallable )
+	virtual void GetCharacterOffsets( const FString& strString, TArray<float>& arOffsets ) const;
+
+	/**
+	 * Gets the width of the characters from iStart up to, but not including, iEnd using offsets from
+	 * GetCharacterOffsets.  Matches the width GetSizeString would return for the same substring.
+	 */
+	UFUNCTION( Category = "KeshUI|Component|Text", BlueprintCallable )
+	virtual float GetRangeWidth( const TArray<float>& arOffsets, int32 iStart, int32 iEnd ) const;
+
+	/* Returns true if the text is pre-rasterized into the interface's text atlas. */
+	UFUNCTION( Category = "KeshUI|Component|Text", BlueprintCallable )
+	virtual bool IsUsingTextAtlas() const;
+
+	/**
+	 * Sets whether the text is pre-rasterized into the interface's text atlas and drawn as a single quad
+	 * until it changes.  Suits static labels.  Clipped text and text too large for a page draw normally.
+	 */
+	UFUNCTION( Category = "KeshUI|Component|Text", BlueprintCallable )
+	virtual void SetUsingTextAtlas( bool bUseTextAtlas );
+
 	/* Returns true if there's enough information to render. */
 	virtual bool HasValidComponents() const override;
 
@@ -177,6 +228,13 @@ public:
 	/* Splits a string up into an array of strings with the given parameters. */
 	static TArray<FString> SplitString( const FString& strString, UFont* foFont, float fMaxWidth, const FString& strIndentString );
 
+	/**
+	 * Breaks a string into lines no wider than fMaxWidth, following the same rules as SplitString.
+	 * Lines after the first are indented by the width of strIndentString.  Span widths include the
+	 * hyphen on hyphenated lines but not the indent.
+	 */
+	static void WrapString( const FString& strString, UFont* foFont, float fMaxWidth, const FString& strIndentString, TArray<FKUITextLineSpan>& arLines );
+
 protected:
 
 	FText txText;
@@ -192,7 +250,6 @@ protected:
 	bool bOutlined;
 	FLinearColor lcOutlineColor;
 	bool bShadow;
-	bool bUpdateShadowInfo;
 	FVector2D v2ShadowOffset;
 	FLinearColor lcShadowColor;
 	bool bClipped;
@@ -200,10 +257,25 @@ protected:
 	bool bDontCorrectStereoscopic;
 	bool bValidSize;
 	FVector2D v2Size;
+	uint8 iItemSyncMask;
+	bool bUseTextAtlas;
+	FKUITextAtlasHandle stAtlasHandle;
+
+	/* Marks groups of properties as needing to be copied to the FCanvasTextItem. */
+	virtual void InvalidateTextItem( uint8 iSyncMask );
 
 	/* Tries to construct a new FCanvasTextItem! */
 	virtual void ConstructNewItem() override;
 
+	/* Copies the changed text settings to the FCanvasTextItem. */
+	virtual void UpdateTextItem();
+
+	/* Draws the text from the text atlas, rasterizing it first if needed.  Returns false if it can't be. */
+	virtual bool RenderAtlasItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size );
+
+	/* Draws the text through the render backend so it can be merged with adjacent text. */
+	virtual void RenderItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size, UKUIInterfaceElement* oRenderCacheObject ) override;
+
 private:
 
 	// This makes no sense, override to disable - size is based on text properties.
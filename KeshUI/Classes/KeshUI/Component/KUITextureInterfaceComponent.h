@@ -125,4 +125,6 @@ protected:
 	/* Tries to construct a new FCanvasTileItem! */
 	virtual void ConstructNewItem() override;
 
+	virtual const FTexture* GetItemTexture() const override;
+
 };
@@ -0,0 +1,189 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/KUIMacros.h"
+#include "KUIFlexContainer.generated.h"
+
+UENUM( BlueprintType )
+namespace EKUIFlexDirection
+{
+	enum Type
+	{
+		FD_Row         UMETA(DisplayName="Row"),
+		FD_Column      UMETA(DisplayName="Column"),
+		FD_Max         UMETA(Hidden)
+	};
+}
+
+UENUM( BlueprintType )
+namespace EKUIFlexJustify
+{
+	enum Type
+	{
+		FJ_Start        UMETA(DisplayName="Packed at the Start"),
+		FJ_Centre       UMETA(DisplayName="Packed in the Centre"),
+		FJ_End          UMETA(DisplayName="Packed at the End"),
+		FJ_SpaceBetween UMETA(DisplayName="Spread with Space Between"),
+		FJ_SpaceAround  UMETA(DisplayName="Spread with Space Around"),
+		FJ_Max          UMETA(Hidden)
+	};
+}
+
+UENUM( BlueprintType )
+namespace EKUIFlexAlign
+{
+	enum Type
+	{
+		FA_Start       UMETA(DisplayName="Start of the Line"),
+		FA_Centre      UMETA(DisplayName="Centre of the Line"),
+		FA_End         UMETA(DisplayName="End of the Line"),
+		FA_Stretch     UMETA(DisplayName="Stretched to the Line"),
+		FA_Max         UMETA(Hidden)
+	};
+}
+
+/* A child laid out by a flex container and where it was last put. */
+struct FKUIFlexItem
+{
+	TWeakObjectPtr<UKUIInterfaceElement> oElement;
+	float fGrow;
+	float fShrink;
+	float fBasis;
+	FVector2D v2Measured;
+	FVector2D v2Assigned;
+	FVector2D v2Location;
+	bool bVisible;
+};
+
+
+/**
+ * Container that lays its items out in a row or column, flex box style.  Items start at their basis
+ * size (or their own size) along the main axis and share out any space left over by their grow factors,
+ * or give up space by their shrink factors if there isn't enough.  With wrapping, items that don't fit
+ * start a new line.  The solved layout is kept and only worked out again when the container's size,
+ * an item's own size or one of the settings changes.
+ **/
+UCLASS(ClassGroup="KeshUI|Container", BlueprintType, Blueprintable)
+class KESHUI_API UKUIFlexContainer : public UKUIInterfaceContainer
+{
+	GENERATED_BODY()
+	KUI_CLASS_HEADER( UKUIFlexContainer )
+
+	UKUIFlexContainer( const class FObjectInitializer& oObjectInitializer );
+
+public:
+
+	/* Adds an element to the end of the flex layout.  Adds to container if necessary. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void AddFlexItem( UKUIInterfaceElement* oChild, float fGrow = 0.f, float fShrink = 1.f );
+
+	/* Removes an element from the flex layout.  Does not remove it from the container. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void RemoveFlexItem( UKUIInterfaceElement* oChild );
+
+	/* Removes a child from this container and from the flex layout. */
+	virtual bool RemoveChild( UKUIInterfaceElement* oChild ) override;
+
+	/* Returns true for everything added to the flex layout. */
+	virtual bool IsChildsLayoutManaged( UKUIInterfaceElement* oChild ) const override;
+
+	/* Gets the number of items in the flex layout. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual int32 GetFlexItemCount() const;
+
+	/* Gets the share of spare space an item takes. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual float GetFlexGrow( UKUIInterfaceElement* oChild ) const;
+
+	/* Sets the share of spare space an item takes.  0 keeps it at its basis size. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetFlexGrow( UKUIInterfaceElement* oChild, float fGrow );
+
+	/* Gets how readily an item gives up space when there isn't enough. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual float GetFlexShrink( UKUIInterfaceElement* oChild ) const;
+
+	/* Sets how readily an item gives up space when there isn't enough.  0 never shrinks it. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetFlexShrink( UKUIInterfaceElement* oChild, float fShrink );
+
+	/* Gets the main axis size an item starts from. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual float GetFlexBasis( UKUIInterfaceElement* oChild ) const;
+
+	/* Sets the main axis size an item starts from.  Less than 0 uses the item's own size. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetFlexBasis( UKUIInterfaceElement* oChild, float fBasis );
+
+	/* Gets the direction items are laid out in. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual TEnumAsByte<EKUIFlexDirection::Type> GetDirection() const;
+
+	/* Sets the direction items are laid out in. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetDirection( TEnumAsByte<EKUIFlexDirection::Type> eDirection );
+
+	/* Returns true if items that don't fit start a new line. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual bool IsWrapping() const;
+
+	/* Sets whether items that don't fit start a new line. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetWrapping( bool bWrap );
+
+	/* Gets the space between items and between lines. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual float GetGap() const;
+
+	/* Sets the space between items and between lines. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetGap( float fGap );
+
+	/* Gets how spare space on a line is spread when no item grows into it. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual TEnumAsByte<EKUIFlexJustify::Type> GetJustify() const;
+
+	/* Sets how spare space on a line is spread when no item grows into it. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetJustify( TEnumAsByte<EKUIFlexJustify::Type> eJustify );
+
+	/* Gets where items sit across their line. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual TEnumAsByte<EKUIFlexAlign::Type> GetItemAlign() const;
+
+	/* Sets where items sit across their line. */
+	UFUNCTION(Category="KeshUI|Container|Flex", BlueprintCallable)
+	virtual void SetItemAlign( TEnumAsByte<EKUIFlexAlign::Type> eAlign );
+
+	/* Updates the layout of this container. */
+	virtual void SetSize( float fWidth, float fHeight ) override;
+
+protected:
+
+	TArray<FKUIFlexItem> arItems;
+	TEnumAsByte<EKUIFlexDirection::Type> eDirection;
+	TEnumAsByte<EKUIFlexJustify::Type> eJustify;
+	TEnumAsByte<EKUIFlexAlign::Type> eItemAlign;
+	bool bWrap;
+	float fGap;
+	bool bValidSolution;
+	FVector2D v2SolvedSize;
+
+	/* Returns the index of the element's item, or INDEX_NONE. */
+	virtual int32 GetFlexItemIndex( UKUIInterfaceElement* oChild ) const;
+
+	/* Keeps an item's own size as its measured size, unless it is the size the layout gave it. */
+	virtual void OnChildSizeChange( const FKUIInterfaceContainerElementEvent& stEventInfo ) override;
+
+	/* Returns true if the sizes or visibility the solution was worked out from have changed. */
+	virtual bool IsSolutionStale() const;
+
+	/* Works out where every item goes and how big it is. */
+	virtual void SolveLayout();
+
+	/* Lays out the flex items, solving again only if needed. */
+	virtual void DoLayout() override;
+
+};
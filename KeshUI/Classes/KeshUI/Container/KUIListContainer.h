@@ -4,6 +4,7 @@
 
 #include "KeshUI/KUIInterfaceContainer.h"
 #include "KeshUI/KUIMacros.h"
+#include "KeshUI/KUIRowOffsetTree.h"
 #include "KUIListContainer.generated.h"
 
 class UKUIListRowContainer;
@@ -117,6 +118,19 @@ public:
 	/* Updates the layout of this container. */
 	virtual void SetSize( float fWidth, float fHeight ) override;
 
+	/* Returns the offset of the top of the given row from the top of the list. */
+	UFUNCTION( Category = "KeshUI|Container|List", BlueprintCallable )
+	float GetRowOffsetBP( int32 iRow ) const { return GetRowOffset( iRow ); }
+	virtual float GetRowOffset( uint16 iRow ) const;
+
+	/* Returns the row at the given offset from the top of the list.  Does not include row spacing. */
+	UFUNCTION( Category = "KeshUI|Container|List", BlueprintCallable )
+	int32 GetRowAtOffsetBP( float fOffset ) const { return GetRowAtOffset( fOffset ); }
+	virtual uint16 GetRowAtOffset( float fOffset ) const;
+
+	/* Invalidates the row offsets as well as the layout. */
+	virtual void InvalidateLayout() override;
+
 	/* Returns true if the given row is selected. */
 	UFUNCTION( Category = "KeshUI|Container|List", BlueprintCallable )
 	virtual bool IsRowSelected( UKUIListRowContainer* ctRow ) const;
@@ -292,6 +306,9 @@ protected:
 	float fMaxHeight;
 	bool bEnableMultiSelect;
 	bool bEnableSelect;
+	FKUIRowOffsetTree oRowOffsets;
+	bool bValidRowOffsets;
+	int32 iFirstDirtyRow;
 	TWeakObjectPtr<UKUIListRowContainer> ctLastSelected;
 	TArray<TWeakObjectPtr<UKUIListRowContainer>> arSelectedRows;
 	FKUIListRowContainerSelectionChangeDelegate dgSelectionChange;
@@ -301,9 +318,24 @@ protected:
 
 	virtual void OnChildSizeChange( const FKUIInterfaceContainerElementEvent& stEventInfo ) override;
 
-	/* Lays out the list elements. */
+	/* Rebuilds the row offsets and sizes the list to fit its rows. */
+	virtual void MeasureLayout() override;
+
+	/* Positions the rows below the first one that changed. */
 	virtual void DoLayout() override;
 
+	/* Returns the height of the row after min/max clamping. */
+	virtual float GetClampedRowHeight( uint16 iRow ) const;
+
+	/* Returns the space the row takes in the list, including spacing.  Hidden rows take none. */
+	virtual float CalculateRowExtent( uint16 iRow ) const;
+
+	/* Rebuilds the row offset index from the row sizes. */
+	virtual void RebuildRowOffsets();
+
+	/* Updates a single row in the offset index and marks the rows below it for re-positioning. */
+	virtual void UpdateRowExtent( uint16 iRow );
+
 	virtual uint16 GetRowIndexByRef( UKUIListRowContainer* ctRow ) const;
 	virtual uint16 GetSelectedRowIndexByRef( UKUIListRowContainer* ctRow ) const;
 
@@ -62,17 +62,37 @@ public:
 	UFUNCTION( Category = "KeshUI|Container|List", BlueprintCallable )
 	virtual void SetSelectedBackgroundColor( const FColor& stColor );
 
+	/* Gets this row's index in its list.  KUI_LIST_INDEX_NONE if it isn't in one. */
+	virtual uint16 GetListIndex() const;
+
+	/* Sets this row's index in its list.  Called by the list whenever the row moves. */
+	virtual void SetListIndex( uint16 iIndex );
+
 	/* Updates selected status. */
 	virtual void OnAddedToContainer( const FKUIInterfaceElementContainerEvent& stEventInfo ) override;
 
 	/* Updates selected status. */
 	virtual void OnRemovedFromContainer( const FKUIInterfaceElementContainerEvent& stEventInfo ) override;
 
-	virtual void DoLayout() override;
+	/* Returns true if the row sizes itself to fit its elements. */
+	UFUNCTION( Category = "KeshUI|Container|List", BlueprintCallable )
+	virtual bool IsMeasuringHeight() const;
+
+	/* Sets whether the row sizes itself to fit its elements.  Turned off when its owner sets the size instead. */
+	UFUNCTION( Category = "KeshUI|Container|List", BlueprintCallable )
+	virtual void SetMeasuringHeight( bool bMeasureHeight );
+
+	/* Sizes the row to fit its tallest element, if it's measuring its height. */
+	virtual void MeasureLayout() override;
+
+	/* Hidden rows take no space, so the list is notified. */
+	virtual void SetVisible( bool bVisible ) override;
 
 protected:
 
 	bool bSelectedCache;
+	uint16 iListIndex;
+	bool bMeasureHeight;
 
 	FColor stUnselectedForegroundColor;
 	FColor stUnselectedBackgroundColor;
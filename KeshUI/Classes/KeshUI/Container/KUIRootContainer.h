@@ -31,10 +31,22 @@ public:
 	/* Returns true if this is visible. */
 	virtual bool IsVisibleRecursive() const override;
 
+	/* Also updates the interface's subscriber index. */
+	virtual void SubscribeToEvent( uint8 iEventID ) override;
+
+	/* Also updates the interface's subscriber index. */
+	virtual void UnsubscribeFromEvent( uint8 iEventID ) override;
+
 protected:
 
 	TWeakObjectPtr<AKUIInterface> aInterface;
 
+	/* Also updates the interface's subscriber index. */
+	virtual void AddEventSubscribers( uint8 iEventID, int32 iCount ) override;
+
+	/* Also updates the interface's subscriber index. */
+	virtual void RemoveEventSubscribers( uint8 iEventID, int32 iCount ) override;
+
 	/* Sets the root container to the size of the screen. */
 	virtual void OnScreenResolutionChange( const FKUIInterfaceContainerScreenResolutionEvent& stEventInfo );
 
@@ -73,4 +73,10 @@ protected:
 	/* Updates the render cache status if we have valid values. */
 	virtual void UpdateRenderCacheSize();
 
+	/* Children are offset by the corner offset. */
+	virtual const FVector2D GetNestedOffset() const override;
+
+	/* The visible area starts at the corner offset. */
+	virtual const FVector2D GetHitTestLocation() const override;
+
 };
@@ -4,11 +4,15 @@
 
 #include "KeshUI/KUIRenderCache.h"
 #include "KeshUI/KUIMacros.h"
+#include "KeshUI/KUIRenderCacheTileGrid.h"
 #include "KUISubContainerRenderCache.generated.h"
 
+class UKUISubContainer;
+
 
 /**
-* Wrapper for the render to texture stuff.
+* Wrapper for the render to texture stuff.  Caches the sub container's contents in tiles around
+* the visible area, so memory is bounded by the size of the sub container rather than its total size.
 */
 UCLASS( ClassGroup = "KeshUI|Container", Blueprintable, BlueprintType, NotPlaceable )
 class KESHUI_API UKUISubContainerRenderCache : public UKUIRenderCache
@@ -22,4 +26,32 @@ public:
 
 	virtual void UpdateRenderCache( UKUIInterfaceElement* oElement ) override;
 
+	/* Also invalid if the visible area has moved or any tiles need redrawing. */
+	virtual bool IsRenderCacheValid() const override;
+
+	/* Marks the tiles overlapping the area for redrawing. */
+	virtual void InvalidateRenderCacheRect( const FVector2D& v2Min, const FVector2D& v2Max ) override;
+
+	/* Draws the visible portions of the tiles. */
+	virtual void Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject = NULL ) override;
+
+	/* Returns the tile bookkeeping. */
+	virtual const FKUIRenderCacheTileGrid& GetTileGrid() const;
+
+protected:
+
+	FKUIRenderCacheTileGrid oTileGrid;
+	TWeakObjectPtr<UKUISubContainer> ctSubContainer;
+
+	UPROPERTY()
+	TArray<UTextureRenderTarget2D*> arTileTargets;
+
+	virtual void DestroyRenderCache() override;
+
+	/* Returns the visible region of the sub container, in content space. */
+	virtual void GetVisibleRegion( FVector2D& v2Min, FVector2D& v2Max ) const;
+
+	/* Children are drawn relative to the top left of the total area. */
+	virtual FVector2D GetContentOrigin( UKUIInterfaceElement* oOwner ) const override;
+
 };
@@ -0,0 +1,163 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#include "KeshUI/Container/KUIScrollContainer.h"
+#include "KeshUI/KUIMacros.h"
+#include "KeshUI/KUIRowOffsetTree.h"
+#include "KUIVirtualListContainer.generated.h"
+
+class UKUIListRowContainer;
+
+#define KUI_VIRTUAL_LIST_POOL_PADDING 2
+
+KUI_DECLARE_DELEGATE_TwoParams( FKUIVirtualListBindRow, UKUIListRowContainer*, int32 );
+
+/**
+ * Scrolling list that is driven by a row count and a bind callback.  Only the rows in the visible
+ * window exist as elements; they are recycled and re-bound as the list is scrolled.
+ **/
+UCLASS( ClassGroup = "KeshUI|Container", BlueprintType, Blueprintable )
+class KESHUI_API UKUIVirtualListContainer : public UKUIScrollContainer
+{
+	GENERATED_BODY()
+	KUI_CLASS_HEADER( UKUIVirtualListContainer )
+
+	UKUIVirtualListContainer( const class FObjectInitializer& oObjectInitializer );
+
+public:
+
+	/* Gets the number of data rows in the list. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual int32 GetVirtualRowCount() const;
+
+	/* Sets the number of data rows in the list.  Visible rows are re-bound. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void SetVirtualRowCount( int32 iRowCount );
+
+	/* Gets the height used for rows without a cached height. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual float GetDefaultRowHeight() const;
+
+	/* Sets the height used for rows without a cached height. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void SetDefaultRowHeight( float fHeight );
+
+	/* Gets the height of a specific row. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual float GetVirtualRowHeight( int32 iRow ) const;
+
+	/* Sets the height of a specific row.  Switches the list to variable height rows. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void SetVirtualRowHeight( int32 iRow, float fHeight );
+
+	/* Removes all cached row heights.  Switches the list back to fixed height rows. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void ClearVirtualRowHeights();
+
+	/* Returns true if rows have varying heights. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual bool HasVariableRowHeights() const;
+
+	/* Gets the space between rows. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual float GetRowSpacing() const;
+
+	/* Sets the space between rows. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void SetRowSpacing( float fSpacing );
+
+	/* Gets the class instantiated for pooled rows. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual TSubclassOf<UKUIListRowContainer> GetRowClass() const;
+
+	/* Sets the class instantiated for pooled rows.  Destroys the current pool. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void SetRowClass( TSubclassOf<UKUIListRowContainer> cRowClass );
+
+	/* Returns the offset of the top of the given row from the top of the list. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual float GetRowOffset( int32 iRow ) const;
+
+	/* Returns the row at the given offset from the top of the list, or INDEX_NONE. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual int32 GetRowAtOffset( float fOffset ) const;
+
+	/* Returns the total height of all the rows. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual float GetTotalRowHeight() const;
+
+	/* Returns the pooled row currently bound to the given data row, or null if it isn't visible. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual UKUIListRowContainer* GetBoundRow( int32 iRow ) const;
+
+	/* Returns the number of row elements that have been created. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual int32 GetPooledRowCount() const;
+
+	/* Re-binds every visible row on the next render. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void RefreshRows();
+
+	/* Re-binds the given row, if it is visible. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void RefreshRow( int32 iRow );
+
+	/* Scrolls so the given row is at the top of the visible area. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintCallable )
+	virtual void ScrollToRow( int32 iRow );
+
+	/* Sets the delegate called when a pooled row is bound to a data row. */
+	virtual void SetBindRowDelegate( UObject* oObject, FKUIVirtualListBindRowPrototype fnBindRowDelegate );
+
+	/* Called when a pooled row is bound to a data row. */
+	UFUNCTION( Category = "KeshUI|Container|VirtualList", BlueprintImplementableEvent )
+	virtual void OnBindRowBP( UKUIListRowContainer* ctRow, int32 iRow );
+
+	virtual void SetSize( float fWidth, float fHeight ) override;
+
+	virtual void Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject = NULL ) override;
+
+protected:
+
+	int32 iVirtualRowCount;
+	float fDefaultRowHeight;
+	float fSpacing;
+	TArray<float> arRowHeights;
+	mutable FKUIRowOffsetTree oRowOffsets;
+	mutable bool bValidRowOffsets;
+	TSubclassOf<UKUIListRowContainer> cRowClass;
+	TArray<int32> arPoolBindings;
+	int32 iFirstVisibleRow;
+	int32 iLastVisibleRow;
+	float fLastScrollOffset;
+	float fLastVisibleHeight;
+	bool bValidVisibleRows;
+	bool bValidScrollExtent;
+	FKUIVirtualListBindRowDelegate dgBindRow;
+
+	UPROPERTY()
+	TArray<UKUIListRowContainer*> arRowPool;
+
+	/* Rebuilds the row offset tree for variable height rows. */
+	virtual void UpdateRowOffsets() const;
+
+	/* Updates the scrollable size from the row heights. */
+	virtual void UpdateScrollExtent();
+
+	/* Binds pooled rows to the data rows in the visible window. */
+	virtual void UpdateVisibleRows();
+
+	/* Creates a new row for the pool and returns its index. */
+	virtual int32 CreatePooledRow();
+
+	/* Positions and binds a pooled row to a data row. */
+	virtual void BindPooledRow( int32 iPoolIndex, int32 iRow );
+
+	/* Removes all the pooled rows. */
+	virtual void DestroyRowPool();
+
+	/* Invalidates the offsets, scroll extent and visible rows. */
+	virtual void InvalidateVirtualLayout();
+
+};
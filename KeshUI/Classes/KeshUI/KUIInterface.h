@@ -5,6 +5,12 @@
 #include "KeshUI/KUIMacros.h"
 #include "KeshUI/KUIInterfaceElement.h"
 #include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/KUITextMeasureCache.h"
+#include "KeshUI/KUIHitTestGrid.h"
+#include "KeshUI/KUIBatchUpdateScope.h"
+#include "KeshUI/KUIRenderTargetPool.h"
+#include "KeshUI/KUITextAtlas.h"
+#include "KeshUI/KUIRenderBackend.h"
 #include "KUIInterface.generated.h"
 
 #define KUIBroadcastEventObj( o, t, ... ) \
@@ -105,6 +111,9 @@ public:
 	UFUNCTION(Category = "KeshUI|Interface", BlueprintCallable)
 	virtual FVector2D GetScreenResolution() const;
 
+	/* Applies a screen resolution straight away.  For interfaces driven without a viewport, such as by the automation tests. */
+	virtual void SetScreenResolution( const FVector2D& v2Resolution );
+
 	/* Gets the cursor location. */
 	UFUNCTION(Category = "KeshUI|Interface", BlueprintCallable)
 	virtual FVector2D GetCursorLocation() const;
@@ -203,9 +212,87 @@ public:
 
 	virtual void PostInitializeComponents() override;
 
+	virtual void EndPlay( const EEndPlayReason::Type eEndPlayReason ) override;
+
 	/* Broadcasts events to components. */
 	virtual void BroadcastEvent( FKUIInterfaceEvent& stEventInfo, bool bTopDown = false, bool bIncludeCursor = true );
 
+	/* Returns the number of containers in the interface that respond to the given subscription event. */
+	virtual int32 GetEventSubscribers( uint8 iEventID ) const;
+
+	/* Adds to the number of subscribers to an event.  Called by the root containers. */
+	virtual void AddEventSubscribers( uint8 iEventID, int32 iCount );
+
+	/* Removes from the number of subscribers to an event.  Called by the root containers. */
+	virtual void RemoveEventSubscribers( uint8 iEventID, int32 iCount );
+
+	/* Returns the topmost mouse input element rendered at the given screen location in the last frame. */
+	UFUNCTION( Category = "KeshUI|Interface", BlueprintCallable )
+	virtual UKUIInterfaceElement* GetElementAtPoint( const FVector2D& v2Point ) const;
+
+	/* Returns the topmost mouse input element rendered under the cursor in the last frame. */
+	UFUNCTION( Category = "KeshUI|Interface", BlueprintCallable )
+	virtual UKUIInterfaceElement* GetElementUnderCursor() const;
+
+	/* Returns true while elements rendered this frame should record their hit test rects. */
+	virtual bool IsRecordingHitTest() const;
+
+	/* Returns the frame number of the hit test rects. */
+	virtual uint32 GetHitTestFrame() const;
+
+	/* Records the clipped screen rect of an element that takes mouse input.  Called as elements are rendered. */
+	virtual void AddHitTestEntry( UKUIInterfaceElement* oElement, const FVector2D& v2Min, const FVector2D& v2Max );
+
+	/* Returns the hit test grid built from the last frame. */
+	virtual const FKUIHitTestGrid& GetHitTestGrid() const;
+
+	/* Adds a container whose layout has been invalidated to the next layout pass. */
+	virtual void QueueLayout( UKUIInterfaceContainer* ctContainer );
+
+	/**
+	 * Lays out every queued container once.  Containers are measured deepest first, so sizes worked out
+	 * from children are known before the parents use them, then arranged shallowest first.
+	 */
+	virtual void UpdateLayout();
+
+	/* Returns the number of containers measured and arranged by the last layout pass. */
+	virtual void GetLayoutStats( int32& iMeasured, int32& iArranged ) const;
+
+	/* Holds back element notifications until the matching EndBatchUpdate.  Calls may be nested. */
+	UFUNCTION( Category = "KeshUI|Interface", BlueprintCallable )
+	virtual void BeginBatchUpdate();
+
+	/* Ends a batch update.  The last one to end sends each deferred notification once. */
+	UFUNCTION( Category = "KeshUI|Interface", BlueprintCallable )
+	virtual void EndBatchUpdate();
+
+	/* Returns true if notifications are being held back. */
+	UFUNCTION( Category = "KeshUI|Interface", BlueprintCallable )
+	virtual bool IsBatchUpdating() const;
+
+	/**
+	 * Holds back one of an element's notifications (EKUIBatchUpdate) until the batch update ends.  Returns
+	 * false if there is no batch update, in which case the caller should go ahead as normal.
+	 */
+	virtual bool DeferBatchUpdate( UKUIInterfaceElement* oElement, uint8 iUpdate );
+
+	/* Returns the pool the render caches lease their render targets from. */
+	UFUNCTION( Category = "KeshUI|Interface", BlueprintCallable )
+	virtual UKUIRenderTargetPool* GetRenderTargetPool() const;
+
+	/* Returns the cache text components remember measured string sizes in. */
+	virtual FKUITextMeasureCache& GetTextMeasureCache();
+
+	/* Returns the atlas text components can pre-rasterize their labels into. */
+	UFUNCTION( Category = "KeshUI|Interface", BlueprintCallable )
+	virtual UKUITextAtlas* GetTextAtlas() const;
+
+	/* Returns the backend elements draw through, or null to draw straight to the canvas. */
+	virtual FKUIRenderBackend* GetRenderBackend() const;
+
+	/* Sets the backend elements draw through.  Null draws straight to the canvas. */
+	virtual void SetRenderBackend( TSharedPtr<FKUIRenderBackend> stRenderBackend );
+
 #if KUI_INTERFACE_MOUSEOVER_DEBUG
 	TArray<bool> arDebugMouseOver;
 	bool bDebugMouseOver;
@@ -219,16 +306,36 @@ protected:
 	bool bVisible;
 	bool bCursorVisible;
 	FVector2D v2ScreenResolution;
+	FVector2D v2PendingResolution;
+	bool bPendingResolutionChange;
 	FVector2D v2CursorLocation;
 	FVector2D v2CursorVector;
 	TArray<FVector2D> arMouseButtonDownLocations;
 	TArray<TWeakObjectPtr<UObject>> arCancellables;
 	TWeakObjectPtr<UKUIInterfaceContainer> ctFocused;
 	bool bHardwareCursorPosition;
+	TArray<int32> arEventSubscribers;
+	FKUITextMeasureCache oTextMeasureCache;
+	uint32 iHitTestFrame;
+	FKUIHitTestGrid oHitTestGrid;
+	TArray<TWeakObjectPtr<UKUIInterfaceContainer>> arMouseOverTargets;
+	TArray<TWeakObjectPtr<UKUIInterfaceContainer>> arMouseCaptureTargets;
+	TSharedPtr<FKUIRenderBackend> stRenderBackend;
+	TArray<TWeakObjectPtr<UKUIInterfaceContainer>> arLayoutQueue;
+	int32 iLayoutMeasured;
+	int32 iLayoutArranged;
+	int32 iBatchUpdateDepth;
+	TMap<TWeakObjectPtr<UKUIInterfaceElement>, uint8> mpBatchUpdates;
 	
 	UPROPERTY()
 	TArray<UKUIRootContainer*> ctRootContainers;
 
+	UPROPERTY()
+	UKUIRenderTargetPool* oRenderTargetPool;
+
+	UPROPERTY()
+	UKUITextAtlas* oTextAtlas;
+
 #if KUI_INTERFACE_MOUSEOVER_DEBUG
 	UPROPERTY()
 	UKUIBoxInterfaceComponent* cmDebugMouseOverTestBox;
@@ -236,6 +343,21 @@ protected:
 	TWeakObjectPtr<UKUIInterfaceElement> cmDebugMouseOverLastTick;
 #endif // KUI_INTERFACE_MOUSEOVER_DEBUG
 
+	/* Sends the deferred notifications: align locations first, then container events, then render caches. */
+	virtual void FlushBatchUpdate();
+
+	/* Adds the containers that take mouse input and were rendered at the given location, topmost first. */
+	virtual void GetMouseTargetsAt( const FVector2D& v2Location, TArray<UKUIInterfaceContainer*>& arTargets ) const;
+
+	/* Sends a mouse button event to one container, with the location moved into the space of any sub containers it's in. */
+	virtual void SendMouseButtonEvent( UKUIInterfaceContainer* ctTarget, FKUIInterfaceContainerMouseButtonEvent& stEventInfo );
+
+	/* Records a new viewport size.  Changes are coalesced and applied once, at the end of the frame. */
+	virtual void UpdateScreenResolution( const FVector2D& v2ViewportSize );
+
+	/* Applies the last viewport size recorded this frame, if it changed. */
+	virtual void ApplyPendingScreenResolution();
+
 	/* Triggers when the screen resolution changes. */
 	virtual void OnScreenResolutionChange( const FVector2D& v2OldRes, const FVector2D& v2NewRes );
 
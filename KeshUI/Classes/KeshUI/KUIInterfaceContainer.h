@@ -49,6 +49,9 @@ namespace EKUIInterfaceContainerEventList
 #define KUI_CONTAINER_EVENT_FIRST EKUIInterfaceContainerEventList::E_Tick
 #define KUI_CONTAINER_EVENT_LAST EKUIInterfaceContainerEventList::E_ChildRemoved
 
+/* Number of interface-wide events that are only broadcast to subscribed containers. */
+#define KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT 9
+
 USTRUCT( BlueprintType )
 struct FKUIInterfaceContainerTickEvent : public FKUIInterfaceEvent
 {
@@ -279,6 +282,22 @@ public:
 	UFUNCTION(Category="KeshUI|Container", BlueprintCallable)
 	virtual void AddChild( UKUIInterfaceElement* oChild );
 
+	/* Adds several children to this container, sorting them once at the end. */
+	UFUNCTION(Category="KeshUI|Container", BlueprintCallable)
+	virtual void AddChildren( const TArray<UKUIInterfaceElement*>& arNewChildren );
+
+	/* Defers sorting of children until the matching EndBulkUpdate.  Calls may be nested. */
+	UFUNCTION(Category="KeshUI|Container", BlueprintCallable)
+	virtual void BeginBulkUpdate();
+
+	/* Ends a bulk update and sorts the children, if it was the outermost one. */
+	UFUNCTION(Category="KeshUI|Container", BlueprintCallable)
+	virtual void EndBulkUpdate();
+
+	/* Returns true if a bulk update is in progress. */
+	UFUNCTION(Category="KeshUI|Container", BlueprintCallable)
+	virtual bool IsBulkUpdating() const;
+
 	/* Removes a child from this container. */
 	UFUNCTION(Category="KeshUI|Container", BlueprintCallable)
 	virtual bool RemoveChild( UKUIInterfaceElement* oChild );
@@ -287,10 +306,14 @@ public:
 	UFUNCTION( Category = "KeshUI|Container", BlueprintCallable )
 	virtual UKUIInterfaceElement* GetChildAtIndex( int32 iIndex ) const;
 
+	/* Returns the number of children. */
+	UFUNCTION( Category = "KeshUI|Container", BlueprintCallable )
+	virtual int32 GetChildCount() const;
+
 	/* Returns an iterator for the child components. */
 	virtual TArray<UKUIInterfaceElement*>::TIterator GetChildIterator();
 
-	/* Re-order the components according to Z-Index. */
+	/* Re-order the components according to Z-Index.  Children with the same Z-Index keep their order. */
 	UFUNCTION(Category="KeshUI|Container", BlueprintCallable)
 	virtual void SortChildren();
 
@@ -341,10 +364,34 @@ public:
 	UFUNCTION( Category = "KeshUI|Container", BlueprintCallable )
 	virtual void InvalidateLayout();
 
-	/* Lays out the elements in this container. */
+	/* Positions the elements in this container.  Sizes have already been worked out by MeasureLayout. */
 	UFUNCTION( Category = "KeshUI|Container", BlueprintCallable )
 	virtual void DoLayout();
 
+	/**
+	 * Works out this container's own size from its children, before its parent is laid out.  Containers
+	 * that are sized from outside do nothing.  Called deepest first by the interface's layout pass.
+	 */
+	virtual void MeasureLayout();
+
+	/* Lays out the container if its layout is invalid. */
+	virtual void ValidateLayout();
+
+	/* Measures and lays out the container straight away if its layout is invalid.  For when it's needed outside the interface's layout pass. */
+	virtual void UpdateLayout();
+
+	/* Returns true if the container is waiting for the interface's layout pass. */
+	virtual bool IsLayoutQueued() const;
+
+	/* Marks whether the container is waiting for the interface's layout pass. */
+	virtual void SetLayoutQueued( bool bLayoutQueued );
+
+	/* Invalidates the cached screen location of this and all its children. */
+	virtual void InvalidateScreenLocation() override;
+
+	/* Called when a descendant's appearance changes.  Marks its area in the render cache it is drawn into for redrawing. */
+	virtual void InvalidateChildRenderCache( UKUIInterfaceElement* oChild );
+
 	/* Returns true if we respond to this event. */
 	virtual bool RespondsToEvent( uint8 iEventID ) const override;
 
@@ -354,6 +401,30 @@ public:
 	/* Broadcasts events to children. */
 	virtual void BroadcastEvent( FKUIInterfaceEvent& stEventInfo, bool bTopDown = false );
 
+	/* Returns the subscriber index slot for the event, or INDEX_NONE if it isn't a subscription event. */
+	static int32 GetSubscriptionEventIndex( uint8 iEventID );
+
+	/* Returns the event id for the given subscriber index slot. */
+	static uint8 GetSubscriptionEventID( int32 iIndex );
+
+	/* Returns true if the event is only broadcast to containers that have subscribed to it. */
+	static bool IsSubscriptionEvent( uint8 iEventID );
+
+	/* Subscribes this container to an interface-wide event (resolution change, match state, etc.) */
+	UFUNCTION( Category = "KeshUI|Container", BlueprintCallable )
+	virtual void SubscribeToEvent( uint8 iEventID );
+
+	/* Unsubscribes this container from an interface-wide event.  Lets containers opt out of events they don't handle. */
+	UFUNCTION( Category = "KeshUI|Container", BlueprintCallable )
+	virtual void UnsubscribeFromEvent( uint8 iEventID );
+
+	/* Returns true if this container has subscribed to the given event. */
+	UFUNCTION( Category = "KeshUI|Container", BlueprintCallable )
+	virtual bool IsSubscribedToEvent( uint8 iEventID ) const;
+
+	/* Returns the number of elements below this container that respond to the given subscription event. */
+	virtual int32 GetEventSubscribers( uint8 iEventID ) const;
+
 protected:
 
 	UPROPERTY() // Ensures reference counts.
@@ -361,14 +432,38 @@ protected:
 
 	FVector2D v2Size;
 	bool bValidLayout;
+	bool bLayoutQueued;
+	bool bSizeOnlyLayout;
 	int16 iTickRequests;
 	int16 iMouseInputRequests;
 	int16 iKeyInputRequests;
+	uint32 iEventSubscriptions;
+	TArray<int32> arEventSubscribers;
 	bool bFocused;
+	int32 iBulkUpdateDepth;
+	bool bSortPending;
+
+	/* Adds this container to the interface's next layout pass. */
+	virtual void QueueLayout();
+
+	/* Adds the rect to the interface's hit test grid if this container takes mouse input. */
+	virtual void UpdateHitTestRect( AKUIInterface* aHud, const FVector2D& v2ScreenLocation ) override;
+
+	/**
+	 * Records the hit test rects of the descendants that take mouse input when this container is drawn from its
+	 * render cache, since they aren't rendered to the screen themselves.  Subtrees without mouse input are skipped.
+	 */
+	virtual void UpdateCachedHitTestRects( AKUIInterface* aHud );
 
 	UPROPERTY()
 	TArray<UKUIInterfaceWidgetChildManager*> arChildManagers;
 
+	/* Returns the index after the last child with a Z-Index less than or equal to the given one. */
+	virtual int32 GetChildInsertIndex( uint16 iZIndex );
+
+	/* Returns the index of the given child, or INDEX_NONE. */
+	virtual int32 GetChildIndex( UKUIInterfaceElement* oChild ) const;
+
 	/* Returns true if this container can tick. */
 	virtual bool CanTick() const;
 
@@ -390,6 +485,21 @@ protected:
 	/* Removes one from the number of key input request.  And parents. */
 	virtual void RemoveKeyInputRequests( int16 iCount );
 
+	/* Adds to the number of subscribers to an event.  And parents. */
+	virtual void AddEventSubscribers( uint8 iEventID, int32 iCount );
+
+	/* Removes from the number of subscribers to an event.  And parents. */
+	virtual void RemoveEventSubscribers( uint8 iEventID, int32 iCount );
+
+	/* Subscribes containers whose native class is from another module to every subscription event. */
+	void SubscribeToNativeEvents();
+
+	/* Subscribes to the events that have a blueprint implementation in this class. */
+	void SubscribeToBlueprintEvents();
+
+	/* Sends the event to a single child, skipping children with no subscribers. */
+	void BroadcastEventToChild( UKUIInterfaceElement* oChild, FKUIInterfaceEvent& stEventInfo, bool bTopDown, bool bSubscriptionEvent );
+
 	/* Ticks the container. */
 	virtual void OnTick( const FKUIInterfaceContainerTickEvent& stEventInfo );
 
@@ -324,6 +324,9 @@ public:
 	UFUNCTION(Category="KeshUI|Element", BlueprintCallable)
 	virtual bool HasValidAlignLocation() const;
 
+	/* Returns true if this is aligned to its container in a way that moves or resizes it when the container is resized. */
+	virtual bool DependsOnContainerSize() const;
+
 	/* Invalidates the align location. */
 	virtual void InvalidateAlignLocation();
 
@@ -361,6 +364,12 @@ public:
 	UFUNCTION(Category="KeshUI|Element", BlueprintCallable)
 	virtual const FVector2D GetNestedLocation( UKUIInterfaceContainer* ctRoot ) const;
 
+	/* Returns true if the cached screen location is up to date. */
+	virtual bool HasValidScreenLocation() const;
+
+	/* Invalidates the cached screen location, so it is recalculated the next time it's used. */
+	virtual void InvalidateScreenLocation();
+
 	/* Called to render the element on the screen. */
 	UFUNCTION(Category="KeshUI|Element", BlueprintCallable)
 	virtual void Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject = NULL );
@@ -373,14 +382,23 @@ public:
 	UFUNCTION(Category="KeshUI|Element", BlueprintCallable)
 	virtual bool IsMouseOver() const;
 
+	/* Gets the screen rect, clipped by its containers, this element was rendered at in the last frame.  Returns false if it wasn't rendered. */
+	virtual bool GetHitTestRect( FVector2D& v2Min, FVector2D& v2Max ) const;
+
+	/* Gets the rect this element covered when last drawn into its container's render cache, relative to the cached content. */
+	virtual const FBox2D& GetLastRenderCacheRect() const;
+
 	/* Adds an object that should invalidate its location when this object moves. */
 	virtual void AddAlignedToThis( UKUIInterfaceElement* oAlignChild );
 
 	/* Removes an object that should invalidate its location when this object moves. */
 	virtual void RemoveAlignedToThis( UKUIInterfaceElement* oAlignChild );
 
-	/* Recursive alignment method. */
-	virtual void CalculateAlignLocation( TArray<UKUIInterfaceElement*>& arAlignStack );
+	/* Works out the align location, first working out the location of whatever this is aligned to. */
+	virtual void CalculateAlignLocation();
+
+	/* Returns false if aligning to the element would make this depend on its own location. */
+	virtual bool CanAlignTo( UKUIInterfaceElement* oAlignedTo ) const;
 
 	/* Works out the align location given some metrics. */
 	virtual const FVector2D CalculateAlignLocation( const FVector2D& v2Origin, const FVector2D& v2Extent, const FVector2D& v2Size, const FVector2D& v2Default = FVector2D::ZeroVector );
@@ -401,6 +419,9 @@ public:
 	UFUNCTION( Category = "KeshUI|Element", BlueprintCallable )
 	virtual bool IsRenderCaching() const;
 
+	/* Returns the render cache, if render caching is enabled. */
+	virtual UKUIRenderCache* GetRenderCache() const;
+
 	/* Returns true if we respond to this event. */
 	virtual bool RespondsToEvent( uint8 iEventID ) const;
 
@@ -428,11 +449,18 @@ protected:
 	TWeakObjectPtr<UKUIInterfaceContainer> ctContainer;
 	uint16 iZIndex;
 	bool bValidAlignLocation;
+	bool bCalculatingAlignLocation;
 	TWeakObjectPtr<UKUIInterfaceElement> oAlignedTo;
 	EKUIInterfaceHAlign::Type eHAlign;
 	EKUIInterfaceVAlign::Type eVAlign;
 	FVector2D v2AlignLocation;
 	FVector2D v2LastScreenRenderLocation;
+	mutable FVector2D v2ScreenLocation;
+	mutable bool bValidScreenLocation;
+	FVector2D v2HitTestMin;
+	FVector2D v2HitTestMax;
+	uint32 iHitTestFrame;
+	FBox2D stLastRenderCacheRect;
 	TArray<TWeakObjectPtr<UKUIInterfaceElement>> arAlignedToThis;
 	TWeakObjectPtr<AKUIInterface> aLastRenderedBy;
 	TArray<FString> arTags;
@@ -442,6 +470,15 @@ protected:
 
 	virtual void InvalidateRenderCache();
 
+	/* Returns the offset of this element from the nested location of its container. */
+	virtual const FVector2D GetNestedOffset() const;
+
+	/* Records the clipped screen rect of this element for cursor tests. */
+	virtual void UpdateHitTestRect( AKUIInterface* aHud, const FVector2D& v2ScreenLocation );
+
+	/* Returns the screen location of the top-left of the area this element shows. */
+	virtual const FVector2D GetHitTestLocation() const;
+
 	/* Called when this item is first added to a container which is part of an interface. */
 	virtual void OnInitialize( const FKUIInterfaceEvent& stEventInfo );
 
@@ -6,6 +6,8 @@
 #include "KeshUI/KUIMacros.h"
 #include "KUIRenderCache.generated.h"
 
+class UKUIRenderTargetPool;
+
 
 /**
 * Wrapper for the render to texture stuff.
@@ -31,15 +33,58 @@ public:
 	/* Invalidates the render cache, forcing an update. */
 	virtual void InvalidateRenderCache();
 
+	/* Gives the render target back to the pool. */
+	virtual void ReleaseRenderCache();
+
+	/* Marks an area of the cached element, relative to its content, for redrawing. */
+	virtual void InvalidateRenderCacheRect( const FVector2D& v2Min, const FVector2D& v2Max );
+
+	/* Marks the area the element covered when last drawn, and the area it covers now, for redrawing. */
+	virtual void InvalidateRenderCacheElement( UKUIInterfaceElement* oElement );
+
+	/* Returns true if the element, drawn at the given origin, overlaps the area being redrawn. */
+	virtual bool ShouldRedraw( UKUIInterfaceElement* oElement, const FVector2D& v2Origin ) const;
+
+	/* Returns the origin the cached content is currently being drawn at. */
+	virtual const FVector2D& GetRenderOrigin() const;
+
 	virtual void Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject = NULL ) override;
 
 protected:
 
 	bool bValidRenderCache;
+	FBox2D stDirtyRect;
+	FBox2D stRedrawRect;
+	FVector2D v2RenderOrigin;
+	TArray<TWeakObjectPtr<UKUIInterfaceElement>> arDirtyElements;
 
 	/* Destroys the current render cache. */
 	virtual void DestroyRenderCache();
 
+	/* Leases a transparent render target at least as large as the given size. */
+	virtual UTextureRenderTarget2D* CreateRenderTarget( const FVector2D& v2Size );
+
+	/* Gives a render target created by CreateRenderTarget back to the pool. */
+	virtual void ReleaseRenderTarget( UTextureRenderTarget2D* tRenderTarget );
+
+	/* Returns the size of the render target CreateRenderTarget would create. */
+	virtual FIntPoint GetRenderTargetSize( const FVector2D& v2Size ) const;
+
+	/* Returns the interface's render target pool, if there is one. */
+	virtual UKUIRenderTargetPool* GetRenderTargetPool() const;
+
+	/* Renders the element's contents into the render target, offset by the origin. */
+	virtual void RenderToTarget( UKUIInterfaceElement* oElement, UTextureRenderTarget2D* tRenderTarget, const FVector2D& v2Origin, const FName& nCanvasName );
+
 	virtual void InvalidateContainerRenderCache();
 
+	/* Invalidates the current area of each element marked since the last update. */
+	virtual void UpdateDirtyElements( UKUIInterfaceElement* oOwner );
+
+	/* Returns the area the element covers, relative to the owner's content. */
+	virtual FBox2D GetElementRect( UKUIInterfaceElement* oOwner, UKUIInterfaceElement* oElement ) const;
+
+	/* Returns the location of the owner's content within the cache. */
+	virtual FVector2D GetContentOrigin( UKUIInterfaceElement* oOwner ) const;
+
 };
@@ -0,0 +1,100 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#include "KeshUI/KUIMacros.h"
+#include "KUIRenderTargetPool.generated.h"
+
+#define KUI_RENDER_TARGET_POOL_GRANULARITY 64
+#define KUI_RENDER_TARGET_POOL_BUDGET ( 64 * 1024 * 1024 )
+#define KUI_RENDER_TARGET_POOL_BYTES_PER_PIXEL 4
+
+/* Usage statistics for a render target pool. */
+struct FKUIRenderTargetPoolStats
+{
+	int64 iBytesHeld;
+	int64 iBytesLeased;
+	int32 iTargetsLeased;
+	int32 iTargetsFree;
+	int32 iLeases;
+	int32 iHits;
+	int32 iEvictions;
+
+	/* Returns the fraction of leases that were served from the free list. */
+	float GetHitRate() const
+	{
+		if ( iLeases == 0 )
+			return 0.f;
+
+		return static_cast<float>( iHits ) / static_cast<float>( iLeases );
+	}
+};
+
+
+/**
+* Interface-wide pool of render targets for the render caches.  Sizes are rounded up to buckets so
+* that resizing elements can reuse targets.  Returned targets are kept until the memory budget is
+* exceeded, at which point the least recently returned are released.
+*/
+UCLASS( ClassGroup = "KeshUI", BlueprintType, NotPlaceable )
+class KESHUI_API UKUIRenderTargetPool : public UObject
+{
+	GENERATED_BODY()
+	KUI_CLASS_HEADER( UKUIRenderTargetPool )
+
+	UKUIRenderTargetPool( const class FObjectInitializer& oObjectInitializer );
+
+public:
+
+	/* Returns a transparent render target at least as large as the given size. */
+	virtual UTextureRenderTarget2D* LeaseRenderTarget( const FVector2D& v2Size );
+
+	/* Gives a leased render target back to the pool. */
+	virtual void ReturnRenderTarget( UTextureRenderTarget2D* tRenderTarget );
+
+	/* Returns the size of the render target that would be leased for the given size. */
+	virtual FIntPoint GetBucketSize( const FVector2D& v2Size ) const;
+
+	/* Gets the number of bytes of render targets the pool will hold on to. */
+	virtual int64 GetMemoryBudget() const;
+
+	/* Sets the number of bytes of render targets the pool will hold on to.  Leased targets are never released. */
+	virtual void SetMemoryBudget( int64 iMemoryBudget );
+
+	/* Releases all the free render targets. */
+	UFUNCTION( Category = "KeshUI|Render Target Pool", BlueprintCallable )
+	virtual void Flush();
+
+	/* Returns the usage statistics. */
+	virtual FKUIRenderTargetPoolStats GetStats() const;
+
+	/* Resets the lease, hit and eviction counters. */
+	UFUNCTION( Category = "KeshUI|Render Target Pool", BlueprintCallable )
+	virtual void ResetStats();
+
+protected:
+
+	int64 iMemoryBudget;
+	uint32 iReturnCounter;
+	TArray<uint32> arFreeReturned;
+	TArray<TWeakObjectPtr<UTextureRenderTarget2D>> arLeasedTargets;
+	int32 iLeases;
+	int32 iHits;
+	int32 iEvictions;
+
+	UPROPERTY()
+	TArray<UTextureRenderTarget2D*> arFreeTargets;
+
+	/* Creates a new render target of the given size. */
+	virtual UTextureRenderTarget2D* CreateRenderTarget( const FIntPoint& v2Size );
+
+	/* Releases the least recently returned free targets until the budget is met. */
+	virtual void TrimToBudget();
+
+	/* Removes leased targets that have been destroyed without being returned. */
+	virtual void PruneLeasedTargets();
+
+	/* Returns the memory used by a render target. */
+	static int64 GetRenderTargetBytes( const UTextureRenderTarget2D* tRenderTarget );
+
+};
@@ -0,0 +1,199 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#include "KeshUI/KUIMacros.h"
+#include "KUITextAtlas.generated.h"
+
+class AKUIInterface;
+class FCanvasTextItem;
+
+#define KUI_TEXT_ATLAS_PAGE_SIZE 1024
+#define KUI_TEXT_ATLAS_PADDING 1
+#define KUI_TEXT_ATLAS_BUDGET ( 16 * 1024 * 1024 )
+#define KUI_TEXT_ATLAS_BYTES_PER_PIXEL 4
+
+/* Everything that changes how a label is rasterized. */
+struct FKUITextAtlasKey
+{
+	FString strText;
+	UFont* foFont;
+	FVector2D v2Scale;
+	float fHorizontalSpacingAdjust;
+	FColor cColor;
+	bool bOutlined;
+	FColor cOutlineColor;
+	bool bShadow;
+	FVector2D v2ShadowOffset;
+	FColor cShadowColor;
+
+	bool operator==( const FKUITextAtlasKey& stOther ) const
+	{
+		return ( foFont == stOther.foFont &&
+				 v2Scale == stOther.v2Scale &&
+				 fHorizontalSpacingAdjust == stOther.fHorizontalSpacingAdjust &&
+				 cColor == stOther.cColor &&
+				 bOutlined == stOther.bOutlined &&
+				 ( !bOutlined || cOutlineColor == stOther.cOutlineColor ) &&
+				 bShadow == stOther.bShadow &&
+				 ( !bShadow || ( v2ShadowOffset == stOther.v2ShadowOffset && cShadowColor == stOther.cShadowColor ) ) &&
+				 strText.Equals( stOther.strText, ESearchCase::CaseSensitive ) );
+	}
+
+	friend uint32 GetTypeHash( const FKUITextAtlasKey& stKey )
+	{
+		uint32 iHash = FCrc::StrCrc32( *stKey.strText );
+		iHash = HashCombine( iHash, GetTypeHash( stKey.foFont ) );
+		iHash = HashCombine( iHash, GetTypeHash( stKey.v2Scale ) );
+		iHash = HashCombine( iHash, GetTypeHash( stKey.cColor ) );
+
+		return iHash;
+	}
+};
+
+
+/* A reference to a rasterized label.  Becomes invalid when the label is evicted. */
+struct FKUITextAtlasHandle
+{
+	int32 iSlot;
+	uint32 iSerial;
+
+	FKUITextAtlasHandle()
+	{
+		iSlot = INDEX_NONE;
+		iSerial = 0;
+	}
+};
+
+
+/* A row of labels of similar height on an atlas page. */
+struct FKUITextAtlasShelf
+{
+	int32 iY;
+	int32 iHeight;
+	int32 iNextX;
+};
+
+
+/* The packing state of an atlas page. */
+struct FKUITextAtlasPage
+{
+	TArray<FKUITextAtlasShelf> arShelves;
+	int32 iNextShelfY;
+	uint32 iLastUsed;
+};
+
+
+/* Where a label was rasterized. */
+struct FKUITextAtlasEntry
+{
+	FKUITextAtlasKey stKey;
+	int32 iPage;
+	FIntPoint v2Location;
+	FIntPoint v2Size;
+	uint32 iSerial;
+	bool bUsed;
+};
+
+
+/* Usage statistics for a text atlas. */
+struct FKUITextAtlasStats
+{
+	int64 iBytesHeld;
+	int32 iPages;
+	int32 iEntries;
+	int32 iHits;
+	int32 iMisses;
+	int32 iEvictions;
+
+	/* Returns the fraction of lookups that found an already rasterized label. */
+	float GetHitRate() const
+	{
+		if ( iHits + iMisses == 0 )
+			return 0.f;
+
+		return static_cast<float>( iHits ) / static_cast<float>( iHits + iMisses );
+	}
+};
+
+
+/**
+ * Interface-wide cache of pre-rasterized text.  Labels that opt in are drawn into shared render
+ * target pages once and then drawn as a single quad until their text or style changes.  Labels are
+ * packed into horizontal shelves.  When a label doesn't fit and the memory budget won't allow another
+ * page, the least recently used page is emptied and reused.
+ */
+UCLASS( ClassGroup = "KeshUI", BlueprintType, NotPlaceable )
+class KESHUI_API UKUITextAtlas : public UObject
+{
+	GENERATED_BODY()
+	KUI_CLASS_HEADER( UKUITextAtlas )
+
+	UKUITextAtlas( const class FObjectInitializer& oObjectInitializer );
+
+public:
+
+	/**
+	 * Returns the label for the key, rasterizing it from the text item if it isn't in the atlas.  The
+	 * returned handle is invalid if the label is too large or can't be drawn to a render target.
+	 */
+	virtual FKUITextAtlasHandle FindOrAddText( AKUIInterface* aHud, const FKUITextAtlasKey& stKey, FCanvasTextItem& stItem, const FVector2D& v2Size );
+
+	/* Returns true if the handle still refers to a rasterized label. */
+	virtual bool IsValidHandle( const FKUITextAtlasHandle& stHandle ) const;
+
+	/* Draws a rasterized label at the given location, tinted by the color. */
+	virtual void DrawLabel( AKUIInterface* aHud, UCanvas* oCanvas, const FKUITextAtlasHandle& stHandle, const FVector2D& v2Location, const FLinearColor& lcTint );
+
+	/* Gets the number of bytes of pages the atlas will hold on to. */
+	virtual int64 GetMemoryBudget() const;
+
+	/* Sets the number of bytes of pages the atlas will hold on to.  At least one page is always allowed. */
+	virtual void SetMemoryBudget( int64 iMemoryBudget );
+
+	/* Releases all the pages and labels. */
+	UFUNCTION( Category = "KeshUI|Text Atlas", BlueprintCallable )
+	virtual void Flush();
+
+	/* Returns the usage statistics. */
+	virtual FKUITextAtlasStats GetStats() const;
+
+	/* Resets the hit, miss and eviction counters. */
+	UFUNCTION( Category = "KeshUI|Text Atlas", BlueprintCallable )
+	virtual void ResetStats();
+
+protected:
+
+	int64 iMemoryBudget;
+	uint32 iUseCounter;
+	uint32 iSerialCounter;
+	TArray<FKUITextAtlasPage> arPageInfo;
+	TArray<FKUITextAtlasEntry> arEntries;
+	TArray<int32> arFreeEntries;
+	TMap<FKUITextAtlasKey, int32> mpEntries;
+	int32 iHits;
+	int32 iMisses;
+	int32 iEvictions;
+
+	UPROPERTY()
+	TArray<UTextureRenderTarget2D*> arPages;
+
+	/* Finds space for a label, creating or emptying pages as needed. */
+	virtual bool AllocateRect( const FIntPoint& v2Size, int32& iPage, FIntPoint& v2Location );
+
+	/* Tries to pack a label into a page's shelves. */
+	virtual bool AllocateRectInPage( int32 iPage, const FIntPoint& v2Size, FIntPoint& v2Location );
+
+	/* Creates a new, empty page. */
+	virtual UTextureRenderTarget2D* CreatePage();
+
+	/* Removes every label on a page so it can be packed again. */
+	virtual void EvictPage( int32 iPage );
+
+	/* Draws the text item into a page at the given location. */
+	virtual void RasterizeText( AKUIInterface* aHud, int32 iPage, const FIntPoint& v2Location, const FIntPoint& v2Size, FCanvasTextItem& stItem, const FLinearColor& lcColor );
+
+	/* Returns the memory used by one page. */
+	static int64 GetPageBytes();
+
+};
@@ -62,7 +62,10 @@ protected:
 	/* Called when the right button is clicked. */
 	virtual void OnRightButtonClick( UKUISimpleClickWidget* cmButton, const FVector2D& v2ClickOffset );
 
-	/* Makes sure size is correct, etc. */
+	/* Sizes the widget to fit its buttons and its largest value. */
+	virtual void MeasureLayout() override;
+
+	/* Positions the text and updates the buttons. */
 	virtual void DoLayout() override;
 
 	/* Calculates the largest text size. */
@@ -4,6 +4,7 @@
 
 #include "KeshUI/Widget/KUISimpleClickWidget.h"
 #include "KeshUI/KUIMacros.h"
+#include "KeshUI/KUITextGapBuffer.h"
 #include "KUITextFieldWidget.generated.h"
 
 class UKUITextInterfaceComponent;
@@ -99,7 +100,7 @@ public:
 	/* Overrides to true so space can click the button. */
 	virtual bool CanReceieveKeyEvents() const;
 
-	/* Sets the text change delegate. By default it is the internal OnInlineValueChange function. */
+	/* Sets the text change delegate.  Unbound by default, so edits don't build the whole string for it. */
 	virtual void SetInlineValueChangeDelegate( UObject* oObject, FKUIInterfaceWidgetInlineValueChangePrototype fnTextEditedCallback );
 
 	/* Sets the text change delegate. By default it is the internal OnValueChange function. */
@@ -125,7 +126,9 @@ protected:
 	UKUITextInterfaceComponent* cmTextComponent;
 	UKUITextureInterfaceComponent* cmCaret;
 	FVector2D v2CaretOffset;
-	FString strFullString;
+	FKUITextGapBuffer oTextBuffer;
+	mutable FString strFullString;
+	mutable bool bFullStringDirty;
 	FString strEditStart;
 	uint16 iRenderStringStart;
 	uint16 iRenderStringLength;
@@ -136,9 +139,16 @@ protected:
 	FKUIInterfaceWidgetValueChangeDelegate dgValueChanged;
 	uint8 iCharacterFilter;
 	uint16 iUndoCaretPosition;
-	FString strUndo;
+	uint16 iUndoIndex;
+	uint16 iUndoLength;
+	FString strUndoRemoved;
 	FString strLastAdd;
 	EKUITextFieldWidgetLastAction eLastAction;
+	TArray<float> arCharOffsets;
+	bool bValidCharOffsets;
+	UFont* foCharOffsetFont;
+	FVector2D v2CharOffsetScale;
+	float fCharOffsetSpacing;
 
 	/* Overrides to handle caret, text input, etc. */
 	virtual void OnFocus( const FKUIInterfaceEvent& stEventInfo ) override;
@@ -167,10 +177,37 @@ protected:
 	/* Removes a char at the given position. */
 	virtual void RemoveChars( uint16 iIndex, uint16 iCount = 1 );
 
+	/* Replaces iCount chars at the given position with a string, recording the edit for undo. */
+	virtual void ReplaceChars( uint16 iIndex, uint16 iCount, const FString& strString );
+
+	/* Returns true if anything handles the inline value change event. */
+	virtual bool IsInlineValueChangeObserved() const;
+
+	/* Returns the x offset of each character in the full string, rebuilding them if they're out of date. */
+	virtual const TArray<float>& GetCharOffsets();
+
+	/* Returns true if the character offsets match the string and the text component's settings. */
+	virtual bool AreCharOffsetsValid() const;
+
+	/* Updates the character offsets for a string inserted at the given index. */
+	virtual void InsertCharOffsets( uint16 iIndex, const FString& strString );
+
+	/* Updates the character offsets for characters removed at the given index. */
+	virtual void RemoveCharOffsets( uint16 iIndex, uint16 iCount );
+
+	/* Returns the rendered width of the full string from iStart up to iEnd. */
+	virtual float GetRangeWidth( uint16 iStart, uint16 iEnd );
+
+	/* Returns the furthest end index whose text from iStart fits in the given width. */
+	virtual uint16 GetFittingEnd( uint16 iStart, float fMaxWidth );
+
+	/* Returns the earliest start index whose text up to iEnd fits in the given width. */
+	virtual uint16 GetFittingStart( uint16 iEnd, float fMaxWidth );
+
 	/* Takes focus and sets caret position. */
 	virtual void OnTextBoxClick( UKUISimpleClickWidget* cmClicked, const FVector2D& v2ClickOffset );
 
-	/* Default method for the text edited delegate. */
+	/* Logs inline edits when bound as the text edited delegate. */
 	virtual void OnInlineValueChange( UKUIInterfaceWidget* cmWidget, const void* oOldValue, const void* oNewValue );
 
 	/* Default method for the text changed delegate. */
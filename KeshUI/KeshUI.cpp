@@ -4,3 +4,17 @@
 
 IMPLEMENT_MODULE( FDefaultModuleImpl, KeshUI );
 DEFINE_LOG_CATEGORY( LogKeshUI );
+
+DEFINE_STAT( STAT_KUITick );
+DEFINE_STAT( STAT_KUILayout );
+DEFINE_STAT( STAT_KUIBroadcastEvent );
+DEFINE_STAT( STAT_KUIMouseDispatch );
+DEFINE_STAT( STAT_KUIRender );
+DEFINE_STAT( STAT_KUIRenderCacheUpdate );
+DEFINE_STAT( STAT_KUIBatchUpdateFlush );
+DEFINE_STAT( STAT_KUIBatchUpdatesCoalesced );
+DEFINE_STAT( STAT_KUIMouseTargets );
+DEFINE_STAT( STAT_KUILayoutMeasured );
+DEFINE_STAT( STAT_KUILayoutArranged );
+DEFINE_STAT( STAT_KUIFlexSolves );
+DEFINE_STAT( STAT_KUITextItemSyncs );
@@ -3,6 +3,7 @@
 #include "KeshUI/KeshUI.h"
 #include "KeshUI/KUIInterfaceComponent.h"
 #include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/KUIRenderBackend.h"
 #include "KeshUI/Component/KUIBorderInterfaceComponent.h"
 
 
@@ -382,15 +383,11 @@ void UKUIBorderInterfaceComponent::Render( AKUIInterface* aHud, UCanvas* oCanvas
 		}
 	}
 
-	if ( arItems[ EBCBorderTexture::TI_Centre ].IsValid() )      oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_Centre ] );
-	if ( arItems[ EBCBorderTexture::TI_Left ].IsValid() )        oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_Left ] );
-	if ( arItems[ EBCBorderTexture::TI_Right ].IsValid() )       oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_Right ] );
-	if ( arItems[ EBCBorderTexture::TI_Top ].IsValid() )         oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_Top ] );
-	if ( arItems[ EBCBorderTexture::TI_Bottom ].IsValid() )      oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_Bottom ] );
-	if ( arItems[ EBCBorderTexture::TI_TopLeft ].IsValid() )     oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_TopLeft ] );
-	if ( arItems[ EBCBorderTexture::TI_TopRight ].IsValid() )    oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_TopRight ] );
-	if ( arItems[ EBCBorderTexture::TI_BottomLeft ].IsValid() )  oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_BottomLeft ] );
-	if ( arItems[ EBCBorderTexture::TI_BottomRight ].IsValid() ) oCanvas->DrawItem( *arItems[ EBCBorderTexture::TI_BottomRight ] );
+	FKUIRenderBackend& oBackend = FKUIRenderBackend::Get( aHud );
+
+	for ( uint8 i = EBCBorderTexture::TI_Centre; i < EBCBorderTexture::TI_Max; ++i )
+		if ( arItems[ i ].IsValid() )
+			oBackend.DrawItem( oCanvas, *arItems[ i ], arItems[ i ]->Size, arItems[ i ]->Texture );
 
 	for ( uint8 i = EBCBorderTexture::TI_Centre; i < EBCBorderTexture::TI_Max; ++i )
 		if ( arItems[ i ].IsValid() )
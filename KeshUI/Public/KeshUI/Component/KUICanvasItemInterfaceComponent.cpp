@@ -2,6 +2,7 @@
 
 #include "KeshUI/KeshUI.h"
 #include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/KUIRenderBackend.h"
 #include "KeshUI/Component/KUITextInterfaceComponent.h"
 #include "KeshUI/Component/KUICanvasItemInterfaceComponent.h"
 
@@ -134,6 +135,12 @@ void UKUICanvasItemInterfaceComponent::Render( AKUIInterface* aHud, UCanvas* oCa
 
 	const FVector2D v2RenderLocation = ( ( IsRenderCaching() || !IsPositionable() ) ? FVector2D::ZeroVector : v2Origin + GetRenderLocation() );
 
+	RenderItem( aHud, oCanvas, v2RenderLocation, GetSize(), oRenderCacheObject );
+}
+
+
+void UKUICanvasItemInterfaceComponent::RenderItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size, UKUIInterfaceElement* oRenderCacheObject )
+{
 	stItem->Position = v2RenderLocation;
 	stItem->Position.X = bRoundPosition ? FMath::RoundToInt( stItem->Position.X ) : stItem->Position.X;
 	stItem->Position.Y = bRoundPosition ? FMath::RoundToInt( stItem->Position.Y ) : stItem->Position.Y;
@@ -150,5 +157,11 @@ void UKUICanvasItemInterfaceComponent::Render( AKUIInterface* aHud, UCanvas* oCa
 	//if ( bDebug )
 		//UKUILogUO( "%f,%f" ), ExpandV2( stItem->Position ) );
 	
-	oCanvas->DrawItem( *stItem );
+	FKUIRenderBackend::Get( aHud ).DrawItem( oCanvas, *stItem, v2Size, GetItemTexture() );
+}
+
+
+const FTexture* UKUICanvasItemInterfaceComponent::GetItemTexture() const
+{
+	return NULL;
 }
@@ -2,6 +2,7 @@
 
 #include "KeshUI/KeshUI.h"
 #include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/KUIRenderBackend.h"
 #include "KeshUI/Component/KUIIconInterfaceComponent.h"
 
 
@@ -168,7 +169,7 @@ void UKUIIconInterfaceComponent::Render( AKUIInterface* aHud, UCanvas* oCanvas,
 	const FVector2D v2RenderLocation = ( IsRenderCaching() ? FVector2D::ZeroVector : GetRenderLocation() );
 
 	//oCanvas->SetClip( FMath::RoundToInt( v2Origin.X + v2RenderLocation.X ) + v2Size.X, FMath::RoundToInt( v2Origin.Y + v2RenderLocation.Y ) + v2Size.Y );
-	oCanvas->DrawIcon( stIcon, FMath::RoundToInt( v2Origin.X + v2RenderLocation.X ), FMath::RoundToInt( v2Origin.Y + v2RenderLocation.Y ), fScale );
+	FKUIRenderBackend::Get( aHud ).DrawIcon( oCanvas, stIcon, FMath::RoundToInt( v2Origin.X + v2RenderLocation.X ), FMath::RoundToInt( v2Origin.Y + v2RenderLocation.Y ), fScale );
 }
 
 
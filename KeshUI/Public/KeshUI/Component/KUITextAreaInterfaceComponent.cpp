@@ -0,0 +1,511 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/KUIGlyphMetricsCache.h"
+#include "KeshUI/Component/KUITextAreaInterfaceComponent.h"
+
+
+UKUITextAreaInterfaceComponent::UKUITextAreaInterfaceComponent( const class FObjectInitializer& oObjectInitializer )
+	: Super(oObjectInitializer)
+{
+	arParagraphs.SetNum( 0 );
+	iParagraphHead = 0;
+	iParagraphCount = 0;
+	iMaxParagraphs = KUI_TEXT_AREA_NO_MAX_PARAGRAPHS;
+	strIndentString = "";
+	fWrapWidth = 0.f;
+	fLineSpacing = 0.f;
+	fMaxLineWidth = 0.f;
+	fIndentWidth = 0.f;
+	bValidWrap = false;
+	foWrapFont = NULL;
+	fWrapScale = 1.f;
+}
+
+
+void UKUITextAreaInterfaceComponent::SetText( const FText& txText )
+{
+	const FString strText = txText.ToString();
+
+	arParagraphs.SetNum( 0 );
+	iParagraphHead = 0;
+	iParagraphCount = 0;
+	InvalidateWrap();
+
+	int32 iParagraphStart = 0;
+
+	for ( int32 i = 0; i <= strText.Len(); ++i )
+	{
+		if ( i < strText.Len() && strText[ i ] != '\n' )
+			continue;
+
+		int32 iParagraphEnd = i;
+
+		if ( iParagraphEnd > iParagraphStart && strText[ iParagraphEnd - 1 ] == '\r' )
+			--iParagraphEnd;
+
+		FKUITextAreaParagraph stParagraph;
+		stParagraph.strText = strText.Mid( iParagraphStart, iParagraphEnd - iParagraphStart );
+		stParagraph.iFirstLine = 0;
+		arParagraphs.Add( stParagraph );
+
+		iParagraphStart = i + 1;
+	}
+
+	iParagraphCount = arParagraphs.Num();
+
+	if ( iMaxParagraphs != KUI_TEXT_AREA_NO_MAX_PARAGRAPHS && iParagraphCount > iMaxParagraphs )
+	{
+		arParagraphs.RemoveAt( 0, iParagraphCount - iMaxParagraphs );
+		iParagraphCount = iMaxParagraphs;
+	}
+
+	OnLinesChanged();
+}
+
+
+void UKUITextAreaInterfaceComponent::AppendParagraph( const FString& strParagraph )
+{
+	// Bring the existing lines up to date first so that only the new paragraph needs wrapping.
+	UpdateWrap();
+
+	int32 iFirstLine = 0;
+
+	if ( iParagraphCount > 0 )
+	{
+		const FKUITextAreaParagraph& stLast = GetParagraphAt( iParagraphCount - 1 );
+		iFirstLine = stLast.iFirstLine + stLast.arLines.Num();
+	}
+
+	FKUITextAreaParagraph* stParagraph = NULL;
+
+	// Reuse the oldest paragraph's slot once the history is full.
+	if ( iMaxParagraphs != KUI_TEXT_AREA_NO_MAX_PARAGRAPHS && iParagraphCount >= iMaxParagraphs )
+	{
+		stParagraph = &arParagraphs[ iParagraphHead ];
+		iParagraphHead = ( iParagraphHead + 1 ) % arParagraphs.Num();
+	}
+
+	else
+	{
+		NormalizeParagraphs();
+
+		stParagraph = &arParagraphs[ arParagraphs.Add( FKUITextAreaParagraph() ) ];
+		++iParagraphCount;
+	}
+
+	stParagraph->strText = strParagraph;
+	WrapParagraph( *stParagraph, iFirstLine );
+
+	OnLinesChanged();
+}
+
+
+void UKUITextAreaInterfaceComponent::ClearParagraphs()
+{
+	if ( iParagraphCount == 0 )
+		return;
+
+	arParagraphs.SetNum( 0 );
+	iParagraphHead = 0;
+	iParagraphCount = 0;
+	fMaxLineWidth = 0.f;
+
+	OnLinesChanged();
+}
+
+
+int32 UKUITextAreaInterfaceComponent::GetParagraphCount() const
+{
+	return iParagraphCount;
+}
+
+
+const FString& UKUITextAreaInterfaceComponent::GetParagraph( int32 iIndex ) const
+{
+	if ( iIndex < 0 || iIndex >= iParagraphCount )
+	{
+		KUIErrorUO( "Invalid paragraph index: %d", iIndex );
+
+		static FString strEmpty;
+		return strEmpty;
+	}
+
+	return GetParagraphAt( iIndex ).strText;
+}
+
+
+int32 UKUITextAreaInterfaceComponent::GetMaxParagraphs() const
+{
+	return iMaxParagraphs;
+}
+
+
+void UKUITextAreaInterfaceComponent::SetMaxParagraphs( int32 iMaxParagraphs )
+{
+	iMaxParagraphs = max( KUI_TEXT_AREA_NO_MAX_PARAGRAPHS, iMaxParagraphs );
+
+	if ( this->iMaxParagraphs == iMaxParagraphs )
+		return;
+
+	this->iMaxParagraphs = iMaxParagraphs;
+
+	if ( iMaxParagraphs == KUI_TEXT_AREA_NO_MAX_PARAGRAPHS || iParagraphCount <= iMaxParagraphs )
+		return;
+
+	NormalizeParagraphs();
+
+	arParagraphs.RemoveAt( 0, iParagraphCount - iMaxParagraphs );
+	iParagraphCount = iMaxParagraphs;
+
+	OnLinesChanged();
+}
+
+
+float UKUITextAreaInterfaceComponent::GetWrapWidth() const
+{
+	return fWrapWidth;
+}
+
+
+void UKUITextAreaInterfaceComponent::SetWrapWidth( float fWrapWidth )
+{
+	fWrapWidth = max( 0.f, fWrapWidth );
+
+	if ( this->fWrapWidth == fWrapWidth )
+		return;
+
+	this->fWrapWidth = fWrapWidth;
+
+	InvalidateWrap();
+	OnLinesChanged();
+}
+
+
+const FString& UKUITextAreaInterfaceComponent::GetIndentString() const
+{
+	return strIndentString;
+}
+
+
+void UKUITextAreaInterfaceComponent::SetIndentString( const FString& strIndentString )
+{
+	if ( this->strIndentString.Equals( strIndentString ) )
+		return;
+
+	this->strIndentString = strIndentString;
+
+	InvalidateWrap();
+	OnLinesChanged();
+}
+
+
+float UKUITextAreaInterfaceComponent::GetLineSpacing() const
+{
+	return fLineSpacing;
+}
+
+
+void UKUITextAreaInterfaceComponent::SetLineSpacing( float fLineSpacing )
+{
+	if ( this->fLineSpacing == fLineSpacing )
+		return;
+
+	this->fLineSpacing = fLineSpacing;
+
+	OnLinesChanged();
+}
+
+
+float UKUITextAreaInterfaceComponent::GetLineHeight() const
+{
+	if ( foFont == NULL )
+		return 0.f;
+
+	return foFont->GetMaxCharHeight() * v2Scale.Y + fLineSpacing;
+}
+
+
+int32 UKUITextAreaInterfaceComponent::GetLineCount() const
+{
+	const_cast<UKUITextAreaInterfaceComponent*>( this )->UpdateWrap();
+
+	if ( iParagraphCount == 0 )
+		return 0;
+
+	const FKUITextAreaParagraph& stLast = GetParagraphAt( iParagraphCount - 1 );
+
+	return stLast.iFirstLine + stLast.arLines.Num() - GetParagraphAt( 0 ).iFirstLine;
+}
+
+
+FString UKUITextAreaInterfaceComponent::GetLine( int32 iLine ) const
+{
+	if ( iLine < 0 || iLine >= GetLineCount() )
+	{
+		KUIErrorUO( "Invalid line index: %d", iLine );
+		return "";
+	}
+
+	const int32 iAbsoluteLine = GetParagraphAt( 0 ).iFirstLine + iLine;
+	const FKUITextAreaParagraph& stParagraph = GetParagraphAt( GetParagraphForLine( iAbsoluteLine ) );
+	const FKUITextLineSpan& stLine = stParagraph.arLines[ iAbsoluteLine - stParagraph.iFirstLine ];
+
+	if ( stLine.bHyphenated )
+		return stParagraph.strText.Mid( stLine.iStart, stLine.iLength ) + "-";
+
+	return stParagraph.strText.Mid( stLine.iStart, stLine.iLength );
+}
+
+
+const FVector2D& UKUITextAreaInterfaceComponent::GetSize() const
+{
+	if ( !bValidSize )
+	{
+		UKUITextAreaInterfaceComponent* const cmThis = const_cast<UKUITextAreaInterfaceComponent*>( this );
+		cmThis->UpdateWrap();
+		cmThis->v2Size.X = ( fWrapWidth > 0.f ? fWrapWidth : fMaxLineWidth );
+		cmThis->v2Size.Y = GetLineCount() * GetLineHeight();
+		cmThis->bValidSize = true;
+	}
+
+	return v2Size;
+}
+
+
+bool UKUITextAreaInterfaceComponent::HasValidComponents() const
+{
+	if ( iParagraphCount == 0 )
+		return false;
+
+	if ( foFont == NULL )
+		return false;
+
+	return true;
+}
+
+
+FKUITextAreaParagraph& UKUITextAreaInterfaceComponent::GetParagraphAt( int32 iIndex )
+{
+	return arParagraphs[ ( iParagraphHead + iIndex ) % arParagraphs.Num() ];
+}
+
+
+const FKUITextAreaParagraph& UKUITextAreaInterfaceComponent::GetParagraphAt( int32 iIndex ) const
+{
+	return arParagraphs[ ( iParagraphHead + iIndex ) % arParagraphs.Num() ];
+}
+
+
+int32 UKUITextAreaInterfaceComponent::GetParagraphForLine( int32 iLine ) const
+{
+	// First lines only ever increase from the oldest paragraph, so they can be searched.
+	int32 iLow = 0;
+	int32 iHigh = iParagraphCount - 1;
+
+	while ( iLow < iHigh )
+	{
+		const int32 iMid = ( iLow + iHigh + 1 ) / 2;
+
+		if ( GetParagraphAt( iMid ).iFirstLine > iLine )
+			iHigh = iMid - 1;
+
+		else
+			iLow = iMid;
+	}
+
+	return iLow;
+}
+
+
+void UKUITextAreaInterfaceComponent::WrapParagraph( FKUITextAreaParagraph& stParagraph, int32 iFirstLine )
+{
+	stParagraph.iFirstLine = iFirstLine;
+
+	if ( !bValidWrap )
+		return;
+
+	WrapString( stParagraph.strText, foFont, ( fWrapWidth > 0.f ? fWrapWidth / v2Scale.X : MAX_FLT ), strIndentString, stParagraph.arLines );
+
+	// Blank paragraphs still take up a line.
+	if ( stParagraph.arLines.Num() == 0 )
+	{
+		FKUITextLineSpan stLine;
+		stLine.iStart = 0;
+		stLine.iLength = 0;
+		stLine.fWidth = 0.f;
+		stLine.bHyphenated = false;
+		stParagraph.arLines.Add( stLine );
+	}
+
+	for ( int32 i = 0; i < stParagraph.arLines.Num(); ++i )
+		fMaxLineWidth = max( fMaxLineWidth, ( stParagraph.arLines[ i ].fWidth + ( i > 0 ? fIndentWidth : 0.f ) ) * v2Scale.X );
+}
+
+
+void UKUITextAreaInterfaceComponent::UpdateWrap()
+{
+	if ( foWrapFont != foFont || fWrapScale != v2Scale.X )
+		bValidWrap = false;
+
+	if ( bValidWrap )
+		return;
+
+	foWrapFont = foFont;
+	fWrapScale = v2Scale.X;
+	fMaxLineWidth = 0.f;
+	fIndentWidth = 0.f;
+
+	// Without a font nothing can be measured; lines stay empty until one is set.
+	if ( foFont == NULL )
+	{
+		for ( int32 i = 0; i < arParagraphs.Num(); ++i )
+		{
+			arParagraphs[ i ].arLines.SetNum( 0 );
+			arParagraphs[ i ].iFirstLine = 0;
+		}
+
+		return;
+	}
+
+	FKUIGlyphMetrics* const oMetrics = FKUIGlyphMetricsCache::Get( foFont );
+
+	for ( int32 i = 0; i < strIndentString.Len(); ++i )
+		fIndentWidth += oMetrics->GetCharSize( strIndentString[ i ] ).X;
+
+	bValidWrap = true;
+
+	int32 iLine = 0;
+
+	for ( int32 i = 0; i < iParagraphCount; ++i )
+	{
+		FKUITextAreaParagraph& stParagraph = GetParagraphAt( i );
+		WrapParagraph( stParagraph, iLine );
+		iLine += stParagraph.arLines.Num();
+	}
+}
+
+
+void UKUITextAreaInterfaceComponent::InvalidateWrap()
+{
+	bValidWrap = false;
+}
+
+
+void UKUITextAreaInterfaceComponent::OnLinesChanged()
+{
+	bValidSize = false;
+
+	if ( GetContainer() != NULL )
+	{
+		FKUIInterfaceContainerElementEvent stEventInfo( EKUIInterfaceContainerEventList::E_ChildSizeChange, this );
+		GetContainer()->SendEvent( stEventInfo );
+	}
+
+	InvalidateRenderCache();
+	InvalidateAlignLocation();
+}
+
+
+void UKUITextAreaInterfaceComponent::NormalizeParagraphs()
+{
+	if ( iParagraphHead == 0 )
+		return;
+
+	TArray<FKUITextAreaParagraph> arOrdered;
+	arOrdered.Reserve( arParagraphs.Num() );
+
+	for ( int32 i = 0; i < iParagraphCount; ++i )
+		arOrdered.Add( GetParagraphAt( i ) );
+
+	arParagraphs = arOrdered;
+	iParagraphHead = 0;
+}
+
+
+void UKUITextAreaInterfaceComponent::GetVisibleLines( UCanvas* oCanvas, const FVector2D& v2RenderLocation, int32& iFirstLine, int32& iLastLine ) const
+{
+	iFirstLine = 0;
+	iLastLine = GetLineCount() - 1;
+
+	const float fLineHeight = GetLineHeight();
+
+	if ( fLineHeight <= 0.f || iLastLine < 0 )
+		return;
+
+	float fTop = -MAX_FLT;
+	float fBottom = MAX_FLT;
+
+	// Only clip to what we're drawn into.  Render caches draw tiles that aren't scrolled into view yet
+	// and keep them when scrolled, so the sub container's scroll window can't be used here.
+	if ( oCanvas != NULL )
+	{
+		fTop = -v2RenderLocation.Y;
+		fBottom = oCanvas->ClipY - v2RenderLocation.Y;
+	}
+
+	if ( fBottom < fTop )
+	{
+		iFirstLine = 0;
+		iLastLine = -1;
+		return;
+	}
+
+	iFirstLine = max( iFirstLine, FMath::FloorToInt( fTop / fLineHeight ) );
+	iLastLine = min( iLastLine, FMath::FloorToInt( fBottom / fLineHeight ) );
+}
+
+
+void UKUITextAreaInterfaceComponent::RenderItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size, UKUIInterfaceElement* oRenderCacheObject )
+{
+	UpdateWrap();
+
+	int32 iFirstLine = 0;
+	int32 iLastLine = -1;
+
+	GetVisibleLines( oCanvas, v2RenderLocation, iFirstLine, iLastLine );
+
+	if ( iFirstLine > iLastLine )
+		return;
+
+	FCanvasTextItem* const stTextItem = static_cast<FCanvasTextItem*>( &*stItem );
+	const float fLineHeight = GetLineHeight();
+	const int32 iAbsoluteLine = GetParagraphAt( 0 ).iFirstLine + iFirstLine;
+	int32 iParagraph = GetParagraphForLine( iAbsoluteLine );
+	int32 iParagraphLine = iAbsoluteLine - GetParagraphAt( iParagraph ).iFirstLine;
+
+	// Walk forward through the paragraphs rather than searching for every line.
+	for ( int32 iLine = iFirstLine; iLine <= iLastLine && iParagraph < iParagraphCount; ++iLine )
+	{
+		const FKUITextAreaParagraph& stParagraph = GetParagraphAt( iParagraph );
+		const FKUITextLineSpan& stLine = stParagraph.arLines[ iParagraphLine ];
+
+		if ( stLine.iLength > 0 )
+		{
+			if ( stLine.bHyphenated )
+				stTextItem->Text = FText::FromString( stParagraph.strText.Mid( stLine.iStart, stLine.iLength ) + "-" );
+
+			else
+				stTextItem->Text = FText::FromString( stParagraph.strText.Mid( stLine.iStart, stLine.iLength ) );
+
+			const FVector2D v2LineLocation(
+				v2RenderLocation.X + ( iParagraphLine > 0 ? fIndentWidth * v2Scale.X : 0.f ),
+				v2RenderLocation.Y + iLine * fLineHeight
+			);
+
+			// Each line is a different label, so look it up rather than reusing the last line's.
+			stAtlasHandle = FKUITextAtlasHandle();
+
+			Super::RenderItem( aHud, oCanvas, v2LineLocation, FVector2D( stLine.fWidth * v2Scale.X, fLineHeight ), oRenderCacheObject );
+		}
+
+		++iParagraphLine;
+
+		if ( iParagraphLine >= stParagraph.arLines.Num() )
+		{
+			++iParagraph;
+			iParagraphLine = 0;
+		}
+	}
+}
@@ -1,8 +1,11 @@
 // Copyright 2014-2015 Matt Chapman. All Rights Reserved.
 
 #include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIInterface.h"
 #include "KeshUI/KUIInterfaceContainer.h"
 #include "KeshUI/KUIRenderCache.h"
+#include "KeshUI/KUIGlyphMetricsCache.h"
+#include "KeshUI/KUIRenderBackend.h"
 #include "KeshUI/Component/KUITextInterfaceComponent.h"
 
 
@@ -19,7 +22,6 @@ UKUITextInterfaceComponent::UKUITextInterfaceComponent( const class FObjectIniti
 	bOutlined = false;
 	lcOutlineColor = FLinearColor::Black;
 	bShadow = false;
-	bUpdateShadowInfo = false;
 	v2ShadowOffset = FVector2D( 1.f, 1.f );
 	lcShadowColor = FLinearColor::Black;
 	bClipped = false;
@@ -27,6 +29,8 @@ UKUITextInterfaceComponent::UKUITextInterfaceComponent( const class FObjectIniti
 	bDontCorrectStereoscopic = true;
 	bValidSize = false;
 	v2Size = FVector2D::ZeroVector;
+	iItemSyncMask = EKUITextItemSync::S_None;
+	bUseTextAtlas = false;
 }
 
 
@@ -49,6 +53,7 @@ void UKUITextInterfaceComponent::SetText( const FText& txText )
 
 	this->txText = txText;
 	bValidSize = false;
+	InvalidateTextItem( EKUITextItemSync::S_Text );
 
 	if ( GetContainer() != NULL )
 	{
@@ -128,6 +133,7 @@ void UKUITextInterfaceComponent::SetCentredHorizontally( bool bCentred )
 		GetContainer()->SendEvent( stContainerEventInfo );
 	}
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -151,6 +157,7 @@ void UKUITextInterfaceComponent::SetCentredVertically( bool bCentred )
 		GetContainer()->SendEvent( stContainerEventInfo );
 	}
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -182,6 +189,7 @@ void UKUITextInterfaceComponent::SetScale( float fX, float fY )
 		GetContainer()->SendEvent( stEventInfo );
 	}
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -200,6 +208,7 @@ void UKUITextInterfaceComponent::SetDepth( float fDepth )
 	this->fDepth = fDepth;
 	bValidSize = false;
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -218,6 +227,7 @@ void UKUITextInterfaceComponent::SetOutlined( bool bOutlined )
 	this->bOutlined = bOutlined;
 	bValidSize = false;
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -235,6 +245,7 @@ void UKUITextInterfaceComponent::SetOutlineColor( const FLinearColor& lcColor )
 
 	lcOutlineColor = lcColor;
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -260,7 +271,7 @@ void UKUITextInterfaceComponent::SetShadowOffset( float fX, float fY )
 	v2ShadowOffset.Y = fY;
 	bValidSize = false;
 
-	bUpdateShadowInfo = true;
+	InvalidateTextItem( EKUITextItemSync::S_Shadow );
 	InvalidateRenderCache();
 }
 
@@ -279,7 +290,7 @@ void UKUITextInterfaceComponent::SetShadow( bool bShadow )
 	this->bShadow = bShadow;
 	bValidSize = false;
 
-	bUpdateShadowInfo = true;
+	InvalidateTextItem( EKUITextItemSync::S_Shadow );
 	InvalidateRenderCache();
 }
 
@@ -297,6 +308,7 @@ void UKUITextInterfaceComponent::SetShadowColor( const FLinearColor& lcColor )
 
 	lcShadowColor = lcColor;
 
+	InvalidateTextItem( EKUITextItemSync::S_Shadow );
 	InvalidateRenderCache();
 }
 
@@ -314,6 +326,7 @@ void UKUITextInterfaceComponent::SetClipped( bool bClipped )
 
 	this->bClipped = bClipped;
 
+	InvalidateTextItem( EKUITextItemSync::S_Clip );
 	InvalidateRenderCache();
 }
 
@@ -332,6 +345,7 @@ void UKUITextInterfaceComponent::SetHorizontalSpacingAdjustment( float fSpacing
 	fHorizontalSpacingAdjust = fSpacing;
 	bValidSize = false;
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -349,6 +363,7 @@ void UKUITextInterfaceComponent::SetCorrectStereoscopic( bool bCorrect )
 
 	bDontCorrectStereoscopic = !bCorrect;
 
+	InvalidateTextItem( EKUITextItemSync::S_Style );
 	InvalidateRenderCache();
 }
 
@@ -387,20 +402,102 @@ const FVector2D UKUITextInterfaceComponent::GetSizeString( const FString& strStr
 	if ( foFont == NULL )
 		return FVector2D::ZeroVector;
 
-	float fX, fY;
+	AKUIInterface* const aInterface = GetInterface();
+	FKUITextMeasureKey stKey;
 	FVector2D v2Size = FVector2D::ZeroVector;
 
-	for ( uint16 i = 0; i < strString.Len(); ++i )
+	if ( aInterface != NULL )
 	{
-		foFont->GetCharSize( strString[ i ], fX, fY );
-		v2Size.X += fX;
-		v2Size.Y = max( v2Size.Y, fY );
+		stKey.foFont = foFont;
+		stKey.v2Scale = v2Scale;
+		stKey.fHorizontalSpacingAdjust = fHorizontalSpacingAdjust;
+		stKey.bShadow = bShadow;
+		stKey.v2ShadowOffset = v2ShadowOffset;
+		stKey.bOutlined = bOutlined;
+
+		if ( aInterface->GetTextMeasureCache().Find( stKey, strString, v2Size ) )
+			return v2Size;
+	}
+
+	FKUIGlyphMetrics* const oMetrics = FKUIGlyphMetricsCache::Get( foFont );
+
+	for ( int32 i = 0; i < strString.Len(); ++i )
+	{
+		const FVector2D& v2CharSize = oMetrics->GetCharSize( strString[ i ] );
+		v2Size.X += v2CharSize.X;
+		v2Size.Y = max( v2Size.Y, v2CharSize.Y );
 	}
 
 	v2Size.X += ( ( strString.Len() > 0 ? strString.Len() - 1 : 0 ) * fHorizontalSpacingAdjust ) + max( ( bShadow ? v2ShadowOffset.X : 0.f ), ( bOutlined ? 2.f : 0.f ) );
 	v2Size.Y += max( ( bShadow ? v2ShadowOffset.Y : 0.f ), ( bOutlined ? 2.f : 0.f ) );
+	v2Size *= v2Scale;
 
-	return v2Size * v2Scale;
+	if ( aInterface != NULL )
+		aInterface->GetTextMeasureCache().Add( stKey, strString, v2Size );
+
+	return v2Size;
+}
+
+
+void UKUITextInterfaceComponent::GetCharacterOffsets( const FString& strString, TArray<float>& arOffsets ) const
+{
+	arOffsets.SetNumUninitialized( strString.Len() + 1 );
+	arOffsets[ 0 ] = 0.f;
+
+	if ( foFont == NULL )
+	{
+		for ( int32 i = 1; i < arOffsets.Num(); ++i )
+			arOffsets[ i ] = 0.f;
+
+		return;
+	}
+
+	FKUIGlyphMetrics* const oMetrics = FKUIGlyphMetricsCache::Get( foFont );
+	float fX = 0.f;
+
+	for ( int32 i = 0; i < strString.Len(); ++i )
+	{
+		fX += oMetrics->GetCharSize( strString[ i ] ).X + fHorizontalSpacingAdjust;
+		arOffsets[ i + 1 ] = fX * v2Scale.X;
+	}
+}
+
+
+float UKUITextInterfaceComponent::GetRangeWidth( const TArray<float>& arOffsets, int32 iStart, int32 iEnd ) const
+{
+	if ( foFont == NULL || arOffsets.Num() == 0 )
+		return 0.f;
+
+	iStart = clamp( iStart, 0, arOffsets.Num() - 1 );
+	iEnd = clamp( iEnd, iStart, arOffsets.Num() - 1 );
+
+	// Spacing only goes between characters, so the last one in the range doesn't get it.
+	float fWidth = arOffsets[ iEnd ] - arOffsets[ iStart ];
+
+	if ( iEnd > iStart )
+		fWidth -= fHorizontalSpacingAdjust * v2Scale.X;
+
+	fWidth += max( ( bShadow ? v2ShadowOffset.X : 0.f ), ( bOutlined ? 2.f : 0.f ) ) * v2Scale.X;
+
+	return fWidth;
+}
+
+
+bool UKUITextInterfaceComponent::IsUsingTextAtlas() const
+{
+	return bUseTextAtlas;
+}
+
+
+void UKUITextInterfaceComponent::SetUsingTextAtlas( bool bUseTextAtlas )
+{
+	if ( this->bUseTextAtlas == bUseTextAtlas )
+		return;
+
+	this->bUseTextAtlas = bUseTextAtlas;
+	stAtlasHandle = FKUITextAtlasHandle();
+
+	InvalidateRenderCache();
 }
 
 
@@ -436,8 +533,6 @@ void UKUITextInterfaceComponent::ConstructNewItem()
 	else
 		static_cast<FCanvasTextItem*>(&*stItem)->DisableShadow();
 
-	bUpdateShadowInfo = false;
-
 	static_cast<FCanvasTextItem*>(&*stItem)->bCentreX = bCentreX;
 	static_cast<FCanvasTextItem*>(&*stItem)->bCentreY = bCentreY;
 	static_cast<FCanvasTextItem*>(&*stItem)->bOutlined = bOutlined;
@@ -449,6 +544,10 @@ void UKUITextInterfaceComponent::ConstructNewItem()
 	static_cast<FCanvasTextItem*>(&*stItem)->FontRenderInfo.bClipText = bClipped;
 	static_cast<FCanvasTextItem*>(&*stItem)->Text = txText;
 
+	// A new item has everything, so there's nothing left to sync.
+	iItemSyncMask = EKUITextItemSync::S_None;
+	stAtlasHandle = FKUITextAtlasHandle();
+
 	if ( foFont != NULL && foFont->FontCacheType == EFontCacheType::Runtime &&
 		eBlendMode != ESimpleElementBlendMode::SE_BLEND_Translucent &&
 		eBlendMode != ESimpleElementBlendMode::SE_BLEND_TranslucentAlphaOnly )
@@ -464,102 +563,236 @@ void UKUITextInterfaceComponent::Render( AKUIInterface* aHud, UCanvas* oCanvas,
 		SetFont( *foFontPtr );
 
 	if ( stItem.IsValid() )
+		UpdateTextItem();
+
+	Super::Render( aHud, oCanvas, v2Origin, oRenderCacheObject );
+}
+
+
+void UKUITextInterfaceComponent::InvalidateTextItem( uint8 iSyncMask )
+{
+	iItemSyncMask |= iSyncMask;
+
+	// Anything that changes the item changes how it's rasterized.
+	stAtlasHandle = FKUITextAtlasHandle();
+}
+
+
+void UKUITextInterfaceComponent::UpdateTextItem()
+{
+	// Nothing has changed since the last sync, which is the usual case.
+	if ( iItemSyncMask == EKUITextItemSync::S_None )
+		return;
+
+	FCanvasTextItem* const stTextItem = static_cast<FCanvasTextItem*>( &*stItem );
+
+	if ( ( iItemSyncMask & EKUITextItemSync::S_Style ) != 0 )
 	{
-		if ( bUpdateShadowInfo )
-		{
-			if ( this->bShadow )
-				static_cast<FCanvasTextItem*>(&*stItem)->EnableShadow( lcShadowColor, v2ShadowOffset );
+		stTextItem->bCentreX = bCentreX;
+		stTextItem->bCentreY = bCentreY;
+		stTextItem->bOutlined = bOutlined;
+		stTextItem->OutlineColor = lcOutlineColor;
+		stTextItem->Scale = v2Scale;
+		stTextItem->Depth = fDepth;
+		stTextItem->HorizSpacingAdjust = fHorizontalSpacingAdjust;
+		stTextItem->bDontCorrectStereoscopic = bDontCorrectStereoscopic;
+	}
 
-			else
-				static_cast<FCanvasTextItem*>(&*stItem)->DisableShadow();
+	if ( ( iItemSyncMask & EKUITextItemSync::S_Shadow ) != 0 )
+	{
+		if ( this->bShadow )
+			stTextItem->EnableShadow( lcShadowColor, v2ShadowOffset );
 
-			bUpdateShadowInfo = false;
-		}
+		else
+			stTextItem->DisableShadow();
+	}
+
+	if ( ( iItemSyncMask & EKUITextItemSync::S_Clip ) != 0 )
+		stTextItem->FontRenderInfo.bClipText = bClipped;
+
+	if ( ( iItemSyncMask & EKUITextItemSync::S_Text ) != 0 )
+		stTextItem->Text = txText;
+
+	iItemSyncMask = EKUITextItemSync::S_None;
 
-		static_cast<FCanvasTextItem*>(&*stItem)->bCentreX = bCentreX;
-		static_cast<FCanvasTextItem*>(&*stItem)->bCentreY = bCentreY;
-		static_cast<FCanvasTextItem*>(&*stItem)->bOutlined = bOutlined;
-		static_cast<FCanvasTextItem*>(&*stItem)->OutlineColor = lcOutlineColor;
-		static_cast<FCanvasTextItem*>(&*stItem)->Scale = v2Scale;
-		static_cast<FCanvasTextItem*>(&*stItem)->Depth = fDepth;
-		static_cast<FCanvasTextItem*>(&*stItem)->HorizSpacingAdjust = fHorizontalSpacingAdjust;
-		static_cast<FCanvasTextItem*>(&*stItem)->bDontCorrectStereoscopic = bDontCorrectStereoscopic;
-		static_cast<FCanvasTextItem*>(&*stItem)->FontRenderInfo.bClipText = bClipped;
-		static_cast<FCanvasTextItem*>(&*stItem)->Text = txText;
+	INC_DWORD_STAT( STAT_KUITextItemSyncs );
+}
+
+
+bool UKUITextInterfaceComponent::RenderAtlasItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size )
+{
+	if ( aHud == NULL || aHud->GetTextAtlas() == NULL || bClipped )
+		return false;
+
+	UKUITextAtlas* const oAtlas = aHud->GetTextAtlas();
+	FCanvasTextItem* const stTextItem = static_cast<FCanvasTextItem*>( &*stItem );
+	const FColor cDrawColor = GetDrawColor();
+
+	if ( !oAtlas->IsValidHandle( stAtlasHandle ) )
+	{
+		// Alpha is applied when the label is drawn so fading text doesn't need rasterizing again.
+		FKUITextAtlasKey stKey;
+		stKey.strText = stTextItem->Text.ToString();
+		stKey.foFont = foFont;
+		stKey.v2Scale = v2Scale;
+		stKey.fHorizontalSpacingAdjust = fHorizontalSpacingAdjust;
+		stKey.cColor = FColor( cDrawColor.R, cDrawColor.G, cDrawColor.B, 255 );
+		stKey.bOutlined = bOutlined;
+		stKey.cOutlineColor = lcOutlineColor.ToFColor( false );
+		stKey.bShadow = bShadow;
+		stKey.v2ShadowOffset = v2ShadowOffset;
+		stKey.cShadowColor = lcShadowColor.ToFColor( false );
+
+		stAtlasHandle = oAtlas->FindOrAddText( aHud, stKey, *stTextItem, v2Size );
+
+		if ( !oAtlas->IsValidHandle( stAtlasHandle ) )
+			return false;
 	}
 
-	Super::Render( aHud, oCanvas, v2Origin, oRenderCacheObject );
+	FVector2D v2Location = v2RenderLocation;
+
+	if ( bCentreX )
+		v2Location.X -= v2Size.X * 0.5f;
+
+	if ( bCentreY )
+		v2Location.Y -= v2Size.Y * 0.5f;
+
+	if ( bRoundPosition )
+	{
+		v2Location.X = FMath::RoundToInt( v2Location.X );
+		v2Location.Y = FMath::RoundToInt( v2Location.Y );
+	}
+
+	oAtlas->DrawLabel( aHud, oCanvas, stAtlasHandle, v2Location, FLinearColor( 1.f, 1.f, 1.f, cDrawColor.A / 255.f ) );
+
+	return true;
+}
+
+
+void UKUITextInterfaceComponent::RenderItem( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2RenderLocation, const FVector2D& v2Size, UKUIInterfaceElement* oRenderCacheObject )
+{
+	if ( bUseTextAtlas && RenderAtlasItem( aHud, oCanvas, v2RenderLocation, v2Size ) )
+		return;
+
+	stItem->Position.X = bRoundPosition ? FMath::RoundToInt( v2RenderLocation.X ) : v2RenderLocation.X;
+	stItem->Position.Y = bRoundPosition ? FMath::RoundToInt( v2RenderLocation.Y ) : v2RenderLocation.Y;
+	stItem->BlendMode = eBlendMode;
+
+	FKUIRenderBackend::Get( aHud ).DrawTextItem( oCanvas, *static_cast<FCanvasTextItem*>( &*stItem ), v2Size );
 }
 
 
 TArray<FString> UKUITextInterfaceComponent::SplitString( const FString& strString, UFont* foFont, float fMaxWidth, const FString& strIndentString )
 {
-	uint16 iCharCount = 0;
+	TArray<FKUITextLineSpan> arLines;
+	WrapString( strString, foFont, fMaxWidth, strIndentString, arLines );
+
 	TArray<FString> arBrokenUpMessage;
-	const float fIndentWidth = ( strIndentString.Len() > 0 ? foFont->GetStringSize( *strIndentString ) : 0.f );
-	FString strIter = strString;
+	arBrokenUpMessage.Reserve( arLines.Num() );
 
-	while ( strIter.Len() > 0 )
+	for ( int32 i = 0; i < arLines.Num(); ++i )
 	{
-		++iCharCount;
+		if ( arLines[ i ].bHyphenated )
+			arBrokenUpMessage.Add( strString.Mid( arLines[ i ].iStart, arLines[ i ].iLength ) + "-" );
+
+		else
+			arBrokenUpMessage.Add( strString.Mid( arLines[ i ].iStart, arLines[ i ].iLength ) );
+	}
+
+	return arBrokenUpMessage;
+}
 
-		float fWidth = foFont->GetStringSize( *strIter.Mid( 0, iCharCount ) );
 
-		if ( arBrokenUpMessage.Num() > 0 )
-			fWidth += fIndentWidth;
+void UKUITextInterfaceComponent::WrapString( const FString& strString, UFont* foFont, float fMaxWidth, const FString& strIndentString, TArray<FKUITextLineSpan>& arLines )
+{
+	arLines.Reset();
+
+	if ( foFont == NULL || strString.Len() == 0 )
+		return;
+
+	FKUIGlyphMetrics* const oMetrics = FKUIGlyphMetricsCache::Get( foFont );
+	const int32 iLength = strString.Len();
 
-		if ( fWidth < fMaxWidth && iCharCount < strIter.Len() )
-			continue;
+	// Measure every character once up front; line widths are then differences of offsets.
+	TArray<float> arOffsets;
+	arOffsets.SetNumUninitialized( iLength + 1 );
+	arOffsets[ 0 ] = 0.f;
 
-		if ( fWidth > fMaxWidth )
+	for ( int32 i = 0; i < iLength; ++i )
+		arOffsets[ i + 1 ] = arOffsets[ i ] + oMetrics->GetCharSize( strString[ i ] ).X;
+
+	float fIndentWidth = 0.f;
+
+	for ( int32 i = 0; i < strIndentString.Len(); ++i )
+		fIndentWidth += oMetrics->GetCharSize( strIndentString[ i ] ).X;
+
+	const float fHyphenWidth = oMetrics->GetCharSize( '-' ).X;
+	int32 iLineStart = 0;
+
+	while ( iLineStart < iLength )
+	{
+		const float fLineMaxWidth = fMaxWidth - ( arLines.Num() > 0 ? fIndentWidth : 0.f );
+		int32 iCharCount = 0;
+		int32 iLastBreak = INDEX_NONE;
+
+		// Take characters until the line is full, remembering the last place it could be broken.
+		while ( iLineStart + iCharCount < iLength )
 		{
-			--iCharCount;
+			const int32 iChar = iLineStart + iCharCount;
+			const float fWidth = arOffsets[ iChar + 1 ] - arOffsets[ iLineStart ];
 
-			if ( iCharCount == 0 )
-			{
-				KUIErrorCW( GWorld, "Text area too small for single char" );
+			if ( fWidth > fLineMaxWidth )
 				break;
+
+			++iCharCount;
+
+			switch ( strString[ iChar ] )
+			{
+				case ' ':
+				case '.':
+				case ',':
+				case ':':
+				case ';':
+				case '-':
+					iLastBreak = iChar;
+					break;
 			}
+
+			if ( fWidth == fLineMaxWidth )
+				break;
 		}
 
-		if ( iCharCount == strIter.Len() )
+		if ( iCharCount == 0 )
 		{
-			arBrokenUpMessage.Add( strIter );
+			KUIErrorCW( GWorld, "Text area too small for single char" );
+			break;
+		}
+
+		FKUITextLineSpan stLine;
+		stLine.iStart = iLineStart;
+		stLine.bHyphenated = false;
+
+		if ( iLineStart + iCharCount == iLength )
+		{
+			stLine.iLength = iCharCount;
+			stLine.fWidth = arOffsets[ iLength ] - arOffsets[ iLineStart ];
+			arLines.Add( stLine );
 			break;
 		}
 
 		bool bFoundBreak = false;
 
 		// Don't backtrack really short lines...
-		if ( iCharCount > 2 )
+		if ( iCharCount > 2 && iLastBreak != INDEX_NONE )
 		{
-			uint16 iMaxBacktrack = clamp( iCharCount / 2, 1, 20 );
+			const int32 iBreakCount = iLastBreak - iLineStart + 1;
 
-			for ( uint16 i = 0; i < iMaxBacktrack; ++i )
+			if ( iCharCount - iBreakCount < clamp( iCharCount / 2, 1, 20 ) )
 			{
-				uint16 iCurrentCount = iCharCount - i;
-
-				switch ( strIter[ iCurrentCount - 1 ] )
-				{
-					case ' ': // Found a space... don't include it in the rendered string						
-						arBrokenUpMessage.Add( strIter.Left( iCurrentCount - 1 ) );
-						iCharCount = iCurrentCount;
-						bFoundBreak = true;
-						break;
-
-					case '.': // do they suck at spaces?
-					case ',': // "
-					case ':': // "
-					case ';': // "
-					case '-': // Found a hyphen, include it						
-						arBrokenUpMessage.Add( strIter.Left( iCurrentCount ) );
-						iCharCount = iCurrentCount;
-						bFoundBreak = true;
-						break;
-				}
-
-				if ( bFoundBreak )
-					break;
+				// Spaces aren't included in the rendered line, punctuation is.
+				stLine.iLength = ( strString[ iLastBreak ] == ' ' ? iBreakCount - 1 : iBreakCount );
+				iCharCount = iBreakCount;
+				bFoundBreak = true;
 			}
 		}
 
@@ -568,21 +801,17 @@ TArray<FString> UKUITextInterfaceComponent::SplitString( const FString& strStrin
 			if ( iCharCount > 1 )
 			{
 				--iCharCount;
-				arBrokenUpMessage.Add( strIter.Left( iCharCount ) + "-" );
+				stLine.bHyphenated = true;
 			}
 
-			else
-				arBrokenUpMessage.Add( strIter.Left( iCharCount ) );
+			stLine.iLength = iCharCount;
 		}
 
-		if ( strIter.Len() == iCharCount )
-			break;
+		stLine.fWidth = arOffsets[ iLineStart + stLine.iLength ] - arOffsets[ iLineStart ] + ( stLine.bHyphenated ? fHyphenWidth : 0.f );
+		arLines.Add( stLine );
 
-		strIter = strIter.Mid( iCharCount ); // Not the most efficient method, but screw it.
-		iCharCount = 0;
+		iLineStart += iCharCount;
 	}
-
-	return arBrokenUpMessage;
 }
 
 void UKUITextInterfaceComponent::SetSize( float fWidth, float fHeight )
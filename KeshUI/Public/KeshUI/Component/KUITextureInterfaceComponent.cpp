@@ -270,3 +270,12 @@ void UKUITextureInterfaceComponent::EnableRenderCache()
 {
 	// Stops the parent method from being called, stopping render caching - It's not needed for this type of component.
 }
+
+
+const FTexture* UKUITextureInterfaceComponent::GetItemTexture() const
+{
+	if ( tTexture == NULL )
+		return NULL;
+
+	return tTexture->Resource;
+}
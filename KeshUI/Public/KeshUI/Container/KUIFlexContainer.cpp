@@ -0,0 +1,531 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/Container/KUIFlexContainer.h"
+
+
+/* Swaps a vector between screen space and (main axis, cross axis).  Columns have Y as their main axis. */
+static FVector2D KUIFlexSwapAxes( const FVector2D& v2Vector, bool bRow )
+{
+	return ( bRow ? v2Vector : FVector2D( v2Vector.Y, v2Vector.X ) );
+}
+
+
+UKUIFlexContainer::UKUIFlexContainer( const class FObjectInitializer& oObjectInitializer )
+	: Super(oObjectInitializer)
+{
+	arItems.SetNum( 0 );
+	eDirection = EKUIFlexDirection::FD_Row;
+	eJustify = EKUIFlexJustify::FJ_Start;
+	eItemAlign = EKUIFlexAlign::FA_Start;
+	bWrap = false;
+	fGap = 0.f;
+	bValidSolution = false;
+	v2SolvedSize = FVector2D::ZeroVector;
+}
+
+
+void UKUIFlexContainer::AddFlexItem( UKUIInterfaceElement* oChild, float fGrow, float fShrink )
+{
+	if ( oChild == NULL )
+	{
+		KUIErrorUO( "Trying to add a null flex item" );
+		return;
+	}
+
+	int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		AddChild( oChild );
+
+		iIndex = arItems.AddDefaulted();
+		arItems[ iIndex ].oElement = oChild;
+		arItems[ iIndex ].fBasis = -1.f;
+		arItems[ iIndex ].v2Measured = oChild->GetSize();
+		arItems[ iIndex ].v2Assigned = oChild->GetSize();
+		arItems[ iIndex ].v2Location = FVector2D::ZeroVector;
+		arItems[ iIndex ].bVisible = oChild->IsVisible();
+
+		oChild->InvalidateAlignLocation();
+	}
+
+	arItems[ iIndex ].fGrow = max( 0.f, fGrow );
+	arItems[ iIndex ].fShrink = max( 0.f, fShrink );
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+void UKUIFlexContainer::RemoveFlexItem( UKUIInterfaceElement* oChild )
+{
+	if ( oChild == NULL )
+	{
+		KUIErrorDebugUO( "Trying to remove null child" );
+		return;
+	}
+
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		KUIErrorDebugUO( "Child not found" );
+		return;
+	}
+
+	arItems.RemoveAt( iIndex );
+	oChild->InvalidateAlignLocation();
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+bool UKUIFlexContainer::RemoveChild( UKUIInterfaceElement* oChild )
+{
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex != INDEX_NONE )
+	{
+		arItems.RemoveAt( iIndex );
+
+		bValidSolution = false;
+		InvalidateLayout();
+	}
+
+	return Super::RemoveChild( oChild );
+}
+
+
+bool UKUIFlexContainer::IsChildsLayoutManaged( UKUIInterfaceElement* oChild ) const
+{
+	if ( oChild == NULL )
+		return false;
+
+	return ( GetFlexItemIndex( oChild ) != INDEX_NONE );
+}
+
+
+int32 UKUIFlexContainer::GetFlexItemCount() const
+{
+	return arItems.Num();
+}
+
+
+float UKUIFlexContainer::GetFlexGrow( UKUIInterfaceElement* oChild ) const
+{
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+		return 0.f;
+
+	return arItems[ iIndex ].fGrow;
+}
+
+
+void UKUIFlexContainer::SetFlexGrow( UKUIInterfaceElement* oChild, float fGrow )
+{
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		KUIErrorUO( "Element is not a flex item" );
+		return;
+	}
+
+	fGrow = max( 0.f, fGrow );
+
+	if ( arItems[ iIndex ].fGrow == fGrow )
+		return;
+
+	arItems[ iIndex ].fGrow = fGrow;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+float UKUIFlexContainer::GetFlexShrink( UKUIInterfaceElement* oChild ) const
+{
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+		return 0.f;
+
+	return arItems[ iIndex ].fShrink;
+}
+
+
+void UKUIFlexContainer::SetFlexShrink( UKUIInterfaceElement* oChild, float fShrink )
+{
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		KUIErrorUO( "Element is not a flex item" );
+		return;
+	}
+
+	fShrink = max( 0.f, fShrink );
+
+	if ( arItems[ iIndex ].fShrink == fShrink )
+		return;
+
+	arItems[ iIndex ].fShrink = fShrink;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+float UKUIFlexContainer::GetFlexBasis( UKUIInterfaceElement* oChild ) const
+{
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+		return -1.f;
+
+	return arItems[ iIndex ].fBasis;
+}
+
+
+void UKUIFlexContainer::SetFlexBasis( UKUIInterfaceElement* oChild, float fBasis )
+{
+	const int32 iIndex = GetFlexItemIndex( oChild );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		KUIErrorUO( "Element is not a flex item" );
+		return;
+	}
+
+	if ( fBasis < 0.f )
+		fBasis = -1.f;
+
+	if ( arItems[ iIndex ].fBasis == fBasis )
+		return;
+
+	arItems[ iIndex ].fBasis = fBasis;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+TEnumAsByte<EKUIFlexDirection::Type> UKUIFlexContainer::GetDirection() const
+{
+	return eDirection;
+}
+
+
+void UKUIFlexContainer::SetDirection( TEnumAsByte<EKUIFlexDirection::Type> eDirection )
+{
+	if ( this->eDirection == eDirection )
+		return;
+
+	this->eDirection = eDirection;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+bool UKUIFlexContainer::IsWrapping() const
+{
+	return bWrap;
+}
+
+
+void UKUIFlexContainer::SetWrapping( bool bWrap )
+{
+	if ( this->bWrap == bWrap )
+		return;
+
+	this->bWrap = bWrap;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+float UKUIFlexContainer::GetGap() const
+{
+	return fGap;
+}
+
+
+void UKUIFlexContainer::SetGap( float fGap )
+{
+	fGap = max( 0.f, fGap );
+
+	if ( this->fGap == fGap )
+		return;
+
+	this->fGap = fGap;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+TEnumAsByte<EKUIFlexJustify::Type> UKUIFlexContainer::GetJustify() const
+{
+	return eJustify;
+}
+
+
+void UKUIFlexContainer::SetJustify( TEnumAsByte<EKUIFlexJustify::Type> eJustify )
+{
+	if ( this->eJustify == eJustify )
+		return;
+
+	this->eJustify = eJustify;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+TEnumAsByte<EKUIFlexAlign::Type> UKUIFlexContainer::GetItemAlign() const
+{
+	return eItemAlign;
+}
+
+
+void UKUIFlexContainer::SetItemAlign( TEnumAsByte<EKUIFlexAlign::Type> eAlign )
+{
+	if ( this->eItemAlign == eAlign )
+		return;
+
+	this->eItemAlign = eAlign;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+void UKUIFlexContainer::SetSize( float fWidth, float fHeight )
+{
+	if ( v2Size.X == fWidth && v2Size.Y == fHeight )
+		return;
+
+	Super::SetSize( fWidth, fHeight );
+
+	InvalidateLayout();
+}
+
+
+int32 UKUIFlexContainer::GetFlexItemIndex( UKUIInterfaceElement* oChild ) const
+{
+	if ( oChild == NULL )
+		return INDEX_NONE;
+
+	for ( int32 i = 0; i < arItems.Num(); ++i )
+		if ( arItems[ i ].oElement.Get() == oChild )
+			return i;
+
+	return INDEX_NONE;
+}
+
+
+void UKUIFlexContainer::OnChildSizeChange( const FKUIInterfaceContainerElementEvent& stEventInfo )
+{
+	Super::OnChildSizeChange( stEventInfo );
+
+	const int32 iIndex = GetFlexItemIndex( stEventInfo.oElement );
+
+	if ( iIndex == INDEX_NONE )
+		return;
+
+	const FVector2D& v2Size = stEventInfo.oElement->GetSize();
+
+	// Either we resized it or it couldn't be resized.
+	if ( v2Size == arItems[ iIndex ].v2Assigned || v2Size == arItems[ iIndex ].v2Measured )
+		return;
+
+	arItems[ iIndex ].v2Measured = v2Size;
+
+	bValidSolution = false;
+	InvalidateLayout();
+}
+
+
+bool UKUIFlexContainer::IsSolutionStale() const
+{
+	if ( v2SolvedSize != GetSize() )
+		return true;
+
+	for ( int32 i = 0; i < arItems.Num(); ++i )
+		if ( arItems[ i ].oElement.IsValid() && arItems[ i ].oElement->IsVisible() != arItems[ i ].bVisible )
+			return true;
+
+	return false;
+}
+
+
+void UKUIFlexContainer::SolveLayout()
+{
+	INC_DWORD_STAT( STAT_KUIFlexSolves );
+
+	const bool bRow = ( eDirection != EKUIFlexDirection::FD_Column );
+	const FVector2D v2Container = KUIFlexSwapAxes( GetSize(), bRow );
+
+	v2SolvedSize = GetSize();
+
+	for ( int32 i = 0; i < arItems.Num(); ++i )
+		arItems[ i ].bVisible = ( arItems[ i ].oElement.IsValid() && arItems[ i ].oElement->IsVisible() );
+
+	TArray<int32> arLine;
+	TArray<FVector2D> arBasis;
+	float fCrossOffset = 0.f;
+	int32 iNext = 0;
+
+	while ( iNext < arItems.Num() )
+	{
+		float fLineMain = 0.f;
+		float fLineCross = 0.f;
+
+		arLine.Reset();
+		arBasis.Reset();
+
+		// Fill the line.  Hidden items take no space.
+		for ( ; iNext < arItems.Num(); ++iNext )
+		{
+			const FKUIFlexItem& stItem = arItems[ iNext ];
+
+			if ( !stItem.bVisible )
+				continue;
+
+			FVector2D v2Basis = KUIFlexSwapAxes( stItem.v2Measured, bRow );
+
+			if ( stItem.fBasis >= 0.f )
+				v2Basis.X = stItem.fBasis;
+
+			const float fItemMain = v2Basis.X + ( arLine.Num() > 0 ? fGap : 0.f );
+
+			// Every line gets at least one item, even if it doesn't fit.
+			if ( bWrap && arLine.Num() > 0 && fLineMain + fItemMain > v2Container.X )
+				break;
+
+			fLineMain += fItemMain;
+			fLineCross = max( fLineCross, v2Basis.Y );
+
+			arLine.Add( iNext );
+			arBasis.Add( v2Basis );
+		}
+
+		if ( arLine.Num() == 0 )
+			break;
+
+		// A single line fills the container across.
+		if ( !bWrap )
+			fLineCross = v2Container.Y;
+
+		float fFree = v2Container.X - fLineMain;
+		float fTotalGrow = 0.f;
+		float fTotalShrink = 0.f;
+
+		for ( int32 i = 0; i < arLine.Num(); ++i )
+		{
+			fTotalGrow += arItems[ arLine[ i ] ].fGrow;
+			fTotalShrink += arItems[ arLine[ i ] ].fShrink * arBasis[ i ].X;
+		}
+
+		// Only space nothing grows into is left to spread out.
+		const float fSpare = ( fFree > 0.f && fTotalGrow <= 0.f ? fFree : 0.f );
+		float fMainOffset = 0.f;
+		float fBetween = fGap;
+
+		switch ( eJustify )
+		{
+			case EKUIFlexJustify::FJ_Centre:
+				fMainOffset = fSpare / 2.f;
+				break;
+
+			case EKUIFlexJustify::FJ_End:
+				fMainOffset = fSpare;
+				break;
+
+			case EKUIFlexJustify::FJ_SpaceBetween:
+				if ( arLine.Num() > 1 )
+					fBetween += fSpare / static_cast<float>( arLine.Num() - 1 );
+
+				break;
+
+			case EKUIFlexJustify::FJ_SpaceAround:
+				fBetween += fSpare / static_cast<float>( arLine.Num() );
+				fMainOffset = fSpare / static_cast<float>( arLine.Num() ) / 2.f;
+				break;
+
+			default:
+				break;
+		}
+
+		for ( int32 i = 0; i < arLine.Num(); ++i )
+		{
+			FKUIFlexItem& stItem = arItems[ arLine[ i ] ];
+			FVector2D v2ItemSize = arBasis[ i ];
+
+			// Grow by share of the grow factors, shrink by share of the shrink factors scaled by size.
+			if ( fFree > 0.f && fTotalGrow > 0.f )
+				v2ItemSize.X += fFree * stItem.fGrow / fTotalGrow;
+
+			else if ( fFree < 0.f && fTotalShrink > 0.f )
+				v2ItemSize.X = max( 0.f, v2ItemSize.X + fFree * stItem.fShrink * arBasis[ i ].X / fTotalShrink );
+
+			float fLineOffset = 0.f;
+
+			switch ( eItemAlign )
+			{
+				case EKUIFlexAlign::FA_Centre:
+					fLineOffset = ( fLineCross - v2ItemSize.Y ) / 2.f;
+					break;
+
+				case EKUIFlexAlign::FA_End:
+					fLineOffset = fLineCross - v2ItemSize.Y;
+					break;
+
+				case EKUIFlexAlign::FA_Stretch:
+					v2ItemSize.Y = fLineCross;
+					break;
+
+				default:
+					break;
+			}
+
+			stItem.v2Location = KUIFlexSwapAxes( FVector2D( floor( fMainOffset ), floor( fCrossOffset + fLineOffset ) ), bRow );
+			stItem.v2Assigned = KUIFlexSwapAxes( FVector2D( floor( v2ItemSize.X ), floor( v2ItemSize.Y ) ), bRow );
+
+			fMainOffset += v2ItemSize.X + fBetween;
+		}
+
+		fCrossOffset += fLineCross + fGap;
+	}
+
+	bValidSolution = true;
+}
+
+
+void UKUIFlexContainer::DoLayout()
+{
+	if ( !bValidSolution || IsSolutionStale() )
+		SolveLayout();
+
+	for ( int32 i = 0; i < arItems.Num(); ++i )
+	{
+		if ( !arItems[ i ].bVisible || !arItems[ i ].oElement.IsValid() )
+			continue;
+
+		UKUIInterfaceElement* const oElement = arItems[ i ].oElement.Get();
+
+		if ( oElement->GetSize() != arItems[ i ].v2Assigned )
+			oElement->SetSize( arItems[ i ].v2Assigned.X, arItems[ i ].v2Assigned.Y );
+
+		oElement->SetAlignedTo( NULL );
+		oElement->SetAlignLocation( arItems[ i ].v2Location );
+	}
+
+	Super::DoLayout();
+}
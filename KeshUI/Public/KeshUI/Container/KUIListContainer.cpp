@@ -17,6 +17,9 @@ UKUIListContainer::UKUIListContainer( const class FObjectInitializer& oObjectIni
 	fMaxHeight = 0.f;
 	fSpacing = 0.f;
 	iRowCount = 0;
+	oRowOffsets.Reset();
+	bValidRowOffsets = false;
+	iFirstDirtyRow = INDEX_NONE;
 	bEnableSelect = false;
 	bEnableMultiSelect = false;
 	ctLastSelected = NULL;
@@ -81,7 +84,10 @@ void UKUIListContainer::SetRow( uint16 iRow, UKUIListRowContainer* ctRow )
 	arRows[ iRow ] = NULL;
 
 	if ( ctCurrent != NULL )
+	{
+		ctCurrent->SetListIndex( KUI_LIST_INDEX_NONE );
 		RemoveChild( ctCurrent );
+	}
 
 	if ( ctRow != NULL )
 	{
@@ -91,6 +97,7 @@ void UKUIListContainer::SetRow( uint16 iRow, UKUIListRowContainer* ctRow )
 		if ( ctRow->GetContainer() == this )
 		{
 			arRows[ iRow ] = ctRow;
+			arRows[ iRow ]->SetListIndex( iRow );
 			arRows[ iRow ]->InvalidateAlignLocation();
 		}
 	}
@@ -215,6 +222,12 @@ void UKUIListContainer::RemoveRows( uint16 iStart, uint16 iCount )
 		UKUIListRowContainer* ctTemp = arRows[ iStart + i ].Get();
 		arRows[ iStart + i ] = arRows[ iStart + iCount + i ];
 		arRows[ iStart + iCount + i ] = ctTemp;
+
+		if ( arRows[ iStart + i ].IsValid() )
+			arRows[ iStart + i ]->SetListIndex( iStart + i );
+
+		if ( ctTemp != NULL )
+			ctTemp->SetListIndex( iStart + iCount + i );
 	}
 
 	SetRowCount( iRowCount - iCount );	
@@ -291,60 +304,172 @@ void UKUIListContainer::SetSize( float fWidth, float fHeight )
 }
 
 
-void UKUIListContainer::DoLayout()
+void UKUIListContainer::InvalidateLayout()
 {
-	if ( iRowCount >= 0 )
-	{
-		FVector2D v2SlotLocation = FVector2D::ZeroVector;
+	bValidRowOffsets = false;
+
+	Super::InvalidateLayout();
+}
 
+
+void UKUIListContainer::MeasureLayout()
+{
+	// Something other than a row size changed, so start from scratch.
+	if ( !bValidRowOffsets )
+	{
 		for ( uint16 iRow = 0; iRow < iRowCount; ++iRow )
 		{
-			float fRowHeight = 0.f;
+			if ( !arRows[ iRow ].IsValid() )
+				continue;
 
-			TArray<UKUIInterfaceElement*> arAlignStack;
+			if ( !arRows[ iRow ]->IsVisible() )
+				continue;
 
-			if ( arRows[ iRow ].IsValid() )
-			{
-				if ( !arRows[ iRow ]->IsVisible() )
-					continue;
+			arRows[ iRow ]->InvalidateAlignLocation();
+			arRows[ iRow ]->CalculateAlignLocation();
+		}
 
-				arRows[ iRow ]->InvalidateAlignLocation();
-				arRows[ iRow ]->CalculateAlignLocation( arAlignStack );
-				fRowHeight += arRows[ iRow ]->GetSize().Y;
-			}
+		RebuildRowOffsets();
+		iFirstDirtyRow = 0;
+	}
 
-			if ( fMinHeight > 0.f && fRowHeight < fMinHeight )
-				fRowHeight = fMinHeight;
+	if ( iFirstDirtyRow != INDEX_NONE )
+		SetSize( GetSize().X, GetRowOffset( iRowCount ) - fSpacing );
 
-			if ( fMaxHeight > 0.f && fRowHeight > fMaxHeight )
-				fRowHeight = fMaxHeight;
+	// Resizing ourselves above doesn't change the rows.
+	bValidRowOffsets = true;
+}
+
+
+void UKUIListContainer::DoLayout()
+{
+	// Only the rows below a changed row need to move.
+	if ( iFirstDirtyRow != INDEX_NONE )
+	{
+		FVector2D v2SlotLocation = FVector2D( 0.f, GetRowOffset( iFirstDirtyRow ) );
 
-			if ( arRows[ iRow ].IsValid() )
+		for ( int32 iRow = iFirstDirtyRow; iRow < iRowCount; ++iRow )
+		{
+			if ( arRows[ iRow ].IsValid() && arRows[ iRow ]->IsVisible() )
 			{
 				arRows[ iRow ]->SetAlignedTo( NULL );
 				arRows[ iRow ]->SetAlignLocation( v2SlotLocation );
 			}
 
-			v2SlotLocation.Y += fRowHeight + fSpacing;
+			v2SlotLocation.Y += oRowOffsets.GetExtent( iRow );
 		}
 
-		v2SlotLocation.Y -= fSpacing;
-		SetSize( GetSize().X, v2SlotLocation.Y );
 		InvalidateRenderCache();
 	}
+
+	iFirstDirtyRow = INDEX_NONE;
+	bValidLayout = true;
+}
+
+
+float UKUIListContainer::GetRowOffset( uint16 iRow ) const
+{
+	if ( oRowOffsets.Num() != iRowCount )
+	{
+		KUIErrorDebugUO( "Row offsets not built" );
+		return 0.f;
+	}
+
+	// Sum of the extents of all the rows above this one.
+	return oRowOffsets.GetOffset( iRow );
+}
+
+
+uint16 UKUIListContainer::GetRowAtOffset( float fOffset ) const
+{
+	if ( fOffset < 0.f || iRowCount == 0 )
+		return KUI_LIST_INDEX_NONE;
+
+	if ( oRowOffsets.Num() != iRowCount )
+	{
+		KUIErrorDebugUO( "Row offsets not built" );
+		return KUI_LIST_INDEX_NONE;
+	}
+
+	float fRemaining = 0.f;
+	const int32 iRow = oRowOffsets.FindRow( fOffset, fRemaining );
+
+	if ( iRow == INDEX_NONE )
+		return KUI_LIST_INDEX_NONE;
+
+	// Clicked in the row spacing
+	if ( fRemaining >= GetClampedRowHeight( iRow ) )
+		return KUI_LIST_INDEX_NONE;
+
+	return iRow;
+}
+
+
+float UKUIListContainer::GetClampedRowHeight( uint16 iRow ) const
+{
+	float fRowHeight = 0.f;
+
+	if ( arRows[ iRow ].IsValid() )
+		fRowHeight = arRows[ iRow ]->GetSize().Y;
+
+	if ( fMinHeight > 0.f && fRowHeight < fMinHeight )
+		fRowHeight = fMinHeight;
+
+	if ( fMaxHeight > 0.f && fRowHeight > fMaxHeight )
+		fRowHeight = fMaxHeight;
+
+	return fRowHeight;
+}
+
+
+float UKUIListContainer::CalculateRowExtent( uint16 iRow ) const
+{
+	if ( arRows[ iRow ].IsValid() && !arRows[ iRow ]->IsVisible() )
+		return 0.f;
+
+	return GetClampedRowHeight( iRow ) + fSpacing;
+}
+
+
+void UKUIListContainer::RebuildRowOffsets()
+{
+	TArray<float> arRowExtents;
+	arRowExtents.SetNum( iRowCount );
+
+	for ( uint16 iRow = 0; iRow < iRowCount; ++iRow )
+		arRowExtents[ iRow ] = CalculateRowExtent( iRow );
+
+	oRowOffsets.Build( arRowExtents );
+	bValidRowOffsets = true;
+}
+
+
+void UKUIListContainer::UpdateRowExtent( uint16 iRow )
+{
+	if ( !bValidRowOffsets || iRow >= iRowCount )
+		return;
+
+	const float fExtent = CalculateRowExtent( iRow );
+
+	if ( fExtent == oRowOffsets.GetExtent( iRow ) )
+		return;
+
+	oRowOffsets.SetExtent( iRow, fExtent );
+
+	// The row itself may have been hidden or shown, so it needs positioning too.
+	if ( iFirstDirtyRow == INDEX_NONE || iRow < iFirstDirtyRow )
+		iFirstDirtyRow = iRow;
 }
 
 
 bool UKUIListContainer::IsChildsLayoutManaged( UKUIInterfaceElement* oChild ) const
 {
-	if ( oChild == NULL )
-		return false;
+	UKUIListRowContainer* const ctRow = Cast<UKUIListRowContainer>( oChild );
 
-	for ( int32 i = 0; i < arRows.Num(); ++i )
-		if ( arRows[ i ].Get() == oChild )
-			return true;
+	if ( ctRow == NULL )
+		return false;
 
-	return false;
+	return ( GetRowIndexByRef( ctRow ) != KUI_LIST_INDEX_NONE );
 }
 
 
@@ -352,21 +477,33 @@ void UKUIListContainer::OnChildSizeChange( const FKUIInterfaceContainerElementEv
 {
 	Super::OnChildSizeChange( stEventInfo );
 
-	InvalidateLayout();
+	UKUIListRowContainer* const ctRow = Cast<UKUIListRowContainer>( stEventInfo.oElement );
+	const uint16 iRow = ( ctRow != NULL ? GetRowIndexByRef( ctRow ) : KUI_LIST_INDEX_NONE );
+
+	// A single row changed, so only update its offset and keep the rest of the index.
+	if ( bValidRowOffsets && iRow != KUI_LIST_INDEX_NONE && iRow < iRowCount )
+	{
+		UpdateRowExtent( iRow );
+		Super::InvalidateLayout();
+	}
+
+	else
+		InvalidateLayout();
 }
 
 
 uint16 UKUIListContainer::GetRowIndexByRef( UKUIListRowContainer* ctRow ) const
 {
-	for ( int32 i = 0; i < arRows.Num(); ++i )
-	{
-		if ( arRows[ i ].Get() != ctRow )
-			continue;
+	if ( ctRow == NULL )
+		return KUI_LIST_INDEX_NONE;
 
-		return i;
-	}
+	// Rows keep their own index, so only check it still points back at the row.
+	const uint16 iRow = ctRow->GetListIndex();
 
-	return KUI_LIST_INDEX_NONE;
+	if ( !arRows.IsValidIndex( iRow ) || arRows[ iRow ].Get() != ctRow )
+		return KUI_LIST_INDEX_NONE;
+
+	return iRow;
 }
 
 
@@ -903,32 +1040,17 @@ void UKUIListContainer::OnClick( UKUISimpleClickWidget* oWidget, const FVector2D
 		return;
 	}
 
-	float fCurrentHeight = 0.f;
-
-	for ( int32 i = 0; i < arRows.Num(); ++i )
-	{
-		if ( arRows[ i ].Get() == NULL )
-			continue;
-
-		fCurrentHeight = arRows[ i ]->GetLocation().Y;
-
-		// Clicked in the row spacing
-		if ( fCurrentHeight > fClickHeight )
-		{
-			OnRowSelectionClick( NULL );
-			return;
-		}
+	UpdateLayout();
 
-		fCurrentHeight += clamp( arRows[ i ]->GetSize().Y, GetMinimumRowHeight(), GetMaximumRowHeight() );
+	const uint16 iRow = GetRowAtOffset( fClickHeight );
 
-		if ( fCurrentHeight >= fClickHeight )
-		{
-			OnRowSelectionClick( arRows[ i ].Get() );
-			return;
-		}
+	if ( iRow == KUI_LIST_INDEX_NONE )
+	{
+		OnRowSelectionClick( NULL );
+		return;
 	}
 
-	OnRowSelectionClick( NULL );
+	OnRowSelectionClick( arRows[ iRow ].Get() );
 }
 
 
@@ -11,6 +11,8 @@ UKUIListRowContainer::UKUIListRowContainer( const class FObjectInitializer& oObj
 	: Super( oObjectInitializer )
 {
 	bSelectedCache = false;
+	iListIndex = KUI_LIST_INDEX_NONE;
+	bMeasureHeight = true;
 
 	stUnselectedForegroundColor = FColor::White;
 	stUnselectedBackgroundColor = FColor::Black;
@@ -50,6 +52,18 @@ void UKUIListRowContainer::UpdateSelected( bool bSelected )
 }
 
 
+uint16 UKUIListRowContainer::GetListIndex() const
+{
+	return iListIndex;
+}
+
+
+void UKUIListRowContainer::SetListIndex( uint16 iIndex )
+{
+	iListIndex = iIndex;
+}
+
+
 FColor UKUIListRowContainer::GetUnselectedForegroundColor() const
 {
 	return stUnselectedForegroundColor;
@@ -190,8 +204,29 @@ void UKUIListRowContainer::UpdateComponents( UKUIInterfaceContainer* ctContainer
 }
 
 
-void UKUIListRowContainer::DoLayout()
+bool UKUIListRowContainer::IsMeasuringHeight() const
 {
+	return bMeasureHeight;
+}
+
+
+void UKUIListRowContainer::SetMeasuringHeight( bool bMeasureHeight )
+{
+	if ( this->bMeasureHeight == bMeasureHeight )
+		return;
+
+	this->bMeasureHeight = bMeasureHeight;
+
+	InvalidateLayout();
+}
+
+
+void UKUIListRowContainer::MeasureLayout()
+{
+	// The owner has set our size.
+	if ( !bMeasureHeight )
+		return;
+
 	float fMaxHeight = 0.f;
 
 	UKUIListContainer* ctList = Cast<UKUIListContainer>( GetContainer() );
@@ -234,6 +269,19 @@ void UKUIListRowContainer::DoLayout()
 
 	else
 		SetSize( GetContainer()->GetSize().X, fMaxHeight );
+}
 
-	Super::DoLayout();
+
+void UKUIListRowContainer::SetVisible( bool bVisible )
+{
+	if ( this->bVisible == bVisible )
+		return;
+
+	Super::SetVisible( bVisible );
+
+	if ( GetContainer() != NULL )
+	{
+		FKUIInterfaceContainerElementEvent stEventInfo( EKUIInterfaceContainerEventList::E_ChildSizeChange, this );
+		GetContainer()->SendEvent( stEventInfo );
+	}
 }
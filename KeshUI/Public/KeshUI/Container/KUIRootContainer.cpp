@@ -9,6 +9,8 @@ UKUIRootContainer::UKUIRootContainer( const class FObjectInitializer& oObjectIni
 	: Super(oObjectInitializer)
 {
 	aInterface = NULL;
+
+	SubscribeToEvent( EKUIInterfaceContainerEventList::E_ScreenResolutionChange );
 }
 
 
@@ -20,6 +22,22 @@ AKUIInterface* UKUIRootContainer::GetInterface() const
 
 void UKUIRootContainer::SetInterface( AKUIInterface* aInterface )
 {
+	if ( this->aInterface.Get() == aInterface )
+		return;
+
+	// Move our subscribers from the old interface's index to the new one.
+	for ( int32 i = 0; i < KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT; ++i )
+	{
+		const uint8 iEventID = GetSubscriptionEventID( i );
+		const int32 iCount = GetEventSubscribers( iEventID ) + ( RespondsToEvent( iEventID ) ? 1 : 0 );
+
+		if ( this->aInterface.IsValid() )
+			this->aInterface->RemoveEventSubscribers( iEventID, iCount );
+
+		if ( aInterface != NULL )
+			aInterface->AddEventSubscribers( iEventID, iCount );
+	}
+
 	this->aInterface = aInterface;
 }
 
@@ -36,3 +54,43 @@ void UKUIRootContainer::OnScreenResolutionChange( const FKUIInterfaceContainerSc
 
 	Super::OnScreenResolutionChange( stEventInfo );
 }
+
+
+void UKUIRootContainer::SubscribeToEvent( uint8 iEventID )
+{
+	const bool bResponded = RespondsToEvent( iEventID );
+
+	Super::SubscribeToEvent( iEventID );
+
+	if ( !bResponded && RespondsToEvent( iEventID ) && aInterface.IsValid() )
+		aInterface->AddEventSubscribers( iEventID, 1 );
+}
+
+
+void UKUIRootContainer::UnsubscribeFromEvent( uint8 iEventID )
+{
+	const bool bResponded = RespondsToEvent( iEventID );
+
+	Super::UnsubscribeFromEvent( iEventID );
+
+	if ( bResponded && !RespondsToEvent( iEventID ) && aInterface.IsValid() )
+		aInterface->RemoveEventSubscribers( iEventID, 1 );
+}
+
+
+void UKUIRootContainer::AddEventSubscribers( uint8 iEventID, int32 iCount )
+{
+	Super::AddEventSubscribers( iEventID, iCount );
+
+	if ( aInterface.IsValid() )
+		aInterface->AddEventSubscribers( iEventID, iCount );
+}
+
+
+void UKUIRootContainer::RemoveEventSubscribers( uint8 iEventID, int32 iCount )
+{
+	Super::RemoveEventSubscribers( iEventID, iCount );
+
+	if ( aInterface.IsValid() )
+		aInterface->RemoveEventSubscribers( iEventID, iCount );
+}
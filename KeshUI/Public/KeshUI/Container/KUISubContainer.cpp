@@ -36,6 +36,8 @@ void UKUISubContainer::SetCornerOffset( float fX, float fY )
 	v2CornerOffset.X = floor( fX );
 	v2CornerOffset.Y = floor( fY );
 
+	InvalidateScreenLocation();
+
 	UpdateRenderCacheSize();
 }
 
@@ -135,7 +137,11 @@ void UKUISubContainer::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVec
 		SetTotalSizeStruct( oContainerFor->GetSize() + oContainerFor->GetMarginSize() );
 
 	if ( !HasValidLayout() )
-		DoLayout();
+	{
+		SCOPE_CYCLE_COUNTER( STAT_KUILayout );
+
+		UpdateLayout();
+	}
 
 	if ( IsRenderCaching() )
 	{
@@ -154,7 +160,11 @@ void UKUISubContainer::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVec
 				if ( !arChildren[ i ]->IsVisible() )
 					continue;
 
-				arChildren[ i ]->Render( aHud, oCanvas, FVector2D::ZeroVector, oRenderCacheObject );
+				// Skip children that are entirely outside of the tile being drawn.
+				if ( !oRenderCache->ShouldRedraw( arChildren[ i ], v2Origin ) )
+					continue;
+
+				arChildren[ i ]->Render( aHud, oCanvas, v2Origin, oRenderCacheObject );
 			}
 		}
 
@@ -162,16 +172,19 @@ void UKUISubContainer::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVec
 		else
 		{
 			if ( !HasValidAlignLocation() )
-			{
-				TArray<UKUIInterfaceElement*> arAlignStack;
-
-				CalculateAlignLocation( arAlignStack );
-			}
+				CalculateAlignLocation();
 
 			if ( !oRenderCache->IsRenderCacheValid() )
 				oRenderCache->UpdateRenderCache( this );
 
 			v2LastScreenRenderLocation = v2Origin + GetRenderLocation();
+
+			if ( oRenderCacheObject == NULL )
+			{
+				UpdateHitTestRect( aHud, v2LastScreenRenderLocation );
+				UpdateCachedHitTestRects( aHud );
+			}
+
 			oCanvas->Reset();
 			oRenderCache->Render( aHud, oCanvas, v2LastScreenRenderLocation, oRenderCacheObject );
 
@@ -215,10 +228,26 @@ const FVector2D UKUISubContainer::GetNestedLocation( UKUIInterfaceContainer* ctR
 	if ( this == ctRoot )
 		return -GetCornerOffset();
 
+	if ( ctRoot == NULL )
+		return GetScreenLocation();
+
 	if ( this->GetContainer() == NULL )
-		return GetLocation() - GetCornerOffset();
+		return GetNestedOffset();
 
-	return ( this->GetContainer()->GetNestedLocation( ctRoot ) - GetCornerOffset() + GetLocation() );
+	return ( this->GetContainer()->GetNestedLocation( ctRoot ) + GetNestedOffset() );
+}
+
+
+const FVector2D UKUISubContainer::GetNestedOffset() const
+{
+	return GetLocation() - GetCornerOffset();
+}
+
+
+const FVector2D UKUISubContainer::GetHitTestLocation() const
+{
+	// The screen location is where the contents start, not the visible area.
+	return GetScreenLocation() + GetCornerOffset();
 }
 
 
@@ -233,6 +262,20 @@ bool UKUISubContainer::IsMouseOver() const
 		return false;
 	}
 
+	// The hit test rect is the visible portion, as rendered in the last frame.
+	FVector2D v2HitTestMin;
+	FVector2D v2HitTestMax;
+
+	if ( GetHitTestRect( v2HitTestMin, v2HitTestMax ) )
+	{
+		const FVector2D v2CursorLocation = GetInterface()->GetCursorLocation();
+
+		return ( v2CursorLocation.X >= v2HitTestMin.X &&
+				 v2CursorLocation.Y >= v2HitTestMin.Y &&
+				 v2CursorLocation.X < v2HitTestMax.X &&
+				 v2CursorLocation.Y < v2HitTestMax.Y );
+	}
+
 	if ( GetContainer() != NULL )
 	{
 		if ( !GetContainer()->IsMouseOver() )
@@ -3,18 +3,22 @@
 #include "KeshUI/KeshUI.h"
 #include "KeshUI/Container/KUISubContainer.h"
 #include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIRenderBackend.h"
 #include "KeshUI/Container/KUISubContainerRenderCache.h"
 
 
 UKUISubContainerRenderCache::UKUISubContainerRenderCache( const class FObjectInitializer& oObjectInitializer )
 : Super( oObjectInitializer )
 {
-
+	ctSubContainer = NULL;
+	arTileTargets.SetNum( 0 );
 }
 
 
 void UKUISubContainerRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElement )
 {
+	SCOPE_CYCLE_COUNTER( STAT_KUIRenderCacheUpdate );
+
 	if ( oElement == NULL )
 	{
 		KUIErrorUO( "Null element" );
@@ -24,6 +28,13 @@ void UKUISubContainerRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElem
 	//KUILogUO( "Updating Render Cache" );
 
 	UKUISubContainer* const ctSub = Cast<UKUISubContainer>( oElement );
+
+	if ( ctSub == NULL )
+	{
+		KUIErrorUO( "Element is not a sub container" );
+		return;
+	}
+
 	const FVector2D v2ElemSize = ctSub->GetTotalSize();
 
 	if ( v2ElemSize.X < 1.f || v2ElemSize.Y < 1.f )
@@ -32,80 +43,161 @@ void UKUISubContainerRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElem
 		return;
 	}
 
-	bool bRebuildTexture = false;
+	ctSubContainer = ctSub;
+	oTileGrid.SetContentSize( v2ElemSize );
 
-	if ( GetTexture() == NULL )
-		bRebuildTexture = true;
+	FVector2D v2VisibleMin;
+	FVector2D v2VisibleMax;
+	GetVisibleRegion( v2VisibleMin, v2VisibleMax );
+	oTileGrid.SetVisibleRegion( v2VisibleMin, v2VisibleMax );
 
-	else if ( v2ElemSize.X != GetTexture()->GetSurfaceWidth() || v2ElemSize.Y != GetTexture()->GetSurfaceHeight() )
-		bRebuildTexture = true;
+	// Elements that have changed since the last update may now cover different tiles.
+	if ( bValidRenderCache )
+		UpdateDirtyElements( ctSub );
 
-	if ( bRebuildTexture )
-		CreateRenderCache( v2ElemSize );
+	arDirtyElements.Reset();
 
-	if ( GetTexture() == NULL )
+	if ( !bValidRenderCache )
+		oTileGrid.InvalidateAll();
+
+	const TArray<FKUIRenderCacheTile>& arTiles = oTileGrid.GetTiles();
+	const float fTileSize = static_cast<float>( oTileGrid.GetTileSize() );
+
+	for ( int32 i = 0; i < arTiles.Num(); ++i )
 	{
-		KUIErrorUO( "Texture is null" );
-		return;
+		if ( arTiles[ i ].bValid )
+			continue;
+
+		const int32 iSlot = arTiles[ i ].iSlot;
+
+		if ( arTileTargets.Num() <= iSlot )
+			arTileTargets.SetNum( iSlot + 1 );
+
+		if ( arTileTargets[ iSlot ] == NULL )
+			arTileTargets[ iSlot ] = CreateRenderTarget( FVector2D( fTileSize, fTileSize ) );
+
+		// Only the children overlapping the tile are drawn.
+		const FVector2D v2TileOrigin = oTileGrid.GetTileOrigin( arTiles[ i ] );
+		stRedrawRect = FBox2D( v2TileOrigin, v2TileOrigin + FVector2D( fTileSize, fTileSize ) );
+
+		RenderToTarget( ctSub, arTileTargets[ iSlot ], -v2TileOrigin, FName( TEXT( "Sub Container Render Cache Canvas" ) ) );
+		oTileGrid.ValidateTile( i );
 	}
 
-	if ( !GetTexture()->IsA<UTextureRenderTarget2D>() )
-	{
-		KUIErrorUO( "Texture is not a render target" );
+	stRedrawRect = FBox2D( 0 );
+	bValidRenderCache = true;
+}
+
+
+bool UKUISubContainerRenderCache::IsRenderCacheValid() const
+{
+	if ( !Super::IsRenderCacheValid() )
+		return false;
+
+	FVector2D v2VisibleMin;
+	FVector2D v2VisibleMax;
+	GetVisibleRegion( v2VisibleMin, v2VisibleMax );
+
+	if ( oTileGrid.IsVisibleRegionChanged( v2VisibleMin, v2VisibleMax ) )
+		return false;
+
+	return !oTileGrid.HasInvalidTiles();
+}
+
+
+void UKUISubContainerRenderCache::InvalidateRenderCacheRect( const FVector2D& v2Min, const FVector2D& v2Max )
+{
+	oTileGrid.InvalidateRect( v2Min, v2Max );
+}
+
+
+void UKUISubContainerRenderCache::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject )
+{
+	if ( !ctSubContainer.IsValid() )
 		return;
-	}
 
-	UTextureRenderTarget2D* const tRenderTarget = Cast<UTextureRenderTarget2D>( GetTexture() );
-	tRenderTarget->UpdateResourceImmediate();
+	FVector2D v2VisibleMin;
+	FVector2D v2VisibleMax;
+	GetVisibleRegion( v2VisibleMin, v2VisibleMax );
 
-	UCanvas* uoCanvas = Cast<UCanvas>( StaticFindObjectFast( UCanvas::StaticClass(), GetTransientPackage(), FName( TEXT( "Sub Container Render Cache Canvas" ) ) ) );
+	const TArray<FKUIRenderCacheTile>& arTiles = oTileGrid.GetTiles();
+	const float fTileSize = static_cast<float>( oTileGrid.GetTileSize() );
 
-	if ( uoCanvas == NULL )
-	{	
-		uoCanvas = NewObject<UCanvas>( GetTransientPackage(), FName( TEXT( "Sub Container Render Cache Canvas" ) ) );
-		uoCanvas->AddToRoot();
+	for ( int32 i = 0; i < arTiles.Num(); ++i )
+	{
+		if ( !arTileTargets.IsValidIndex( arTiles[ i ].iSlot ) || arTileTargets[ arTiles[ i ].iSlot ] == NULL )
+			continue;
+
+		const FVector2D v2TileMin = oTileGrid.GetTileOrigin( arTiles[ i ] );
+		const FVector2D v2ClipMin( max( v2TileMin.X, v2VisibleMin.X ), max( v2TileMin.Y, v2VisibleMin.Y ) );
+		const FVector2D v2ClipMax( min( v2TileMin.X + fTileSize, v2VisibleMax.X ), min( v2TileMin.Y + fTileSize, v2VisibleMax.Y ) );
+
+		// Tiles in the margin aren't drawn.
+		if ( v2ClipMax.X <= v2ClipMin.X || v2ClipMax.Y <= v2ClipMin.Y )
+			continue;
+
+		const FVector2D v2DrawLocation = v2Origin + v2ClipMin - v2VisibleMin;
+		const FVector2D v2DrawSize = v2ClipMax - v2ClipMin;
+		const FVector2D v2UV = ( v2ClipMin - v2TileMin ) / fTileSize;
+
+		FKUIRenderBackend::Get( aHud ).DrawTile(
+			oCanvas,
+			v2DrawLocation.X,
+			v2DrawLocation.Y,
+			v2DrawSize.X,
+			v2DrawSize.Y,
+			v2UV.X,
+			v2UV.Y,
+			v2DrawSize.X / fTileSize,
+			v2DrawSize.Y / fTileSize,
+			GetDrawColor().ReinterpretAsLinear(),
+			arTileTargets[ arTiles[ i ].iSlot ]->Resource,
+			true
+		);
 	}
+}
+
+
+const FKUIRenderCacheTileGrid& UKUISubContainerRenderCache::GetTileGrid() const
+{
+	return oTileGrid;
+}
+
 
-	uoCanvas->Init( floor( v2ElemSize.X ), floor( v2ElemSize.Y ), NULL );
-	uoCanvas->Update();
+void UKUISubContainerRenderCache::DestroyRenderCache()
+{
+	Super::DestroyRenderCache();
 
-	ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
-		CanvasRenderTargetMakeCurrentCommand,
-		FTextureRenderTarget2DResource*,
-		TextureRenderTarget,
-		static_cast<FTextureRenderTarget2DResource*>( tRenderTarget->GameThread_GetRenderTargetResource() ),
-		{
-			SetRenderTarget( RHICmdList, TextureRenderTarget->GetRenderTargetTexture(), FTexture2DRHIRef() );
-			RHICmdList.SetViewport( 0, 0, 0.0f, TextureRenderTarget->GetSizeXY().X, TextureRenderTarget->GetSizeXY().Y, 1.0f );
-		}
-	)
+	oTileGrid.Reset();
 
-	FCanvas oCanvas( tRenderTarget->GameThread_GetRenderTargetResource(), NULL, GetWorld(), GetInterface()->GetWorld()->FeatureLevel );
-	uoCanvas->Canvas = &oCanvas;
-	oCanvas.Clear( tRenderTarget->ClearColor );
+	for ( int32 i = 0; i < arTileTargets.Num(); ++i )
+		ReleaseRenderTarget( arTileTargets[ i ] );
 
-	oElement->Render( GetInterface(), uoCanvas, FVector2D::ZeroVector, oElement );
+	arTileTargets.SetNum( 0 );
+}
 
-	uoCanvas->Canvas = NULL;
 
-	if ( IsInGameThread() )
-		oCanvas.Flush_GameThread();
+void UKUISubContainerRenderCache::GetVisibleRegion( FVector2D& v2Min, FVector2D& v2Max ) const
+{
+	UKUISubContainer* const ctSub = ctSubContainer.IsValid() ? ctSubContainer.Get() : Cast<UKUISubContainer>( GetOuter() );
 
-	else if ( IsInRenderingThread() )
+	if ( ctSub == NULL )
 	{
-		FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
-		oCanvas.Flush_RenderThread( RHICmdList );
+		v2Min = FVector2D::ZeroVector;
+		v2Max = FVector2D::ZeroVector;
+		return;
 	}
 
-	ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
-		CanvasRenderTargetResolveCommand,
-		FTextureRenderTargetResource*,
-		RenderTargetResource,
-		static_cast<FTextureRenderTarget2DResource*>( tRenderTarget->GameThread_GetRenderTargetResource() ),
-		{
-			RHICmdList.CopyToResolveTarget( RenderTargetResource->GetRenderTargetTexture(), RenderTargetResource->TextureRHI, true, FResolveParams() );
-		}
-	)
+	const FVector2D v2TotalSize = ctSub->GetTotalSize();
+	const FVector2D v2Size = ctSub->GetSize();
 
-	bValidRenderCache = true;
+	v2Min = ctSub->GetCornerOffset();
+	v2Max.X = min( v2Min.X + v2Size.X, v2TotalSize.X );
+	v2Max.Y = min( v2Min.Y + v2Size.Y, v2TotalSize.Y );
+}
+
+
+FVector2D UKUISubContainerRenderCache::GetContentOrigin( UKUIInterfaceElement* oOwner ) const
+{
+	return FVector2D::ZeroVector;
 }
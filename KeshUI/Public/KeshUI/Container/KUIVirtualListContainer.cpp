@@ -0,0 +1,502 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/Container/KUIListRowContainer.h"
+#include "KeshUI/Container/KUIVirtualListContainer.h"
+
+
+UKUIVirtualListContainer::UKUIVirtualListContainer( const class FObjectInitializer& oObjectInitializer )
+	: Super( oObjectInitializer )
+{
+	iVirtualRowCount = 0;
+	fDefaultRowHeight = 20.f;
+	fSpacing = 0.f;
+	arRowHeights.SetNum( 0 );
+	oRowOffsets.Reset();
+	bValidRowOffsets = false;
+	cRowClass = UKUIListRowContainer::StaticClass();
+	arPoolBindings.SetNum( 0 );
+	arRowPool.SetNum( 0 );
+	iFirstVisibleRow = INDEX_NONE;
+	iLastVisibleRow = INDEX_NONE;
+	fLastScrollOffset = -1.f;
+	fLastVisibleHeight = -1.f;
+	bValidVisibleRows = false;
+	bValidScrollExtent = false;
+	dgBindRow.Unbind();
+	bMouseWheelScroll = true;
+}
+
+
+int32 UKUIVirtualListContainer::GetVirtualRowCount() const
+{
+	return iVirtualRowCount;
+}
+
+
+void UKUIVirtualListContainer::SetVirtualRowCount( int32 iRowCount )
+{
+	iRowCount = max( 0, iRowCount );
+
+	if ( iVirtualRowCount == iRowCount )
+		return;
+
+	iVirtualRowCount = iRowCount;
+
+	if ( arRowHeights.Num() > 0 )
+	{
+		const int32 iOldCount = arRowHeights.Num();
+		arRowHeights.SetNum( iVirtualRowCount );
+
+		for ( int32 i = iOldCount; i < iVirtualRowCount; ++i )
+			arRowHeights[ i ] = fDefaultRowHeight;
+	}
+
+	RefreshRows();
+	InvalidateVirtualLayout();
+}
+
+
+float UKUIVirtualListContainer::GetDefaultRowHeight() const
+{
+	return fDefaultRowHeight;
+}
+
+
+void UKUIVirtualListContainer::SetDefaultRowHeight( float fHeight )
+{
+	fHeight = max( 1.f, fHeight );
+
+	if ( fDefaultRowHeight == fHeight )
+		return;
+
+	fDefaultRowHeight = fHeight;
+
+	InvalidateVirtualLayout();
+}
+
+
+float UKUIVirtualListContainer::GetVirtualRowHeight( int32 iRow ) const
+{
+	if ( iRow < 0 || iRow >= iVirtualRowCount )
+	{
+		KUIErrorUO( "Invalid row: %d", iRow );
+		return 0.f;
+	}
+
+	if ( arRowHeights.Num() == 0 )
+		return fDefaultRowHeight;
+
+	return arRowHeights[ iRow ];
+}
+
+
+void UKUIVirtualListContainer::SetVirtualRowHeight( int32 iRow, float fHeight )
+{
+	if ( iRow < 0 || iRow >= iVirtualRowCount )
+	{
+		KUIErrorUO( "Invalid row: %d", iRow );
+		return;
+	}
+
+	fHeight = max( 0.f, fHeight );
+
+	// First variable height, so fill the height cache.
+	if ( arRowHeights.Num() == 0 )
+	{
+		if ( fHeight == fDefaultRowHeight )
+			return;
+
+		arRowHeights.Init( fDefaultRowHeight, iVirtualRowCount );
+	}
+
+	if ( arRowHeights[ iRow ] == fHeight )
+		return;
+
+	arRowHeights[ iRow ] = fHeight;
+
+	// Only the rows below this one move, so keep the rest of the offsets.
+	if ( bValidRowOffsets )
+	{
+		oRowOffsets.SetExtent( iRow, fHeight + fSpacing );
+
+		bValidScrollExtent = false;
+		bValidVisibleRows = false;
+	}
+
+	else
+		InvalidateVirtualLayout();
+}
+
+
+void UKUIVirtualListContainer::ClearVirtualRowHeights()
+{
+	if ( arRowHeights.Num() == 0 )
+		return;
+
+	arRowHeights.SetNum( 0 );
+	oRowOffsets.Reset();
+
+	InvalidateVirtualLayout();
+}
+
+
+bool UKUIVirtualListContainer::HasVariableRowHeights() const
+{
+	return ( arRowHeights.Num() > 0 );
+}
+
+
+float UKUIVirtualListContainer::GetRowSpacing() const
+{
+	return fSpacing;
+}
+
+
+void UKUIVirtualListContainer::SetRowSpacing( float fSpacing )
+{
+	if ( this->fSpacing == fSpacing )
+		return;
+
+	this->fSpacing = fSpacing;
+
+	InvalidateVirtualLayout();
+}
+
+
+TSubclassOf<UKUIListRowContainer> UKUIVirtualListContainer::GetRowClass() const
+{
+	return cRowClass;
+}
+
+
+void UKUIVirtualListContainer::SetRowClass( TSubclassOf<UKUIListRowContainer> cRowClass )
+{
+	if ( this->cRowClass == cRowClass )
+		return;
+
+	DestroyRowPool();
+
+	this->cRowClass = cRowClass;
+
+	bValidVisibleRows = false;
+}
+
+
+float UKUIVirtualListContainer::GetRowOffset( int32 iRow ) const
+{
+	if ( iRow <= 0 )
+		return 0.f;
+
+	iRow = min( iRow, iVirtualRowCount );
+
+	// Fixed height rows are calculated directly.
+	if ( arRowHeights.Num() == 0 )
+		return ( ( fDefaultRowHeight + fSpacing ) * static_cast<float>( iRow ) );
+
+	if ( !bValidRowOffsets )
+		UpdateRowOffsets();
+
+	return oRowOffsets.GetOffset( iRow );
+}
+
+
+int32 UKUIVirtualListContainer::GetRowAtOffset( float fOffset ) const
+{
+	if ( iVirtualRowCount == 0 || fOffset < 0.f )
+		return INDEX_NONE;
+
+	if ( arRowHeights.Num() == 0 )
+	{
+		const int32 iRow = floor( fOffset / ( fDefaultRowHeight + fSpacing ) );
+		return ( iRow < iVirtualRowCount ? iRow : INDEX_NONE );
+	}
+
+	if ( !bValidRowOffsets )
+		UpdateRowOffsets();
+
+	float fRemaining = 0.f;
+	return oRowOffsets.FindRow( fOffset, fRemaining );
+}
+
+
+float UKUIVirtualListContainer::GetTotalRowHeight() const
+{
+	if ( iVirtualRowCount == 0 )
+		return 0.f;
+
+	return ( GetRowOffset( iVirtualRowCount ) - fSpacing );
+}
+
+
+UKUIListRowContainer* UKUIVirtualListContainer::GetBoundRow( int32 iRow ) const
+{
+	if ( iRow == INDEX_NONE )
+		return NULL;
+
+	for ( int32 i = 0; i < arPoolBindings.Num(); ++i )
+	{
+		if ( arPoolBindings[ i ] != iRow )
+			continue;
+
+		return arRowPool[ i ];
+	}
+
+	return NULL;
+}
+
+
+int32 UKUIVirtualListContainer::GetPooledRowCount() const
+{
+	return arRowPool.Num();
+}
+
+
+void UKUIVirtualListContainer::RefreshRows()
+{
+	for ( int32 i = 0; i < arPoolBindings.Num(); ++i )
+		arPoolBindings[ i ] = INDEX_NONE;
+
+	bValidVisibleRows = false;
+}
+
+
+void UKUIVirtualListContainer::RefreshRow( int32 iRow )
+{
+	for ( int32 i = 0; i < arPoolBindings.Num(); ++i )
+	{
+		if ( arPoolBindings[ i ] != iRow )
+			continue;
+
+		BindPooledRow( i, iRow );
+		return;
+	}
+}
+
+
+void UKUIVirtualListContainer::ScrollToRow( int32 iRow )
+{
+	if ( iRow < 0 || iRow >= iVirtualRowCount )
+	{
+		KUIErrorUO( "Invalid row: %d", iRow );
+		return;
+	}
+
+	if ( !bValidScrollExtent )
+		UpdateScrollExtent();
+
+	SetScrollPosition( GetRowOffset( iRow ), ctScrollArea.IsValid() ? ctScrollArea->GetCornerOffset().X : 0.f );
+}
+
+
+void UKUIVirtualListContainer::SetBindRowDelegate( UObject* oObject, FKUIVirtualListBindRowPrototype fnBindRowDelegate )
+{
+	if ( oObject == NULL || fnBindRowDelegate == NULL )
+		dgBindRow.Unbind();
+
+	else
+		dgBindRow.BindUObject( oObject, fnBindRowDelegate );
+}
+
+
+void UKUIVirtualListContainer::SetSize( float fWidth, float fHeight )
+{
+	if ( v2Size.X == fWidth && v2Size.Y == fHeight )
+		return;
+
+	Super::SetSize( fWidth, fHeight );
+
+	InvalidateVirtualLayout();
+}
+
+
+void UKUIVirtualListContainer::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject )
+{
+	if ( !bValidScrollExtent )
+		UpdateScrollExtent();
+
+	if ( ctScrollArea.IsValid() )
+	{
+		if ( ctScrollArea->GetCornerOffset().Y != fLastScrollOffset || ctScrollArea->GetSize().Y != fLastVisibleHeight )
+			bValidVisibleRows = false;
+	}
+
+	if ( !bValidVisibleRows )
+		UpdateVisibleRows();
+
+	Super::Render( aHud, oCanvas, v2Origin, oRenderCacheObject );
+}
+
+
+void UKUIVirtualListContainer::UpdateRowOffsets() const
+{
+	TArray<float> arRowExtents;
+	arRowExtents.SetNum( iVirtualRowCount );
+
+	for ( int32 i = 0; i < iVirtualRowCount; ++i )
+		arRowExtents[ i ] = arRowHeights[ i ] + fSpacing;
+
+	oRowOffsets.Build( arRowExtents );
+
+	bValidRowOffsets = true;
+}
+
+
+void UKUIVirtualListContainer::UpdateScrollExtent()
+{
+	bValidScrollExtent = true;
+
+	const float fTotalHeight = GetTotalRowHeight();
+	float fWidth = GetSize().X;
+
+	if ( fTotalHeight > GetSize().Y )
+		fWidth -= GetCornerSize().X;
+
+	SetScrollableSize( max( 0.f, fWidth ), fTotalHeight );
+}
+
+
+void UKUIVirtualListContainer::UpdateVisibleRows()
+{
+	bValidVisibleRows = true;
+
+	if ( !ctScrollArea.IsValid() )
+	{
+		KUIErrorUO( "Null scroll area" );
+		return;
+	}
+
+	fLastScrollOffset = ctScrollArea->GetCornerOffset().Y;
+	fLastVisibleHeight = ctScrollArea->GetSize().Y;
+
+	iFirstVisibleRow = GetRowAtOffset( fLastScrollOffset );
+	iLastVisibleRow = INDEX_NONE;
+
+	if ( iFirstVisibleRow != INDEX_NONE )
+	{
+		iLastVisibleRow = GetRowAtOffset( fLastScrollOffset + fLastVisibleHeight );
+
+		if ( iLastVisibleRow == INDEX_NONE )
+			iLastVisibleRow = iVirtualRowCount - 1;
+	}
+
+	// Free up rows that have scrolled out of view.
+	for ( int32 i = 0; i < arPoolBindings.Num(); ++i )
+	{
+		if ( arPoolBindings[ i ] == INDEX_NONE )
+			continue;
+
+		if ( iFirstVisibleRow != INDEX_NONE && arPoolBindings[ i ] >= iFirstVisibleRow && arPoolBindings[ i ] <= iLastVisibleRow )
+			continue;
+
+		arPoolBindings[ i ] = INDEX_NONE;
+	}
+
+	if ( iFirstVisibleRow != INDEX_NONE )
+	{
+		int32 iFreeIndex = 0;
+
+		for ( int32 iRow = iFirstVisibleRow; iRow <= iLastVisibleRow; ++iRow )
+		{
+			UKUIListRowContainer* const ctBoundRow = GetBoundRow( iRow );
+
+			// Already bound, but the layout may have changed.
+			if ( ctBoundRow != NULL )
+			{
+				ctBoundRow->SetLocation( 0.f, GetRowOffset( iRow ) );
+				ctBoundRow->SetSize( ctScrollArea->GetTotalSize().X, GetVirtualRowHeight( iRow ) );
+				continue;
+			}
+
+			while ( iFreeIndex < arPoolBindings.Num() && arPoolBindings[ iFreeIndex ] != INDEX_NONE )
+				++iFreeIndex;
+
+			if ( iFreeIndex >= arPoolBindings.Num() )
+				iFreeIndex = CreatePooledRow();
+
+			if ( iFreeIndex == INDEX_NONE )
+				break;
+
+			BindPooledRow( iFreeIndex, iRow );
+		}
+	}
+
+	// Hide the rows we don't need this frame.
+	for ( int32 i = 0; i < arPoolBindings.Num(); ++i )
+	{
+		if ( arPoolBindings[ i ] != INDEX_NONE )
+			continue;
+
+		if ( arRowPool[ i ] != NULL )
+			arRowPool[ i ]->SetVisible( false );
+	}
+}
+
+
+int32 UKUIVirtualListContainer::CreatePooledRow()
+{
+	if ( cRowClass == NULL )
+	{
+		KUIErrorUO( "Null row class" );
+		return INDEX_NONE;
+	}
+
+	UKUIListRowContainer* const ctRow = NewObject<UKUIListRowContainer>( this, *cRowClass );
+
+	if ( ctRow == NULL )
+	{
+		KUIErrorUO( "Unable to create row" );
+		return INDEX_NONE;
+	}
+
+	ctRow->InitializeElement();
+	ctRow->SetMeasuringHeight( false );
+	ctRow->SetHorizontalAlignment( EKUIInterfaceHAlign::HA_None );
+	ctRow->SetVerticalAlignment( EKUIInterfaceVAlign::VA_None );
+	ctScrollArea->AddChild( ctRow );
+
+	arPoolBindings.Add( INDEX_NONE );
+	return arRowPool.Add( ctRow );
+}
+
+
+void UKUIVirtualListContainer::BindPooledRow( int32 iPoolIndex, int32 iRow )
+{
+	UKUIListRowContainer* const ctRow = arRowPool[ iPoolIndex ];
+	arPoolBindings[ iPoolIndex ] = iRow;
+
+	if ( ctRow == NULL )
+		return;
+
+	ctRow->SetLocation( 0.f, GetRowOffset( iRow ) );
+	ctRow->SetSize( ctScrollArea->GetTotalSize().X, GetVirtualRowHeight( iRow ) );
+	ctRow->SetVisible( true );
+
+	dgBindRow.ExecuteIfBound( ctRow, iRow );
+	OnBindRowBP( ctRow, iRow );
+}
+
+
+void UKUIVirtualListContainer::DestroyRowPool()
+{
+	for ( int32 i = 0; i < arRowPool.Num(); ++i )
+	{
+		if ( arRowPool[ i ] == NULL )
+			continue;
+
+		if ( ctScrollArea.IsValid() )
+			ctScrollArea->RemoveChild( arRowPool[ i ] );
+	}
+
+	arRowPool.SetNum( 0 );
+	arPoolBindings.SetNum( 0 );
+}
+
+
+void UKUIVirtualListContainer::InvalidateVirtualLayout()
+{
+	bValidRowOffsets = false;
+	bValidScrollExtent = false;
+	bValidVisibleRows = false;
+}
@@ -0,0 +1,21 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIBatchUpdateScope.h"
+
+
+FKUIBatchUpdateScope::FKUIBatchUpdateScope( AKUIInterface* aInterface )
+{
+	this->aInterface = aInterface;
+
+	if ( aInterface != NULL )
+		aInterface->BeginBatchUpdate();
+}
+
+
+FKUIBatchUpdateScope::~FKUIBatchUpdateScope()
+{
+	if ( aInterface != NULL )
+		aInterface->EndBatchUpdate();
+}
@@ -0,0 +1,44 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+class AKUIInterface;
+
+/* The notifications an interface can hold back for an element during a batch update. */
+namespace EKUIBatchUpdate
+{
+	enum Type
+	{
+		B_None = 0,
+		B_AlignLocation = 1 << 0,
+		B_ChildLocationChange = 1 << 1,
+		B_ChildSizeChange = 1 << 2,
+		B_ContainerRenderCache = 1 << 3,
+		B_RenderCache = 1 << 4
+	};
+}
+
+
+/**
+ * Holds back align location invalidation, child change events sent to containers and render cache
+ * invalidation on an interface for as long as it exists.  When the last scope ends, each element's
+ * deferred notifications are sent once.  Scopes may be nested.
+ */
+class KESHUI_API FKUIBatchUpdateScope
+{
+
+public:
+
+	FKUIBatchUpdateScope( AKUIInterface* aInterface );
+	~FKUIBatchUpdateScope();
+
+protected:
+
+	AKUIInterface* aInterface;
+
+private:
+
+	FKUIBatchUpdateScope( const FKUIBatchUpdateScope& );
+	FKUIBatchUpdateScope& operator=( const FKUIBatchUpdateScope& );
+
+};
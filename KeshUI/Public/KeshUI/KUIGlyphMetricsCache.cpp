@@ -0,0 +1,426 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIGlyphMetricsCache.h"
+
+// Height is never negative, so this marks a character that hasn't been measured.
+static const FVector2D v2Unmeasured( 0.f, -1.f );
+
+
+FKUIGlyphMetrics::FKUIGlyphMetrics( UFont* foFont )
+{
+	this->foFont = foFont;
+	arPages.SetNum( KUI_GLYPH_METRICS_BMP_PAGES );
+}
+
+
+const FVector2D& FKUIGlyphMetrics::GetCharSize( TCHAR chChar )
+{
+	const uint32 iChar = static_cast<uint32>( chChar );
+	const uint32 iPage = iChar / KUI_GLYPH_METRICS_PAGE_SIZE;
+
+	if ( iPage >= KUI_GLYPH_METRICS_BMP_PAGES )
+	{
+		FVector2D* const v2Size = mpSupplementary.Find( iChar );
+
+		if ( v2Size != NULL )
+			return *v2Size;
+
+		return mpSupplementary.Add( iChar, MeasureChar( chChar ) );
+	}
+
+	TArray<FVector2D>& arPage = arPages[ iPage ];
+
+	if ( arPage.Num() == 0 )
+		arPage.Init( v2Unmeasured, KUI_GLYPH_METRICS_PAGE_SIZE );
+
+	FVector2D& v2Size = arPage[ iChar % KUI_GLYPH_METRICS_PAGE_SIZE ];
+
+	if ( v2Size.Y < 0.f )
+		v2Size = MeasureChar( chChar );
+
+	return v2Size;
+}
+
+
+void FKUIGlyphMetrics::SetCharSize( uint32 iChar, const FVector2D& v2Size )
+{
+	const uint32 iPage = iChar / KUI_GLYPH_METRICS_PAGE_SIZE;
+
+	if ( iPage >= KUI_GLYPH_METRICS_BMP_PAGES )
+	{
+		mpSupplementary.Add( iChar, v2Size );
+		return;
+	}
+
+	TArray<FVector2D>& arPage = arPages[ iPage ];
+
+	if ( arPage.Num() == 0 )
+		arPage.Init( v2Unmeasured, KUI_GLYPH_METRICS_PAGE_SIZE );
+
+	arPage[ iChar % KUI_GLYPH_METRICS_PAGE_SIZE ] = v2Size;
+}
+
+
+void FKUIGlyphMetrics::Precompute()
+{
+	if ( !foFont.IsValid() || foFont->FontCacheType != EFontCacheType::Offline )
+		return;
+
+	if ( foFont->IsRemapped )
+	{
+		for ( TMap<uint16, uint16>::TConstIterator itRemap( foFont->CharRemap ); itRemap; ++itRemap )
+			GetCharSize( static_cast<TCHAR>( itRemap.Key() ) );
+	}
+
+	else
+	{
+		for ( int32 i = 0; i < foFont->Characters.Num(); ++i )
+			GetCharSize( static_cast<TCHAR>( i ) );
+	}
+}
+
+
+void FKUIGlyphMetrics::GetMeasuredChars( TArray<uint32>& arChars, TArray<FVector2D>& arSizes ) const
+{
+	arChars.Reset();
+	arSizes.Reset();
+
+	for ( int32 iPage = 0; iPage < arPages.Num(); ++iPage )
+	{
+		const TArray<FVector2D>& arPage = arPages[ iPage ];
+
+		for ( int32 i = 0; i < arPage.Num(); ++i )
+		{
+			if ( arPage[ i ].Y < 0.f )
+				continue;
+
+			arChars.Add( iPage * KUI_GLYPH_METRICS_PAGE_SIZE + i );
+			arSizes.Add( arPage[ i ] );
+		}
+	}
+
+	for ( TMap<uint32, FVector2D>::TConstIterator itChars( mpSupplementary ); itChars; ++itChars )
+	{
+		arChars.Add( itChars.Key() );
+		arSizes.Add( itChars.Value() );
+	}
+}
+
+
+void FKUIGlyphMetrics::Reset()
+{
+	for ( int32 i = 0; i < arPages.Num(); ++i )
+		arPages[ i ].Empty();
+
+	mpSupplementary.Empty();
+}
+
+
+FVector2D FKUIGlyphMetrics::MeasureChar( TCHAR chChar ) const
+{
+	if ( !foFont.IsValid() )
+		return FVector2D::ZeroVector;
+
+	float fX = 0.f;
+	float fY = 0.f;
+	foFont->GetCharSize( chChar, fX, fY );
+
+	return FVector2D( fX, fY );
+}
+
+
+FKUIGlyphMetrics* FKUIGlyphMetricsCache::Get( UFont* foFont )
+{
+	if ( foFont == NULL )
+		return NULL;
+
+	TMap<TWeakObjectPtr<UFont>, TSharedPtr<FKUIGlyphMetrics>>& mpFontMetrics = GetFontMetrics();
+	TSharedPtr<FKUIGlyphMetrics>* const stMetrics = mpFontMetrics.Find( foFont );
+
+	if ( stMetrics != NULL )
+		return stMetrics->Get();
+
+	// Drop fonts that have been unloaded before adding a new one.
+	for ( TMap<TWeakObjectPtr<UFont>, TSharedPtr<FKUIGlyphMetrics>>::TIterator itFonts( mpFontMetrics ); itFonts; ++itFonts )
+		if ( !itFonts.Key().IsValid() )
+			itFonts.RemoveCurrent();
+
+	FKUIGlyphMetrics* const oMetrics = mpFontMetrics.Add( foFont, TSharedPtr<FKUIGlyphMetrics>( new FKUIGlyphMetrics( foFont ) ) ).Get();
+	ApplyLoadedTable( foFont, *oMetrics );
+
+	return oMetrics;
+}
+
+
+void FKUIGlyphMetricsCache::Invalidate( UFont* foFont )
+{
+	if ( foFont == NULL )
+	{
+		GetFontMetrics().Empty();
+		return;
+	}
+
+	GetFontMetrics().Remove( foFont );
+}
+
+
+void FKUIGlyphMetricsCache::Precompute( UFont* foFont )
+{
+	FKUIGlyphMetrics* const oMetrics = Get( foFont );
+
+	if ( oMetrics != NULL )
+		oMetrics->Precompute();
+}
+
+
+bool FKUIGlyphMetricsCache::SaveToFile( const FString& strFileName )
+{
+	FBufferArchive arPayload;
+	int32 iFontCount = 0;
+
+	// The font count is filled in once the fonts have been written.
+	arPayload << iFontCount;
+
+	for ( TMap<TWeakObjectPtr<UFont>, TSharedPtr<FKUIGlyphMetrics>>::TIterator itFonts( GetFontMetrics() ); itFonts; ++itFonts )
+	{
+		UFont* const foFont = itFonts.Key().Get();
+
+		// Runtime fonts are measured through Slate, which the checksum can't see, so they aren't saved.
+		if ( foFont == NULL || foFont->FontCacheType != EFontCacheType::Offline )
+			continue;
+
+		itFonts.Value()->Precompute();
+
+		FString strFontPath = foFont->GetPathName();
+		uint32 iChecksum = GetFontChecksum( foFont );
+		TArray<uint32> arChars;
+		TArray<FVector2D> arSizes;
+		itFonts.Value()->GetMeasuredChars( arChars, arSizes );
+		int32 iCharCount = arChars.Num();
+
+		arPayload << strFontPath;
+		arPayload << iChecksum;
+		arPayload << iCharCount;
+
+		for ( int32 i = 0; i < iCharCount; ++i )
+		{
+			arPayload << arChars[ i ];
+			arPayload << arSizes[ i ].X;
+			arPayload << arSizes[ i ].Y;
+		}
+
+		++iFontCount;
+	}
+
+	FMemory::Memcpy( arPayload.GetData(), &iFontCount, sizeof( int32 ) );
+
+	uint32 iMagic = KUI_GLYPH_METRICS_FILE_MAGIC;
+	uint32 iVersion = KUI_GLYPH_METRICS_FILE_VERSION;
+	uint32 iPayloadChecksum = FCrc::MemCrc32( arPayload.GetData(), arPayload.Num() );
+	int32 iPayloadSize = arPayload.Num();
+
+	FBufferArchive arFile;
+	arFile << iMagic;
+	arFile << iVersion;
+	arFile << iPayloadChecksum;
+	arFile << iPayloadSize;
+	arFile.Append( arPayload );
+
+	if ( !FFileHelper::SaveArrayToFile( arFile, *strFileName ) )
+		return false;
+
+	GetNeedsSaving() = false;
+	return true;
+}
+
+
+bool FKUIGlyphMetricsCache::LoadFromFile( const FString& strFileName )
+{
+	// The file is read in one go and parsed straight out of the buffer.
+	TArray<uint8> arFile;
+
+	// Until a file has been loaded, anything measured is worth saving.
+	GetNeedsSaving() = true;
+
+	if ( !FFileHelper::LoadFileToArray( arFile, *strFileName, FILEREAD_Silent ) )
+		return false;
+
+	FMemoryReader oReader( arFile );
+	uint32 iMagic = 0;
+	uint32 iVersion = 0;
+	uint32 iPayloadChecksum = 0;
+	int32 iPayloadSize = 0;
+
+	oReader << iMagic;
+	oReader << iVersion;
+	oReader << iPayloadChecksum;
+	oReader << iPayloadSize;
+
+	if ( oReader.IsError() || iMagic != KUI_GLYPH_METRICS_FILE_MAGIC || iVersion != KUI_GLYPH_METRICS_FILE_VERSION )
+	{
+		KUIWarnCW( GWorld, "Ignoring glyph metrics file %s: not a glyph metrics file or the wrong version", *strFileName );
+		return false;
+	}
+
+	const int32 iPayloadStart = oReader.Tell();
+
+	if ( iPayloadSize < 0 || iPayloadStart + iPayloadSize != arFile.Num() ||
+		FCrc::MemCrc32( &arFile[ iPayloadStart ], iPayloadSize ) != iPayloadChecksum )
+	{
+		KUIWarnCW( GWorld, "Ignoring glyph metrics file %s: checksum mismatch", *strFileName );
+		return false;
+	}
+
+	int32 iFontCount = 0;
+	oReader << iFontCount;
+
+	TMap<FString, FKUIGlyphTable> mpTables;
+
+	for ( int32 iFont = 0; iFont < iFontCount && !oReader.IsError(); ++iFont )
+	{
+		FString strFontPath;
+		FKUIGlyphTable stTable;
+		int32 iCharCount = 0;
+
+		oReader << strFontPath;
+		oReader << stTable.iChecksum;
+		oReader << iCharCount;
+
+		// Each character is a code point and two floats.
+		if ( iCharCount < 0 || iCharCount > ( oReader.TotalSize() - oReader.Tell() ) / 12 )
+		{
+			oReader.SetError();
+			break;
+		}
+
+		stTable.arChars.SetNumUninitialized( iCharCount );
+		stTable.arSizes.SetNumUninitialized( iCharCount );
+
+		for ( int32 i = 0; i < iCharCount; ++i )
+		{
+			oReader << stTable.arChars[ i ];
+			oReader << stTable.arSizes[ i ].X;
+			oReader << stTable.arSizes[ i ].Y;
+		}
+
+		mpTables.Add( strFontPath, stTable );
+	}
+
+	if ( oReader.IsError() )
+	{
+		KUIWarnCW( GWorld, "Ignoring glyph metrics file %s: truncated", *strFileName );
+		return false;
+	}
+
+	GetLoadedTables() = mpTables;
+	GetNeedsSaving() = false;
+
+	// Fonts that are already in use get their tables straight away.
+	for ( TMap<TWeakObjectPtr<UFont>, TSharedPtr<FKUIGlyphMetrics>>::TIterator itFonts( GetFontMetrics() ); itFonts; ++itFonts )
+		if ( itFonts.Key().IsValid() )
+			ApplyLoadedTable( itFonts.Key().Get(), *itFonts.Value() );
+
+	return true;
+}
+
+
+bool FKUIGlyphMetricsCache::NeedsSaving()
+{
+	return GetNeedsSaving();
+}
+
+
+FString FKUIGlyphMetricsCache::GetDefaultFileName()
+{
+	return FPaths::GameSavedDir() / TEXT( "KeshUI" ) / TEXT( "GlyphMetrics.bin" );
+}
+
+
+uint32 FKUIGlyphMetricsCache::GetFontChecksum( UFont* foFont )
+{
+	if ( foFont == NULL )
+		return 0;
+
+	uint32 iChecksum = 0;
+	const uint8 iCacheType = static_cast<uint8>( foFont->FontCacheType );
+	const uint8 iRemapped = foFont->IsRemapped ? 1 : 0;
+
+	iChecksum = FCrc::MemCrc32( &iCacheType, sizeof( iCacheType ), iChecksum );
+	iChecksum = FCrc::MemCrc32( &iRemapped, sizeof( iRemapped ), iChecksum );
+	iChecksum = FCrc::MemCrc32( &foFont->Kerning, sizeof( foFont->Kerning ), iChecksum );
+	iChecksum = FCrc::MemCrc32( &foFont->ScalingFactor, sizeof( foFont->ScalingFactor ), iChecksum );
+
+	// Field by field, so padding never reaches the checksum.
+	for ( int32 i = 0; i < foFont->Characters.Num(); ++i )
+	{
+		const FFontCharacter& stCharacter = foFont->Characters[ i ];
+		const int32 arFields[ 6 ] = { stCharacter.StartU, stCharacter.StartV, stCharacter.USize, stCharacter.VSize, stCharacter.TextureIndex, stCharacter.VerticalOffset };
+
+		iChecksum = FCrc::MemCrc32( arFields, sizeof( arFields ), iChecksum );
+	}
+
+	for ( TMap<uint16, uint16>::TConstIterator itRemap( foFont->CharRemap ); itRemap; ++itRemap )
+	{
+		const uint16 arPair[ 2 ] = { itRemap.Key(), itRemap.Value() };
+
+		iChecksum = FCrc::MemCrc32( arPair, sizeof( arPair ), iChecksum );
+	}
+
+	return iChecksum;
+}
+
+
+bool& FKUIGlyphMetricsCache::GetNeedsSaving()
+{
+	static bool bNeedsSaving = false;
+
+	return bNeedsSaving;
+}
+
+
+TMap<FString, FKUIGlyphTable>& FKUIGlyphMetricsCache::GetLoadedTables()
+{
+	static TMap<FString, FKUIGlyphTable> mpLoadedTables;
+
+	return mpLoadedTables;
+}
+
+
+void FKUIGlyphMetricsCache::ApplyLoadedTable( UFont* foFont, FKUIGlyphMetrics& oMetrics )
+{
+	TMap<FString, FKUIGlyphTable>& mpLoadedTables = GetLoadedTables();
+
+	// Only offline fonts are saved, and there's nothing to look up if nothing was loaded.
+	if ( foFont->FontCacheType != EFontCacheType::Offline || mpLoadedTables.Num() == 0 )
+		return;
+
+	const FString strFontPath = foFont->GetPathName();
+	const FKUIGlyphTable* const stTable = mpLoadedTables.Find( strFontPath );
+
+	if ( stTable == NULL )
+	{
+		GetNeedsSaving() = true;
+		return;
+	}
+
+	if ( stTable->iChecksum != GetFontChecksum( foFont ) )
+	{
+		KUILogCW( GWorld, "Ignoring stale glyph metrics for %s", *strFontPath );
+		GetNeedsSaving() = true;
+	}
+
+	else
+	{
+		for ( int32 i = 0; i < stTable->arChars.Num(); ++i )
+			oMetrics.SetCharSize( stTable->arChars[ i ], stTable->arSizes[ i ] );
+	}
+}
+
+
+TMap<TWeakObjectPtr<UFont>, TSharedPtr<FKUIGlyphMetrics>>& FKUIGlyphMetricsCache::GetFontMetrics()
+{
+	static TMap<TWeakObjectPtr<UFont>, TSharedPtr<FKUIGlyphMetrics>> mpFontMetrics;
+
+	return mpFontMetrics;
+}
@@ -0,0 +1,110 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#define KUI_GLYPH_METRICS_PAGE_SIZE 256
+#define KUI_GLYPH_METRICS_BMP_PAGES 256
+#define KUI_GLYPH_METRICS_FILE_MAGIC 0x4B554947
+#define KUI_GLYPH_METRICS_FILE_VERSION 1
+
+class UFont;
+
+/* A font's character sizes as read from a glyph metrics file. */
+struct FKUIGlyphTable
+{
+	uint32 iChecksum;
+	TArray<uint32> arChars;
+	TArray<FVector2D> arSizes;
+};
+
+
+/**
+ * Unscaled character sizes for a single font.  Characters in the basic multilingual plane are stored
+ * in flat pages that are allocated as they are first used; anything above that goes in a map.
+ */
+class KESHUI_API FKUIGlyphMetrics
+{
+
+public:
+
+	FKUIGlyphMetrics( UFont* foFont );
+
+	/* Returns the unscaled advance and height of the character, measuring it the first time. */
+	const FVector2D& GetCharSize( TCHAR chChar );
+
+	/* Sets the size of a character without asking the font. */
+	void SetCharSize( uint32 iChar, const FVector2D& v2Size );
+
+	/* Measures every character an offline font has. */
+	void Precompute();
+
+	/* Fills the arrays with every character measured so far and its size. */
+	void GetMeasuredChars( TArray<uint32>& arChars, TArray<FVector2D>& arSizes ) const;
+
+	/* Forgets all measured characters. */
+	void Reset();
+
+protected:
+
+	TWeakObjectPtr<UFont> foFont;
+	TArray<TArray<FVector2D>> arPages;
+	TMap<uint32, FVector2D> mpSupplementary;
+
+	/* Asks the font for the size of the character. */
+	FVector2D MeasureChar( TCHAR chChar ) const;
+
+};
+
+
+/**
+ * Shared glyph metrics for every font used by text components.  The measured sizes can be saved to a
+ * file and loaded on the next run, so text is measured without asking the fonts.  Each font's table
+ * carries a checksum of the font's character data and is ignored if the font has changed since.
+ */
+class KESHUI_API FKUIGlyphMetricsCache
+{
+
+public:
+
+	/* Returns the metrics for the font, creating them if needed. */
+	static FKUIGlyphMetrics* Get( UFont* foFont );
+
+	/* Forgets the metrics for the font, or for every font if it is null. */
+	static void Invalidate( UFont* foFont = NULL );
+
+	/* Measures every character of the font up front. */
+	static void Precompute( UFont* foFont );
+
+	/* Writes the metrics of every cached offline font to the file.  Returns true on success. */
+	static bool SaveToFile( const FString& strFileName );
+
+	/**
+	 * Reads a file written by SaveToFile.  Tables are applied to fonts as they're first used.  The whole
+	 * file is rejected if it is corrupt or from another version.  Returns true on success.
+	 */
+	static bool LoadFromFile( const FString& strFileName );
+
+	/* Returns true if metrics have been measured that the last loaded file didn't have. */
+	static bool NeedsSaving();
+
+	/* Returns the file the interface loads metrics from at startup and saves them to if that fails. */
+	static FString GetDefaultFileName();
+
+	/* Returns a checksum of everything about the font that affects its character sizes. */
+	static uint32 GetFontChecksum( UFont* foFont );
+
+protected:
+
+	/* Returns the font to metrics map. */
+	static TMap<TWeakObjectPtr<UFont>, TSharedPtr<FKUIGlyphMetrics>>& GetFontMetrics();
+
+	/* Returns the flag behind NeedsSaving. */
+	static bool& GetNeedsSaving();
+
+	/* Returns the tables read from file, by font path. */
+	static TMap<FString, FKUIGlyphTable>& GetLoadedTables();
+
+	/* Fills the metrics from the font's loaded table, if there's one and it matches the font. */
+	static void ApplyLoadedTable( UFont* foFont, FKUIGlyphMetrics& oMetrics );
+
+};
@@ -0,0 +1,217 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIInterfaceElement.h"
+#include "KeshUI/KUIHitTestGrid.h"
+
+
+FKUIHitTestGrid::FKUIHitTestGrid()
+{
+	arEntries.SetNum( 0 );
+	arPendingEntries.SetNum( 0 );
+	arCells.SetNum( 0 );
+	v2ScreenSize = FVector2D::ZeroVector;
+	iColumns = 0;
+	iRows = 0;
+	iRebuildCount = 0;
+	bRecording = false;
+	bPendingChanged = false;
+}
+
+
+void FKUIHitTestGrid::BeginFrame( const FVector2D& v2ScreenSize )
+{
+	const int32 iNewColumns = FMath::CeilToInt( v2ScreenSize.X / KUI_HIT_TEST_CELL_SIZE );
+	const int32 iNewRows = FMath::CeilToInt( v2ScreenSize.Y / KUI_HIT_TEST_CELL_SIZE );
+
+	bPendingChanged = ( iNewColumns != iColumns || iNewRows != iRows );
+
+	this->v2ScreenSize = v2ScreenSize;
+	iColumns = iNewColumns;
+	iRows = iNewRows;
+
+	arPendingEntries.Reset();
+	bRecording = true;
+}
+
+
+void FKUIHitTestGrid::AddEntry( UKUIInterfaceElement* oElement, const FVector2D& v2Min, const FVector2D& v2Max )
+{
+	if ( !bRecording )
+		return;
+
+	const int32 iIndex = arPendingEntries.Num();
+
+	FKUIHitTestEntry stEntry;
+	stEntry.oElement = oElement;
+	stEntry.v2Min = v2Min;
+	stEntry.v2Max = v2Max;
+	arPendingEntries.Add( stEntry );
+
+	if ( bPendingChanged )
+		return;
+
+	if ( !arEntries.IsValidIndex( iIndex ) )
+	{
+		bPendingChanged = true;
+		return;
+	}
+
+	const FKUIHitTestEntry& stOldEntry = arEntries[ iIndex ];
+
+	if ( stOldEntry.oElement.Get() != oElement || stOldEntry.v2Min != v2Min || stOldEntry.v2Max != v2Max )
+		bPendingChanged = true;
+}
+
+
+void FKUIHitTestGrid::EndFrame()
+{
+	if ( !bRecording )
+		return;
+
+	bRecording = false;
+
+	if ( arPendingEntries.Num() != arEntries.Num() )
+		bPendingChanged = true;
+
+	if ( !bPendingChanged )
+		return;
+
+	Exchange( arEntries, arPendingEntries );
+	RebuildCells();
+}
+
+
+bool FKUIHitTestGrid::IsRecording() const
+{
+	return bRecording;
+}
+
+
+void FKUIHitTestGrid::RebuildCells()
+{
+	++iRebuildCount;
+
+	const int32 iCellCount = iColumns * iRows;
+
+	// Keep the per-cell allocations around between rebuilds.
+	if ( arCells.Num() != iCellCount )
+		arCells.SetNum( iCellCount );
+
+	for ( int32 i = 0; i < arCells.Num(); ++i )
+		arCells[ i ].Reset();
+
+	if ( iCellCount == 0 )
+		return;
+
+	for ( int32 i = 0; i < arEntries.Num(); ++i )
+	{
+		const FKUIHitTestEntry& stEntry = arEntries[ i ];
+
+		if ( stEntry.v2Max.X <= stEntry.v2Min.X || stEntry.v2Max.Y <= stEntry.v2Min.Y )
+			continue;
+
+		const int32 iMinColumn = clamp( floor( stEntry.v2Min.X / KUI_HIT_TEST_CELL_SIZE ), 0, iColumns - 1 );
+		const int32 iMinRow = clamp( floor( stEntry.v2Min.Y / KUI_HIT_TEST_CELL_SIZE ), 0, iRows - 1 );
+		const int32 iMaxColumn = clamp( floor( ( stEntry.v2Max.X - 1.f ) / KUI_HIT_TEST_CELL_SIZE ), 0, iColumns - 1 );
+		const int32 iMaxRow = clamp( floor( ( stEntry.v2Max.Y - 1.f ) / KUI_HIT_TEST_CELL_SIZE ), 0, iRows - 1 );
+
+		for ( int32 iRow = iMinRow; iRow <= iMaxRow; ++iRow )
+			for ( int32 iColumn = iMinColumn; iColumn <= iMaxColumn; ++iColumn )
+				arCells[ iRow * iColumns + iColumn ].Add( i );
+	}
+}
+
+
+int32 FKUIHitTestGrid::GetCellIndex( const FVector2D& v2Point ) const
+{
+	if ( v2Point.X < 0.f || v2Point.Y < 0.f )
+		return INDEX_NONE;
+
+	const int32 iColumn = floor( v2Point.X / KUI_HIT_TEST_CELL_SIZE );
+	const int32 iRow = floor( v2Point.Y / KUI_HIT_TEST_CELL_SIZE );
+
+	if ( iColumn >= iColumns || iRow >= iRows )
+		return INDEX_NONE;
+
+	return iRow * iColumns + iColumn;
+}
+
+
+bool FKUIHitTestGrid::EntryContains( const FKUIHitTestEntry& stEntry, const FVector2D& v2Point )
+{
+	if ( v2Point.X < stEntry.v2Min.X || v2Point.Y < stEntry.v2Min.Y )
+		return false;
+
+	if ( v2Point.X >= stEntry.v2Max.X || v2Point.Y >= stEntry.v2Max.Y )
+		return false;
+
+	return true;
+}
+
+
+UKUIInterfaceElement* FKUIHitTestGrid::GetTopmostElementAt( const FVector2D& v2Point ) const
+{
+	const int32 iCellIndex = GetCellIndex( v2Point );
+
+	if ( !arCells.IsValidIndex( iCellIndex ) )
+		return NULL;
+
+	const TArray<int32>& arCell = arCells[ iCellIndex ];
+
+	// Cells hold entries in render order, so search from the back.
+	for ( int32 i = arCell.Num() - 1; i >= 0; --i )
+	{
+		const FKUIHitTestEntry& stEntry = arEntries[ arCell[ i ] ];
+
+		if ( !EntryContains( stEntry, v2Point ) )
+			continue;
+
+		UKUIInterfaceElement* const oElement = stEntry.oElement.Get();
+
+		if ( oElement == NULL )
+			continue;
+
+		return oElement;
+	}
+
+	return NULL;
+}
+
+
+void FKUIHitTestGrid::GetElementsAt( const FVector2D& v2Point, TArray<UKUIInterfaceElement*>& arElements ) const
+{
+	const int32 iCellIndex = GetCellIndex( v2Point );
+
+	if ( !arCells.IsValidIndex( iCellIndex ) )
+		return;
+
+	const TArray<int32>& arCell = arCells[ iCellIndex ];
+
+	for ( int32 i = arCell.Num() - 1; i >= 0; --i )
+	{
+		const FKUIHitTestEntry& stEntry = arEntries[ arCell[ i ] ];
+
+		if ( !EntryContains( stEntry, v2Point ) )
+			continue;
+
+		UKUIInterfaceElement* const oElement = stEntry.oElement.Get();
+
+		if ( oElement == NULL )
+			continue;
+
+		arElements.Add( oElement );
+	}
+}
+
+
+int32 FKUIHitTestGrid::GetEntryCount() const
+{
+	return arEntries.Num();
+}
+
+
+int32 FKUIHitTestGrid::GetRebuildCount() const
+{
+	return iRebuildCount;
+}
@@ -0,0 +1,75 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+class UKUIInterfaceElement;
+
+#define KUI_HIT_TEST_CELL_SIZE 64.f
+
+/* The clipped screen rect of a rendered element. */
+struct FKUIHitTestEntry
+{
+	TWeakObjectPtr<UKUIInterfaceElement> oElement;
+	FVector2D v2Min;
+	FVector2D v2Max;
+};
+
+/**
+ * Uniform grid over the clipped screen rects of the elements that take mouse input, as rendered in the last
+ * frame.  Entries are recorded in render order (which follows each container's z-sorted children), so the
+ * last entry that contains a point is the topmost.  The cells are only rebuilt when the recorded entries
+ * differ from the previous frame.
+ */
+class KESHUI_API FKUIHitTestGrid
+{
+
+public:
+
+	FKUIHitTestGrid();
+
+	/* Starts recording the entries for a new frame. */
+	void BeginFrame( const FVector2D& v2ScreenSize );
+
+	/* Records an element's clipped screen rect.  Must be called in render order. */
+	void AddEntry( UKUIInterfaceElement* oElement, const FVector2D& v2Min, const FVector2D& v2Max );
+
+	/* Stops recording and rebuilds the cells if anything changed. */
+	void EndFrame();
+
+	/* Returns true between BeginFrame and EndFrame. */
+	bool IsRecording() const;
+
+	/* Returns the topmost element whose clipped rect contains the point. */
+	UKUIInterfaceElement* GetTopmostElementAt( const FVector2D& v2Point ) const;
+
+	/* Adds every element whose clipped rect contains the point, topmost first. */
+	void GetElementsAt( const FVector2D& v2Point, TArray<UKUIInterfaceElement*>& arElements ) const;
+
+	/* Returns the number of elements in the grid. */
+	int32 GetEntryCount() const;
+
+	/* Returns the number of times the cells have been rebuilt. */
+	int32 GetRebuildCount() const;
+
+protected:
+
+	TArray<FKUIHitTestEntry> arEntries;
+	TArray<FKUIHitTestEntry> arPendingEntries;
+	TArray<TArray<int32>> arCells;
+	FVector2D v2ScreenSize;
+	int32 iColumns;
+	int32 iRows;
+	int32 iRebuildCount;
+	bool bRecording;
+	bool bPendingChanged;
+
+	/* Puts each entry into the cells it overlaps. */
+	void RebuildCells();
+
+	/* Returns the cell index for a point, or INDEX_NONE if it is off the grid. */
+	int32 GetCellIndex( const FVector2D& v2Point ) const;
+
+	/* Returns true if the entry's rect contains the point. */
+	static bool EntryContains( const FKUIHitTestEntry& stEntry, const FVector2D& v2Point );
+
+};
@@ -7,9 +7,11 @@
 #include "KeshUI/Container/KUIRootContainer.h"
 #include "KeshUI/Container/KUITooltipContainer.h"
 #include "KeshUI/Container/KUICursorContainer.h"
+#include "KeshUI/Container/KUISubContainer.h"
 #include "KeshUI/Component/KUIBoxInterfaceComponent.h"
 #include "KeshUI/KUICancellable.h"
 #include "KeshUI/KUIAssetLibrary.h"
+#include "KeshUI/KUIGlyphMetricsCache.h"
 #include "KeshUI/Game/KUIGameInstance.h"
 #include "KeshUI/KUIInterface.h"
 
@@ -29,11 +31,22 @@ AKUIInterface::AKUIInterface( const class FObjectInitializer& oObjectInitializer
 	bVisible = true;
 	bCursorVisible = true;
 	v2ScreenResolution = FVector2D::ZeroVector;
+	v2PendingResolution = FVector2D::ZeroVector;
+	bPendingResolutionChange = false;
 	v2CursorLocation = FVector2D( KUI_INTERFACE_FIRST_CURSOR_UPDATE, 0.f );
 	v2CursorVector = FVector2D::ZeroVector;
 	arCancellables.SetNum( 0 );
 	ctFocused = NULL;
 	bHardwareCursorPosition = false;
+	arEventSubscribers.Init( 0, KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT );
+	iHitTestFrame = 0;
+	arMouseOverTargets.SetNum( 0 );
+	arMouseCaptureTargets.SetNum( 0 );
+	arLayoutQueue.SetNum( 0 );
+	iLayoutMeasured = 0;
+	iLayoutArranged = 0;
+	iBatchUpdateDepth = 0;
+	mpBatchUpdates.Empty();
 
 	ctRootContainers.SetNum( 4 );
 
@@ -49,6 +62,9 @@ AKUIInterface::AKUIInterface( const class FObjectInitializer& oObjectInitializer
 	KUICreateDefaultSubobjectAssign( ctRootContainers[ EKUIInterfaceRoot::R_Cursor ], UKUICursorContainer, "Cursor Container" );
 	ctRootContainers[ EKUIInterfaceRoot::R_Cursor ]->SetInterface( this );
 
+	KUICreateDefaultSubobjectAssign( oRenderTargetPool, UKUIRenderTargetPool, "Render Target Pool" );
+	KUICreateDefaultSubobjectAssign( oTextAtlas, UKUITextAtlas, "Text Atlas" );
+
 	arMouseButtonDownLocations.SetNum( 3 );
 	arMouseButtonDownLocations[ EMouseButtons::Left ] = FVector2D::ZeroVector;
 	arMouseButtonDownLocations[ EMouseButtons::Right ] = FVector2D::ZeroVector;
@@ -121,6 +137,18 @@ FVector2D AKUIInterface::GetScreenResolution() const
 }
 
 
+void AKUIInterface::SetScreenResolution( const FVector2D& v2Resolution )
+{
+	bPendingResolutionChange = false;
+
+	if ( !v2ScreenResolution.Equals( v2Resolution, 0.5f ) )
+		OnScreenResolutionChange( v2ScreenResolution, v2Resolution );
+
+	if ( this->v2CursorLocation.X == KUI_INTERFACE_FIRST_CURSOR_UPDATE )
+		this->v2CursorLocation = FVector2D( floor( this->v2ScreenResolution.X / 2.f ), floor( this->v2ScreenResolution.Y / 2.f ) );
+}
+
+
 FVector2D AKUIInterface::GetCursorLocation() const
 {
 	return AKUIInterface::v2CursorLocation;
@@ -230,6 +258,8 @@ void AKUIInterface::SetFocus( UKUIInterfaceContainer* ctNewFocus )
 
 void AKUIInterface::Tick( float fDeltaTime )
 {
+	SCOPE_CYCLE_COUNTER( STAT_KUITick );
+
 	FKUIInterfaceContainerTickEvent stEventInfo( EKUIInterfaceContainerEventList::E_Tick, fDeltaTime );
 	BroadcastEvent( stEventInfo );
 	
@@ -251,16 +281,15 @@ void AKUIInterface::Render( UCanvas* oCanvas )
 	if ( !bShowHUD )
 		return;
 
+	SCOPE_CYCLE_COUNTER( STAT_KUIRender );
+
 	if ( GEngine != NULL && GEngine->GameViewport != NULL )
 	{	
 		// Update the screen res.
-		FVector2D v2ScreenResolution = FVector2D::ZeroVector;
-		GEngine->GameViewport->GetViewportSize( v2ScreenResolution );
-
-		if ( !this->v2ScreenResolution.Equals( v2ScreenResolution, 0.5f ) )
-			OnScreenResolutionChange( this->v2ScreenResolution, v2ScreenResolution );
+		FVector2D v2ViewportSize = FVector2D::ZeroVector;
+		GEngine->GameViewport->GetViewportSize( v2ViewportSize );
 
-		this->v2ScreenResolution = v2ScreenResolution;
+		UpdateScreenResolution( v2ViewportSize );
 
 		if ( this->v2CursorLocation.X == KUI_INTERFACE_FIRST_CURSOR_UPDATE )
 			this->v2CursorLocation = FVector2D( floor( this->v2ScreenResolution.X / 2.f ), floor( this->v2ScreenResolution.Y / 2.f ) );
@@ -275,6 +304,16 @@ void AKUIInterface::Render( UCanvas* oCanvas )
 	v2DebugMouseOverSize = FVector2D::ZeroVector;
 #endif // KUI_INTERFACE_MOUSEOVER_DEBUG
 
+	UpdateLayout();
+
+	// Elements record their clipped screen rects as they're rendered.  The ones that take mouse input go into the grid.
+	++iHitTestFrame;
+
+	if ( iHitTestFrame == 0 )
+		++iHitTestFrame;
+
+	oHitTestGrid.BeginFrame( this->v2ScreenResolution );
+
 	if ( IsVisible() )
 	{
 		for ( int32 i = 0; i < ctRootContainers.Num(); ++i )
@@ -292,6 +331,9 @@ void AKUIInterface::Render( UCanvas* oCanvas )
 		}
 	}
 
+	// The cursor is drawn relative to the cursor location, so it isn't hit tested.
+	oHitTestGrid.EndFrame();
+
 	if ( IsCursorVisible() )
 	{
 #if KUI_INTERFACE_MOUSEOVER_DEBUG
@@ -325,6 +367,10 @@ void AKUIInterface::Render( UCanvas* oCanvas )
 
 	cmDebugMouseOverLastTick = cmDebugMouseOver.Get();
 #endif // KUI_INTERFACE_MOUSEOVER_DEBUG
+
+	FKUIRenderBackend::Get( this ).FlushText();
+
+	ApplyPendingScreenResolution();
 }
 
 
@@ -472,6 +518,12 @@ UObject** AKUIInterface::GetAsset( const FName& nName ) const
 
 void AKUIInterface::BroadcastEvent( FKUIInterfaceEvent& stEventInfo, bool bTopDown, bool bIncludeCursor )
 {
+	SCOPE_CYCLE_COUNTER( STAT_KUIBroadcastEvent );
+
+	// Nothing has subscribed to this event, so don't bother walking the tree.
+	if ( UKUIInterfaceContainer::IsSubscriptionEvent( stEventInfo.iEventID ) && GetEventSubscribers( stEventInfo.iEventID ) == 0 )
+		return;
+
 	if ( !bTopDown )
 	{
 		for ( int32 i = 0; i < ctRootContainers.Num(); ++i )
@@ -502,6 +554,349 @@ void AKUIInterface::BroadcastEvent( FKUIInterfaceEvent& stEventInfo, bool bTopDo
 }
 
 
+int32 AKUIInterface::GetEventSubscribers( uint8 iEventID ) const
+{
+	const int32 iIndex = UKUIInterfaceContainer::GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+		return 0;
+
+	return arEventSubscribers[ iIndex ];
+}
+
+
+void AKUIInterface::AddEventSubscribers( uint8 iEventID, int32 iCount )
+{
+	const int32 iIndex = UKUIInterfaceContainer::GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+		return;
+
+	arEventSubscribers[ iIndex ] += iCount;
+}
+
+
+void AKUIInterface::RemoveEventSubscribers( uint8 iEventID, int32 iCount )
+{
+	const int32 iIndex = UKUIInterfaceContainer::GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+		return;
+
+	arEventSubscribers[ iIndex ] -= iCount;
+}
+
+
+UKUIInterfaceElement* AKUIInterface::GetElementAtPoint( const FVector2D& v2Point ) const
+{
+	return oHitTestGrid.GetTopmostElementAt( v2Point );
+}
+
+
+UKUIInterfaceElement* AKUIInterface::GetElementUnderCursor() const
+{
+	return GetElementAtPoint( GetCursorLocation() );
+}
+
+
+bool AKUIInterface::IsRecordingHitTest() const
+{
+	return oHitTestGrid.IsRecording();
+}
+
+
+uint32 AKUIInterface::GetHitTestFrame() const
+{
+	return iHitTestFrame;
+}
+
+
+void AKUIInterface::AddHitTestEntry( UKUIInterfaceElement* oElement, const FVector2D& v2Min, const FVector2D& v2Max )
+{
+	oHitTestGrid.AddEntry( oElement, v2Min, v2Max );
+}
+
+
+const FKUIHitTestGrid& AKUIInterface::GetHitTestGrid() const
+{
+	return oHitTestGrid;
+}
+
+
+void AKUIInterface::GetMouseTargetsAt( const FVector2D& v2Location, TArray<UKUIInterfaceContainer*>& arTargets ) const
+{
+	static TArray<UKUIInterfaceElement*> arElements;
+
+	arElements.Reset();
+	oHitTestGrid.GetElementsAt( v2Location, arElements );
+
+	for ( int32 i = 0; i < arElements.Num(); ++i )
+	{
+		// Only containers that take mouse input are added to the grid.
+		UKUIInterfaceContainer* const ctTarget = static_cast<UKUIInterfaceContainer*>( arElements[ i ] );
+
+		if ( !ctTarget->RespondsToEvent( EKUIInterfaceContainerEventList::E_MouseMove ) )
+			continue;
+
+		arTargets.AddUnique( ctTarget );
+	}
+}
+
+
+void AKUIInterface::SendMouseButtonEvent( UKUIInterfaceContainer* ctTarget, FKUIInterfaceContainerMouseButtonEvent& stEventInfo )
+{
+	// Sub containers move the location by their corner offset as they pass button events to their children.
+	FVector2D v2Location = stEventInfo.v2Location;
+
+	for ( UKUIInterfaceContainer* ctContainer = ctTarget->GetContainer(); ctContainer != NULL; ctContainer = ctContainer->GetContainer() )
+	{
+		UKUISubContainer* const ctSubContainer = Cast<UKUISubContainer>( ctContainer );
+
+		if ( ctSubContainer != NULL )
+			v2Location -= ctSubContainer->GetCornerOffset();
+	}
+
+	FKUIInterfaceContainerMouseButtonEvent stTargetEventInfo( stEventInfo.iEventID, stEventInfo.bHandled, stEventInfo.eButton, v2Location );
+	ctTarget->SendEvent( stTargetEventInfo );
+
+	stEventInfo.bHandled = stTargetEventInfo.bHandled;
+}
+
+
+/* A container in the layout pass and how deep it is in the tree. */
+struct FKUILayoutPassEntry
+{
+	UKUIInterfaceContainer* ctContainer;
+	int32 iDepth;
+
+	FKUILayoutPassEntry( UKUIInterfaceContainer* ctContainer )
+	{
+		this->ctContainer = ctContainer;
+		iDepth = 0;
+
+		for ( UKUIInterfaceContainer* ctParent = ctContainer->GetContainer(); ctParent != NULL; ctParent = ctParent->GetContainer() )
+			++iDepth;
+	}
+};
+
+
+/* Deepest first, for measuring. */
+struct FKUILayoutPassDeepestFirst
+{
+	bool operator()( const FKUILayoutPassEntry& stA, const FKUILayoutPassEntry& stB ) const
+	{
+		return stA.iDepth > stB.iDepth;
+	}
+};
+
+
+/* Shallowest first, for arranging. */
+struct FKUILayoutPassShallowestFirst
+{
+	bool operator()( const FKUILayoutPassEntry& stA, const FKUILayoutPassEntry& stB ) const
+	{
+		return stA.iDepth < stB.iDepth;
+	}
+};
+
+
+void AKUIInterface::QueueLayout( UKUIInterfaceContainer* ctContainer )
+{
+	if ( ctContainer == NULL || ctContainer->IsLayoutQueued() )
+		return;
+
+	ctContainer->SetLayoutQueued( true );
+	arLayoutQueue.Add( ctContainer );
+}
+
+
+void AKUIInterface::UpdateLayout()
+{
+	iLayoutMeasured = 0;
+	iLayoutArranged = 0;
+
+	if ( arLayoutQueue.Num() == 0 )
+		return;
+
+	SCOPE_CYCLE_COUNTER( STAT_KUILayout );
+
+	TArray<FKUILayoutPassEntry> arHeap;
+	TArray<FKUILayoutPassEntry> arMeasured;
+
+	// Containers stay marked as queued until the pass is over, so however many times they're invalidated
+	// while it runs, each is only measured and arranged once.  Measuring can resize a container, which
+	// queues its parent; that's picked up here and measured after its children.
+	while ( arLayoutQueue.Num() > 0 || arHeap.Num() > 0 )
+	{
+		for ( int32 i = 0; i < arLayoutQueue.Num(); ++i )
+			if ( arLayoutQueue[ i ].IsValid() )
+				arHeap.HeapPush( FKUILayoutPassEntry( arLayoutQueue[ i ].Get() ), FKUILayoutPassDeepestFirst() );
+
+		arLayoutQueue.Reset();
+
+		if ( arHeap.Num() == 0 )
+			break;
+
+		FKUILayoutPassEntry stEntry( arHeap.HeapTop() );
+		arHeap.HeapPop( stEntry, FKUILayoutPassDeepestFirst() );
+
+		arMeasured.Add( stEntry );
+
+		if ( stEntry.ctContainer->HasValidLayout() )
+			continue;
+
+		stEntry.ctContainer->MeasureLayout();
+		++iLayoutMeasured;
+		INC_DWORD_STAT( STAT_KUILayoutMeasured );
+	}
+
+	arMeasured.StableSort( FKUILayoutPassShallowestFirst() );
+
+	for ( int32 i = 0; i < arMeasured.Num(); ++i )
+	{
+		if ( arMeasured[ i ].ctContainer->HasValidLayout() )
+			continue;
+
+		arMeasured[ i ].ctContainer->ValidateLayout();
+		++iLayoutArranged;
+	}
+
+	// Anything invalidated while arranging is left to the next pass, or to the container's render.
+	for ( int32 i = 0; i < arMeasured.Num(); ++i )
+	{
+		arMeasured[ i ].ctContainer->SetLayoutQueued( false );
+
+		if ( !arMeasured[ i ].ctContainer->HasValidLayout() )
+			QueueLayout( arMeasured[ i ].ctContainer );
+	}
+}
+
+
+void AKUIInterface::GetLayoutStats( int32& iMeasured, int32& iArranged ) const
+{
+	iMeasured = iLayoutMeasured;
+	iArranged = iLayoutArranged;
+}
+
+
+void AKUIInterface::BeginBatchUpdate()
+{
+	++iBatchUpdateDepth;
+}
+
+
+void AKUIInterface::EndBatchUpdate()
+{
+	if ( iBatchUpdateDepth <= 0 )
+	{
+		KUIErrorUO( "Ending a batch update that was never started" );
+		return;
+	}
+
+	--iBatchUpdateDepth;
+
+	if ( iBatchUpdateDepth == 0 )
+		FlushBatchUpdate();
+}
+
+
+bool AKUIInterface::IsBatchUpdating() const
+{
+	return ( iBatchUpdateDepth > 0 );
+}
+
+
+bool AKUIInterface::DeferBatchUpdate( UKUIInterfaceElement* oElement, uint8 iUpdate )
+{
+	if ( !IsBatchUpdating() || oElement == NULL || oElement->IsTemplate() )
+		return false;
+
+	uint8& iUpdates = mpBatchUpdates.FindOrAdd( oElement );
+
+	if ( ( iUpdates & iUpdate ) == iUpdate )
+		INC_DWORD_STAT( STAT_KUIBatchUpdatesCoalesced );
+
+	iUpdates |= iUpdate;
+	return true;
+}
+
+
+void AKUIInterface::FlushBatchUpdate()
+{
+	if ( mpBatchUpdates.Num() == 0 )
+		return;
+
+	SCOPE_CYCLE_COUNTER( STAT_KUIBatchUpdateFlush );
+
+	// Anything the handlers below change goes through straight away.
+	TMap<TWeakObjectPtr<UKUIInterfaceElement>, uint8> mpUpdates;
+	Exchange( mpUpdates, mpBatchUpdates );
+
+	for ( auto It = mpUpdates.CreateConstIterator(); It; ++It )
+		if ( It.Key().IsValid() && ( It.Value() & EKUIBatchUpdate::B_AlignLocation ) )
+			It.Key()->InvalidateAlignLocation();
+
+	for ( auto It = mpUpdates.CreateConstIterator(); It; ++It )
+	{
+		if ( !It.Key().IsValid() || It.Key()->GetContainer() == NULL )
+			continue;
+
+		if ( It.Value() & EKUIBatchUpdate::B_ChildLocationChange )
+		{
+			KUISendEventObj( FKUIInterfaceContainerElementEvent, It.Key()->GetContainer(), EKUIInterfaceContainerEventList::E_ChildLocationChange, It.Key().Get() );
+		}
+
+		if ( It.Value() & EKUIBatchUpdate::B_ChildSizeChange )
+		{
+			KUISendEventObj( FKUIInterfaceContainerElementEvent, It.Key()->GetContainer(), EKUIInterfaceContainerEventList::E_ChildSizeChange, It.Key().Get() );
+		}
+	}
+
+	// Invalidating an element's own cache invalidates its container's too.
+	for ( auto It = mpUpdates.CreateConstIterator(); It; ++It )
+	{
+		if ( !It.Key().IsValid() )
+			continue;
+
+		if ( It.Value() & EKUIBatchUpdate::B_RenderCache )
+			It.Key()->InvalidateRenderCache();
+
+		else if ( It.Value() & EKUIBatchUpdate::B_ContainerRenderCache )
+			It.Key()->InvalidateContainerRenderCache();
+	}
+}
+
+
+UKUIRenderTargetPool* AKUIInterface::GetRenderTargetPool() const
+{
+	return oRenderTargetPool;
+}
+
+
+FKUITextMeasureCache& AKUIInterface::GetTextMeasureCache()
+{
+	return oTextMeasureCache;
+}
+
+
+UKUITextAtlas* AKUIInterface::GetTextAtlas() const
+{
+	return oTextAtlas;
+}
+
+
+FKUIRenderBackend* AKUIInterface::GetRenderBackend() const
+{
+	return stRenderBackend.Get();
+}
+
+
+void AKUIInterface::SetRenderBackend( TSharedPtr<FKUIRenderBackend> stRenderBackend )
+{
+	this->stRenderBackend = stRenderBackend;
+}
+
+
 void AKUIInterface::OnMouseMove( const FVector2D& v2OldLocation, const FVector2D& v2NewLocation )
 {
 	FVector2D v2NewLocationActual = v2NewLocation;
@@ -531,7 +926,42 @@ void AKUIInterface::OnMouseMove( const FVector2D& v2OldLocation, const FVector2D
 
 	this->v2CursorLocation = v2NewLocationActual;
 
-	KUIBroadcastSubEvent( FKUIInterfaceContainerMouseLocationEvent, EKUIInterfaceContainerEventList::E_MouseMove, v2OldLocation, v2NewLocationActual );
+	{
+		SCOPE_CYCLE_COUNTER( STAT_KUIMouseDispatch );
+
+		// Only the containers under the cursor hear about the move, plus the ones it has just left and any being dragged.
+		TArray<UKUIInterfaceContainer*> arTargets;
+		GetMouseTargetsAt( v2NewLocationActual, arTargets );
+
+		const int32 iMouseOverCount = arTargets.Num();
+
+		for ( int32 i = 0; i < arMouseOverTargets.Num(); ++i )
+		{
+			if ( arMouseOverTargets[ i ].IsValid() )
+				arTargets.AddUnique( arMouseOverTargets[ i ].Get() );
+		}
+
+		for ( int32 i = 0; i < arMouseCaptureTargets.Num(); ++i )
+		{
+			if ( arMouseCaptureTargets[ i ].IsValid() )
+				arTargets.AddUnique( arMouseCaptureTargets[ i ].Get() );
+		}
+
+		arMouseOverTargets.SetNum( iMouseOverCount );
+
+		for ( int32 i = 0; i < iMouseOverCount; ++i )
+			arMouseOverTargets[ i ] = arTargets[ i ];
+
+		INC_DWORD_STAT_BY( STAT_KUIMouseTargets, arTargets.Num() );
+
+		FKUIInterfaceContainerMouseLocationEvent stEventInfo( EKUIInterfaceContainerEventList::E_MouseMove, v2OldLocation, v2NewLocationActual );
+
+		for ( int32 i = 0; i < arTargets.Num(); ++i )
+		{
+			if ( arTargets[ i ]->RespondsToEvent( stEventInfo.iEventID ) )
+				arTargets[ i ]->SendEvent( stEventInfo );
+		}
+	}
 
 	if ( !IsTemplate() )
 		OnMouseMoveBP( v2OldLocation, v2NewLocationActual );
@@ -553,7 +983,23 @@ bool AKUIInterface::OnMouseButtonDown( EMouseButtons::Type eButton, const FVecto
 			return true;
 	}
 
-	BroadcastEvent( stEventInfo, true );
+	{
+		SCOPE_CYCLE_COUNTER( STAT_KUIMouseDispatch );
+
+		// The containers under the press, topmost first.  They also get the release, wherever it happens.
+		TArray<UKUIInterfaceContainer*> arTargets;
+		GetMouseTargetsAt( v2Location, arTargets );
+
+		arMouseCaptureTargets.SetNum( arTargets.Num() );
+
+		for ( int32 i = 0; i < arTargets.Num(); ++i )
+			arMouseCaptureTargets[ i ] = arTargets[ i ];
+
+		INC_DWORD_STAT_BY( STAT_KUIMouseTargets, arTargets.Num() );
+
+		for ( int32 i = 0; i < arTargets.Num(); ++i )
+			SendMouseButtonEvent( arTargets[ i ], stEventInfo );
+	}
 
 	if ( !IsTemplate() )
 		OnMouseButtonDownBP( eButton, v2Location );
@@ -574,7 +1020,26 @@ bool AKUIInterface::OnMouseButtonUp( EMouseButtons::Type eButton, const FVector2
 			return true;
 	}
 
-	BroadcastEvent( stEventInfo, true );
+	{
+		SCOPE_CYCLE_COUNTER( STAT_KUIMouseDispatch );
+
+		// The containers that got the press go first, so they can finish clicks and drags.
+		TArray<UKUIInterfaceContainer*> arTargets;
+
+		for ( int32 i = 0; i < arMouseCaptureTargets.Num(); ++i )
+		{
+			if ( arMouseCaptureTargets[ i ].IsValid() && arMouseCaptureTargets[ i ]->RespondsToEvent( stEventInfo.iEventID ) )
+				arTargets.AddUnique( arMouseCaptureTargets[ i ].Get() );
+		}
+
+		arMouseCaptureTargets.SetNum( 0 );
+		GetMouseTargetsAt( v2Location, arTargets );
+
+		INC_DWORD_STAT_BY( STAT_KUIMouseTargets, arTargets.Num() );
+
+		for ( int32 i = 0; i < arTargets.Num(); ++i )
+			SendMouseButtonEvent( arTargets[ i ], stEventInfo );
+	}
 
 	if ( !IsTemplate() )
 		OnMouseButtonUpBP( eButton, v2Location );
@@ -667,6 +1132,42 @@ bool AKUIInterface::OnKeyChar( TCHAR chChar )
 }
 
 
+void AKUIInterface::UpdateScreenResolution( const FVector2D& v2ViewportSize )
+{
+	if ( v2ScreenResolution.Equals( v2ViewportSize, 0.5f ) )
+	{
+		bPendingResolutionChange = false;
+		return;
+	}
+
+	// The first resolution is applied straight away, so there's something to draw.
+	if ( v2ScreenResolution.IsZero() )
+	{
+		bPendingResolutionChange = false;
+		OnScreenResolutionChange( v2ScreenResolution, v2ViewportSize );
+		return;
+	}
+
+	// Dragging the window edge changes the size many times, so only the last one is kept.
+	v2PendingResolution = v2ViewportSize;
+	bPendingResolutionChange = true;
+}
+
+
+void AKUIInterface::ApplyPendingScreenResolution()
+{
+	if ( !bPendingResolutionChange )
+		return;
+
+	bPendingResolutionChange = false;
+
+	if ( v2ScreenResolution.Equals( v2PendingResolution, 0.5f ) )
+		return;
+
+	OnScreenResolutionChange( v2ScreenResolution, v2PendingResolution );
+}
+
+
 void AKUIInterface::OnScreenResolutionChange( const FVector2D& v2OldRes, const FVector2D& v2NewRes )
 {
 	v2ScreenResolution = v2NewRes;
@@ -756,10 +1257,23 @@ void AKUIInterface::PostInitializeComponents()
 	AddElement( EKUIInterfaceRoot::R_Root, cmDebugMouseOverTestBox );
 #endif // KUI_INTERFACE_MOUSEOVER_DEBUG
 
+	// Measure text from last run's tables, if there are any, before the interface is built.
+	FKUIGlyphMetricsCache::LoadFromFile( FKUIGlyphMetricsCache::GetDefaultFileName() );
+
 	KUIBroadcastEvent( FKUIInterfaceEvent, EKUIInterfaceElementEventList::E_Initialize );
 }
 
 
+void AKUIInterface::EndPlay( const EEndPlayReason::Type eEndPlayReason )
+{
+	// Save the tables on the first run, or if fonts have been added or changed since they were saved.
+	if ( FKUIGlyphMetricsCache::NeedsSaving() )
+		FKUIGlyphMetricsCache::SaveToFile( FKUIGlyphMetricsCache::GetDefaultFileName() );
+
+	Super::EndPlay( eEndPlayReason );
+}
+
+
 void AKUIInterface::OnMatchStateChange( FName nMatchState )
 {
 	KUIBroadcastEvent( FKUIInterfaceContainerMatchStateEvent, EKUIInterfaceContainerEventList::E_MatchStateChange, nMatchState );
@@ -3,6 +3,7 @@
 #include "KeshUI/KeshUI.h"
 #include "KeshUI/KUIInterface.h"
 #include "KeshUI/KUIInterfaceWidgetChildManager.h"
+#include "KeshUI/KUIRenderCache.h"
 #include "KeshUI/KUIInterfaceContainer.h"
 #include "KeshUI/KUIInterfaceWidget.h"
 #define _XTGMATH
@@ -15,11 +16,20 @@ UKUIInterfaceContainer::UKUIInterfaceContainer( const class FObjectInitializer&
 	arChildren.SetNum( 0 );
 	this->v2Size = FVector2D::ZeroVector;
 	bValidLayout = false;
+	bLayoutQueued = false;
+	bSizeOnlyLayout = false;
 	bFocused = false;
 	arChildManagers.SetNum( 0 );
 	iTickRequests = 0;
 	iMouseInputRequests = 0;
 	iKeyInputRequests = 0;
+	iEventSubscriptions = 0;
+	arEventSubscribers.Init( 0, KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT );
+	iBulkUpdateDepth = 0;
+	bSortPending = false;
+
+	SubscribeToNativeEvents();
+	SubscribeToBlueprintEvents();
 }
 
 
@@ -45,8 +55,13 @@ void UKUIInterfaceContainer::SetSize( float fWidth, float fHeight )
 
 	Super::SetSize( fWidth, fHeight );
 
+	// If nothing else has changed, only the children that depend on our size need laying out again.
+	const bool bSizeOnly = ( HasValidLayout() || bSizeOnlyLayout );
+
 	InvalidateRenderCache();
 	InvalidateLayout();
+
+	bSizeOnlyLayout = bSizeOnly;
 }
 
 
@@ -66,11 +81,8 @@ void UKUIInterfaceContainer::AddChild( UKUIInterfaceElement* oChild )
 	}
 
 	// Check if we're in the child array already.
-	for ( int32 i = 0; i < arChildren.Num(); ++i )
+	if ( oChild->GetContainer() == this )
 	{
-		if ( arChildren[ i ] != oChild )
-			continue;
-
 		KUIErrorUO( "Trying to add a child that is already a child" );
 		return;
 	}
@@ -79,9 +91,15 @@ void UKUIInterfaceContainer::AddChild( UKUIInterfaceElement* oChild )
 	if ( oChild->GetContainer() != NULL )
 		oChild->GetContainer()->RemoveChild( oChild );
 
-	// Add the child to our array.
-	arChildren.Add( oChild );
-	SortChildren();
+	// Add the child to our array, in z-order unless we're sorting later.
+	if ( IsBulkUpdating() )
+	{
+		arChildren.Add( oChild );
+		bSortPending = true;
+	}
+
+	else
+		arChildren.Insert( oChild, GetChildInsertIndex( oChild->GetZIndex() ) );
 
 	oChild->SetContainer( this );
 
@@ -92,10 +110,20 @@ void UKUIInterfaceContainer::AddChild( UKUIInterfaceElement* oChild )
 		AddTickRequests( ctContainer->GetTickRequests() + ( ctContainer->CanTick() ? 1 : 0 ) );
 		AddMouseInputRequests( ctContainer->GetMouseInputRequests() + ( ctContainer->CanReceieveMouseEvents() ? 1 : 0 ) );
 		AddKeyInputRequests( ctContainer->GetKeyInputRequests() + ( ctContainer->CanReceieveKeyEvents() ? 1 : 0 ) );
+
+		for ( int32 i = 0; i < KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT; ++i )
+		{
+			const uint8 iEventID = GetSubscriptionEventID( i );
+			AddEventSubscribers( iEventID, ctContainer->GetEventSubscribers( iEventID ) + ( ctContainer->RespondsToEvent( iEventID ) ? 1 : 0 ) );
+		}
 	}
 
 	KUISendEvent( FKUIInterfaceContainerElementEvent, EKUIInterfaceContainerEventList::E_ChildAdded, oChild );
 
+	// New containers are laid out in the next layout pass along with everything else.
+	if ( oChild->IsA<UKUIInterfaceContainer>() && !Cast<UKUIInterfaceContainer>( oChild )->HasValidLayout() )
+		Cast<UKUIInterfaceContainer>( oChild )->QueueLayout();
+
 	InvalidateRenderCache();
 }
 
@@ -110,16 +138,7 @@ bool UKUIInterfaceContainer::RemoveChild( UKUIInterfaceElement* oChild )
 	}
 
 	// Check if we're actually in the children array.
-	int32 iIndex = INDEX_NONE;
-
-	for ( int32 i = 0; i < arChildren.Num(); ++i )
-	{
-		if ( arChildren[ i ] != oChild )
-			continue;
-
-		iIndex = i;
-		break;
-	}
+	const int32 iIndex = GetChildIndex( oChild );
 
 	// It wasn't
 	if ( iIndex == INDEX_NONE )
@@ -135,31 +154,8 @@ bool UKUIInterfaceContainer::RemoveChild( UKUIInterfaceElement* oChild )
 		return false;
 	}
 
-	// Swap out the highest index with this child, to maintain contiguity.
-	int32 iHighestIndex = INDEX_NONE;
-
-	for ( int32 i = arChildren.Num() - 1; i > iIndex; --i )
-	{
-		if ( arChildren[ i ] == NULL )
-			continue;
-
-		iHighestIndex = i;
-		break;
-	}
-
-	// We found a highest child, so swap.  Otherwise, we were the highest child and no sort is necessary.
-	if ( iHighestIndex != INDEX_NONE )
-	{
-		arChildren[ iIndex ] = arChildren[ iHighestIndex ];
-
-		// Re-sort the array for z-index.	
-		arChildren.SetNum( iHighestIndex );
-		SortChildren();
-	}
-
-	// Reduce the size of the array by 1.
-	else
-		arChildren.SetNum( iIndex );
+	// Removing in place keeps the rest of the children in z-order.
+	arChildren.RemoveAt( iIndex );
 
 	oChild->SetContainer( NULL );
 
@@ -171,6 +167,12 @@ bool UKUIInterfaceContainer::RemoveChild( UKUIInterfaceElement* oChild )
 		RemoveTickRequests( ctContainer->GetTickRequests() + ( ctContainer->CanTick() ? 1 : 0 ) );
 		RemoveMouseInputRequests( ctContainer->GetMouseInputRequests() + ( ctContainer->CanReceieveMouseEvents() ? 1 : 0 ) );
 		RemoveKeyInputRequests( ctContainer->GetKeyInputRequests() + ( ctContainer->CanReceieveKeyEvents() ? 1 : 0 ) );
+
+		for ( int32 i = 0; i < KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT; ++i )
+		{
+			const uint8 iEventID = GetSubscriptionEventID( i );
+			RemoveEventSubscribers( iEventID, ctContainer->GetEventSubscribers( iEventID ) + ( ctContainer->RespondsToEvent( iEventID ) ? 1 : 0 ) );
+		}
 	}
 
 	KUISendEvent( FKUIInterfaceContainerElementEvent, EKUIInterfaceContainerEventList::E_ChildRemoved, oChild );
@@ -188,65 +190,147 @@ UKUIInterfaceElement* UKUIInterfaceContainer::GetChildAtIndex( int32 iIndex ) co
 }
 
 
+int32 UKUIInterfaceContainer::GetChildCount() const
+{
+	return arChildren.Num();
+}
+
+
 TArray<UKUIInterfaceElement*>::TIterator UKUIInterfaceContainer::GetChildIterator()
 {
 	return arChildren.CreateIterator();
 }
 
 
-void UKUIInterfaceContainer::SortChildren()
+void UKUIInterfaceContainer::AddChildren( const TArray<UKUIInterfaceElement*>& arNewChildren )
+{
+	BeginBulkUpdate();
+
+	for ( int32 i = 0; i < arNewChildren.Num(); ++i )
+		AddChild( arNewChildren[ i ] );
+
+	EndBulkUpdate();
+}
+
+
+void UKUIInterfaceContainer::BeginBulkUpdate()
 {
-	if ( bDebug )
-		bDebug = true;
+	++iBulkUpdateDepth;
+}
 
-	if ( arChildren.Num() == 0 )
+
+void UKUIInterfaceContainer::EndBulkUpdate()
+{
+	if ( iBulkUpdateDepth <= 0 )
+	{
+		KUIErrorUO( "Ending a bulk update that was never started" );
 		return;
+	}
 
-	TArray<UKUIInterfaceElement*> arChildrenTemp;
-	arChildrenTemp.SetNum( arChildren.Num() );
+	--iBulkUpdateDepth;
 
-	for ( int32 i = 0; i < arChildren.Num(); ++i )
-		arChildrenTemp[ i ] = arChildren[ i ];
-	
-	uint16 minZIndex = KUI_ZINDEX_NONE;
-	uint16 lastZIndex = KUI_ZINDEX_NONE;
-	int32 iCurrentIndex = 0;
+	if ( iBulkUpdateDepth == 0 && bSortPending )
+		SortChildren();
+}
+
+
+bool UKUIInterfaceContainer::IsBulkUpdating() const
+{
+	return ( iBulkUpdateDepth > 0 );
+}
 
-	while ( true )
+
+int32 UKUIInterfaceContainer::GetChildInsertIndex( uint16 iZIndex )
+{
+	int32 iLow = 0;
+	int32 iHigh = arChildren.Num();
+
+	while ( iLow < iHigh )
 	{
-		minZIndex = KUI_ZINDEX_NONE;
+		const int32 iMid = iLow + ( iHigh - iLow ) / 2;
 
-		for ( int32 i = 0; i < arChildrenTemp.Num(); ++i )
+		// Children the garbage collector has nulled can't be compared, so clear them out and start again.
+		// Nulls the search never looks at don't change where the child goes.
+		if ( arChildren[ iMid ] == NULL )
 		{
-			if ( arChildrenTemp[ i ] == NULL )
-				continue;
+			arChildren.Remove( NULL );
+			return GetChildInsertIndex( iZIndex );
+		}
 
-			if ( lastZIndex != KUI_ZINDEX_NONE && arChildrenTemp[ i ]->GetZIndex() <= lastZIndex )
-				continue;
+		if ( arChildren[ iMid ]->GetZIndex() <= iZIndex )
+			iLow = iMid + 1;
 
-			if ( minZIndex == KUI_ZINDEX_NONE || arChildrenTemp[ i ]->GetZIndex() < minZIndex )
-				minZIndex = arChildrenTemp[ i ]->GetZIndex();
-		}
+		else
+			iHigh = iMid;
+	}
+
+	return iLow;
+}
 
-		if ( minZIndex == KUI_ZINDEX_NONE )
+
+int32 UKUIInterfaceContainer::GetChildIndex( UKUIInterfaceElement* oChild ) const
+{
+	if ( oChild == NULL || bSortPending )
+		return arChildren.Find( oChild );
+
+	// Children are in z-order, so only search the children with the same Z-Index.
+	const uint16 iZIndex = oChild->GetZIndex();
+	int32 iLow = 0;
+	int32 iHigh = arChildren.Num();
+
+	while ( iLow < iHigh )
+	{
+		const int32 iMid = iLow + ( iHigh - iLow ) / 2;
+
+		if ( arChildren[ iMid ] == NULL )
+			return arChildren.Find( oChild );
+
+		if ( arChildren[ iMid ]->GetZIndex() < iZIndex )
+			iLow = iMid + 1;
+
+		else
+			iHigh = iMid;
+	}
+
+	for ( int32 i = iLow; i < arChildren.Num(); ++i )
+	{
+		if ( arChildren[ i ] == oChild )
+			return i;
+
+		if ( arChildren[ i ] == NULL || arChildren[ i ]->GetZIndex() != iZIndex )
 			break;
+	}
 
-		for ( int32 i = 0; i < arChildrenTemp.Num(); ++i )
-		{
-			if ( arChildrenTemp[ i ] == NULL )
-				continue;
+	// The Z-Index may have changed since it was sorted.
+	return arChildren.Find( oChild );
+}
 
-			if ( arChildrenTemp[ i ]->GetZIndex() != minZIndex )
-				continue;
 
-			arChildren[ iCurrentIndex ] = arChildrenTemp[ i ];
-			++iCurrentIndex;
-		}
+struct FKUIInterfaceElementZIndexSort
+{
+	bool operator()( const UKUIInterfaceElement& oA, const UKUIInterfaceElement& oB ) const
+	{
+		return ( oA.GetZIndex() < oB.GetZIndex() );
+	}
+};
 
-		lastZIndex = minZIndex;
+
+void UKUIInterfaceContainer::SortChildren()
+{
+	if ( IsBulkUpdating() )
+	{
+		bSortPending = true;
+		return;
 	}
 
-	arChildren.SetNum( iCurrentIndex );	
+	bSortPending = false;
+
+	arChildren.Remove( NULL );
+
+	if ( arChildren.Num() < 2 )
+		return;
+
+	arChildren.StableSort( FKUIInterfaceElementZIndexSort() );
 }
 
 
@@ -275,16 +359,23 @@ void UKUIInterfaceContainer::SetVisible( bool bVisible )
 
 void UKUIInterfaceContainer::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject )
 {
+	// Normally done by the interface's layout pass, unless something was invalidated since.
 	if ( !HasValidLayout() )
 	{
-		DoLayout();
-		KUISendEvent( FKUIInterfaceEvent, EKUIInterfaceContainerEventList::E_LayoutComplete );
+		SCOPE_CYCLE_COUNTER( STAT_KUILayout );
+
+		UpdateLayout();
 	}
 
 	Super::Render( aHud, oCanvas, v2Origin, oRenderCacheObject );
 
 	if ( IsRenderCaching() && oRenderCacheObject != this )
+	{
+		if ( oRenderCacheObject == NULL )
+			UpdateCachedHitTestRects( aHud );
+
 		return;
+	}
 
 	const FVector2D v2RenderLocation = GetRenderLocation();
 
@@ -296,11 +387,51 @@ void UKUIInterfaceContainer::Render( AKUIInterface* aHud, UCanvas* oCanvas, cons
 		if ( !arChildren[ i ]->IsVisible() )
 			continue;
 
+		if ( oRenderCacheObject != NULL && !oRenderCacheObject->GetRenderCache()->ShouldRedraw( arChildren[ i ], v2Origin + v2RenderLocation ) )
+			continue;
+
 		arChildren[ i ]->Render( aHud, oCanvas, v2Origin + v2RenderLocation, oRenderCacheObject );	
 	}
 }
 
 
+void UKUIInterfaceContainer::UpdateHitTestRect( AKUIInterface* aHud, const FVector2D& v2ScreenLocation )
+{
+	Super::UpdateHitTestRect( aHud, v2ScreenLocation );
+
+	if ( !CanReceieveMouseEvents() )
+		return;
+
+	if ( aHud == NULL || !aHud->IsRecordingHitTest() || iHitTestFrame != aHud->GetHitTestFrame() )
+		return;
+
+	aHud->AddHitTestEntry( this, v2HitTestMin, v2HitTestMax );
+}
+
+
+void UKUIInterfaceContainer::UpdateCachedHitTestRects( AKUIInterface* aHud )
+{
+	if ( iMouseInputRequests <= 0 )
+		return;
+
+	// Same order as rendering, so the grid still has the topmost last.
+	for ( int32 i = 0; i < arChildren.Num(); ++i )
+	{
+		UKUIInterfaceContainer* const ctChild = Cast<UKUIInterfaceContainer>( arChildren[ i ] );
+
+		if ( ctChild == NULL || !ctChild->IsVisible() )
+			continue;
+
+		if ( !ctChild->CanReceieveMouseEvents() && ctChild->GetMouseInputRequests() <= 0 )
+			continue;
+
+		ctChild->aLastRenderedBy = aHud;
+		ctChild->UpdateHitTestRect( aHud, ctChild->GetHitTestLocation() );
+		ctChild->UpdateCachedHitTestRects( aHud );
+	}
+}
+
+
 void UKUIInterfaceContainer::OnChildSizeChange( const FKUIInterfaceContainerElementEvent& stEventInfo )
 {
 	// Not needed any more... but not a bad idea having this method here.
@@ -324,17 +455,60 @@ bool UKUIInterfaceContainer::HasValidLayout() const
 void UKUIInterfaceContainer::InvalidateLayout()
 {
 	bValidLayout = false;
+	bSizeOnlyLayout = false;
 
+	QueueLayout();
 	InvalidateAlignLocation();
 
 	KUISendEvent( FKUIInterfaceEvent, EKUIInterfaceContainerEventList::E_LayoutInvalidated );
 }
 
 
+void UKUIInterfaceContainer::InvalidateScreenLocation()
+{
+	// Children are never valid if we aren't, so there's nothing left to do.
+	if ( !HasValidScreenLocation() )
+		return;
+
+	Super::InvalidateScreenLocation();
+
+	for ( int32 i = 0; i < arChildren.Num(); ++i )
+	{
+		if ( arChildren[ i ] == NULL )
+			continue;
+
+		arChildren[ i ]->InvalidateScreenLocation();
+	}
+}
+
+
+void UKUIInterfaceContainer::InvalidateChildRenderCache( UKUIInterfaceElement* oChild )
+{
+	if ( oChild == NULL )
+	{
+		InvalidateRenderCache();
+		return;
+	}
+
+	// Pass the element up to the cache it is drawn into.
+	if ( !IsRenderCaching() )
+	{
+		if ( GetContainer() != NULL )
+			GetContainer()->InvalidateChildRenderCache( oChild );
+
+		return;
+	}
+
+	oRenderCache->InvalidateRenderCacheElement( oChild );
+
+	InvalidateContainerRenderCache();
+}
+
+
 // Default class uses alignment and docking to do layout.
 void UKUIInterfaceContainer::DoLayout()
 {
-	// Invalidate all the locations.
+	// Invalidate the locations.
 	for ( int32 i = 0; i < arChildren.Num(); ++i )
 	{
 		if ( arChildren[ i ] == NULL )
@@ -343,10 +517,14 @@ void UKUIInterfaceContainer::DoLayout()
 		if ( IsChildsLayoutManaged( arChildren[ i ] ) )
 			continue;
 
+		// Absolutely positioned children stay put.  Children aligned to siblings follow them.
+		if ( bSizeOnlyLayout && !arChildren[ i ]->DependsOnContainerSize() )
+			continue;
+
 		arChildren[ i ]->InvalidateAlignLocation();
 	}
 
-	TArray<UKUIInterfaceElement*> arAlignStack;
+	bSizeOnlyLayout = false;
 
 	for ( int32 i = 0; i < arChildren.Num(); ++i )
 	{
@@ -359,13 +537,65 @@ void UKUIInterfaceContainer::DoLayout()
 		if ( IsChildsLayoutManaged( arChildren[ i ] ) )
 			continue;
 
-		arChildren[ i ]->CalculateAlignLocation( arAlignStack );
+		arChildren[ i ]->CalculateAlignLocation();
 	}
 
 	bValidLayout = true;
 }
 
 
+void UKUIInterfaceContainer::MeasureLayout()
+{
+
+}
+
+
+void UKUIInterfaceContainer::ValidateLayout()
+{
+	if ( HasValidLayout() )
+		return;
+
+	INC_DWORD_STAT( STAT_KUILayoutArranged );
+
+	DoLayout();
+	KUISendEvent( FKUIInterfaceEvent, EKUIInterfaceContainerEventList::E_LayoutComplete );
+}
+
+
+void UKUIInterfaceContainer::UpdateLayout()
+{
+	if ( HasValidLayout() )
+		return;
+
+	MeasureLayout();
+	ValidateLayout();
+}
+
+
+bool UKUIInterfaceContainer::IsLayoutQueued() const
+{
+	return bLayoutQueued;
+}
+
+
+void UKUIInterfaceContainer::SetLayoutQueued( bool bLayoutQueued )
+{
+	this->bLayoutQueued = bLayoutQueued;
+}
+
+
+void UKUIInterfaceContainer::QueueLayout()
+{
+	if ( bLayoutQueued || IsTemplate() )
+		return;
+
+	AKUIInterface* const aInterface = GetInterface();
+
+	if ( aInterface != NULL )
+		aInterface->QueueLayout( this );
+}
+
+
 void UKUIInterfaceContainer::OnTick( const FKUIInterfaceContainerTickEvent& stEventInfo )
 {
 
@@ -564,6 +794,191 @@ void UKUIInterfaceContainer::RemoveKeyInputRequests( int16 iCount )
 }
 
 
+int32 UKUIInterfaceContainer::GetSubscriptionEventIndex( uint8 iEventID )
+{
+	switch ( iEventID )
+	{
+		case EKUIInterfaceContainerEventList::E_ScreenResolutionChange: return 0;
+		case EKUIInterfaceContainerEventList::E_MatchStart:             return 1;
+		case EKUIInterfaceContainerEventList::E_MatchEnd:               return 2;
+		case EKUIInterfaceContainerEventList::E_MatchPaused:            return 3;
+		case EKUIInterfaceContainerEventList::E_MatchUnpaused:          return 4;
+		case EKUIInterfaceContainerEventList::E_PlayerDeath:            return 5;
+		case EKUIInterfaceContainerEventList::E_VisibilityChange:       return 6;
+		case EKUIInterfaceContainerEventList::E_FocusChange:            return 7;
+		case EKUIInterfaceContainerEventList::E_MatchStateChange:       return 8;
+		default:                                                        return INDEX_NONE;
+	}
+}
+
+
+uint8 UKUIInterfaceContainer::GetSubscriptionEventID( int32 iIndex )
+{
+	static const uint8 arEventIDs[ KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT ] = {
+		EKUIInterfaceContainerEventList::E_ScreenResolutionChange,
+		EKUIInterfaceContainerEventList::E_MatchStart,
+		EKUIInterfaceContainerEventList::E_MatchEnd,
+		EKUIInterfaceContainerEventList::E_MatchPaused,
+		EKUIInterfaceContainerEventList::E_MatchUnpaused,
+		EKUIInterfaceContainerEventList::E_PlayerDeath,
+		EKUIInterfaceContainerEventList::E_VisibilityChange,
+		EKUIInterfaceContainerEventList::E_FocusChange,
+		EKUIInterfaceContainerEventList::E_MatchStateChange
+	};
+
+	if ( iIndex < 0 || iIndex >= KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT )
+		return 0;
+
+	return arEventIDs[ iIndex ];
+}
+
+
+bool UKUIInterfaceContainer::IsSubscriptionEvent( uint8 iEventID )
+{
+	return ( GetSubscriptionEventIndex( iEventID ) != INDEX_NONE );
+}
+
+
+void UKUIInterfaceContainer::SubscribeToEvent( uint8 iEventID )
+{
+	const int32 iIndex = GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		KUIErrorUO( "Trying to subscribe to a non-subscription event (%d)", iEventID );
+		return;
+	}
+
+	if ( IsSubscribedToEvent( iEventID ) )
+		return;
+
+	const bool bResponded = RespondsToEvent( iEventID );
+
+	iEventSubscriptions |= ( 1 << iIndex );
+
+	if ( !bResponded && RespondsToEvent( iEventID ) && GetContainer() != NULL )
+		GetContainer()->AddEventSubscribers( iEventID, 1 );
+}
+
+
+void UKUIInterfaceContainer::UnsubscribeFromEvent( uint8 iEventID )
+{
+	const int32 iIndex = GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		KUIErrorUO( "Trying to unsubscribe from a non-subscription event (%d)", iEventID );
+		return;
+	}
+
+	if ( !IsSubscribedToEvent( iEventID ) )
+		return;
+
+	const bool bResponded = RespondsToEvent( iEventID );
+
+	iEventSubscriptions &= ~( 1 << iIndex );
+
+	if ( bResponded && !RespondsToEvent( iEventID ) && GetContainer() != NULL )
+		GetContainer()->RemoveEventSubscribers( iEventID, 1 );
+}
+
+
+bool UKUIInterfaceContainer::IsSubscribedToEvent( uint8 iEventID ) const
+{
+	const int32 iIndex = GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+		return false;
+
+	return ( ( iEventSubscriptions & ( 1 << iIndex ) ) != 0 );
+}
+
+
+int32 UKUIInterfaceContainer::GetEventSubscribers( uint8 iEventID ) const
+{
+	const int32 iIndex = GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+		return 0;
+
+	return arEventSubscribers[ iIndex ];
+}
+
+
+void UKUIInterfaceContainer::AddEventSubscribers( uint8 iEventID, int32 iCount )
+{
+	if ( iCount == 0 )
+		return;
+
+	const int32 iIndex = GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+		return;
+
+	arEventSubscribers[ iIndex ] += iCount;
+
+	if ( GetContainer() != NULL )
+		GetContainer()->AddEventSubscribers( iEventID, iCount );
+}
+
+
+void UKUIInterfaceContainer::RemoveEventSubscribers( uint8 iEventID, int32 iCount )
+{
+	if ( iCount == 0 )
+		return;
+
+	const int32 iIndex = GetSubscriptionEventIndex( iEventID );
+
+	if ( iIndex == INDEX_NONE )
+		return;
+
+	arEventSubscribers[ iIndex ] -= iCount;
+
+	if ( GetContainer() != NULL )
+		GetContainer()->RemoveEventSubscribers( iEventID, iCount );
+}
+
+
+void UKUIInterfaceContainer::SubscribeToNativeEvents()
+{
+	const UClass* oNativeClass = GetClass();
+
+	while ( oNativeClass != NULL && !oNativeClass->HasAnyClassFlags( CLASS_Native ) )
+		oNativeClass = oNativeClass->GetSuperClass();
+
+	// KeshUI's own containers subscribe to the events they handle in their constructors.
+	if ( oNativeClass == NULL || oNativeClass->GetOutermost() == UKUIInterfaceContainer::StaticClass()->GetOutermost() )
+		return;
+
+	// Overridden C++ handlers can't be detected, so containers from other modules get every event until they opt out.
+	for ( int32 i = 0; i < KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT; ++i )
+		SubscribeToEvent( GetSubscriptionEventID( i ) );
+}
+
+
+void UKUIInterfaceContainer::SubscribeToBlueprintEvents()
+{
+	if ( !GetClass()->HasAnyClassFlags( CLASS_CompiledFromBlueprint ) )
+		return;
+
+	static const FName arEventFunctions[ KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT ] = {
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnScreenResolutionChangeBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnMatchStartBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnMatchEndBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnMatchPausedBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnMatchUnpausedBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnPlayerDeathBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnVisibilityChangeBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnFocusChangeBP ),
+		GET_FUNCTION_NAME_CHECKED( UKUIInterfaceContainer, OnMatchStateChangeBP )
+	};
+
+	for ( int32 i = 0; i < KUI_CONTAINER_SUBSCRIPTION_EVENT_COUNT; ++i )
+		if ( GetClass()->IsFunctionImplementedInBlueprint( arEventFunctions[ i ] ) )
+			SubscribeToEvent( GetSubscriptionEventID( i ) );
+}
+
+
 void UKUIInterfaceContainer::AddChildManager( UKUIInterfaceWidgetChildManager* oChildManager )
 {
 	if ( arChildManagers.Contains( oChildManager ) )
@@ -682,6 +1097,17 @@ bool UKUIInterfaceContainer::RespondsToEvent( uint8 iEventID ) const
 
 			return false;
 
+		case EKUIInterfaceContainerEventList::E_ScreenResolutionChange:
+		case EKUIInterfaceContainerEventList::E_MatchStart:
+		case EKUIInterfaceContainerEventList::E_MatchEnd:
+		case EKUIInterfaceContainerEventList::E_MatchPaused:
+		case EKUIInterfaceContainerEventList::E_MatchUnpaused:
+		case EKUIInterfaceContainerEventList::E_PlayerDeath:
+		case EKUIInterfaceContainerEventList::E_VisibilityChange:
+		case EKUIInterfaceContainerEventList::E_FocusChange:
+		case EKUIInterfaceContainerEventList::E_MatchStateChange:
+			return IsSubscribedToEvent( iEventID );
+
 		default:
 			return ( iEventID >= KUI_CONTAINER_EVENT_FIRST && iEventID <= KUI_CONTAINER_EVENT_LAST );
 	}
@@ -693,6 +1119,18 @@ void UKUIInterfaceContainer::SendEvent( FKUIInterfaceEvent& stEventInfo )
 	if ( IsTemplate() )
 		return;
 
+	// Child changes are sent once per child when a batch update ends.
+	if ( stEventInfo.iEventID == EKUIInterfaceContainerEventList::E_ChildLocationChange ||
+		 stEventInfo.iEventID == EKUIInterfaceContainerEventList::E_ChildSizeChange )
+	{
+		UKUIInterfaceElement* const oChild = reinterpret_cast<FKUIInterfaceContainerElementEvent*>( &stEventInfo )->oElement;
+		AKUIInterface* const aInterface = GetInterface();
+
+		if ( oChild != NULL && oChild->GetContainer() == this && aInterface != NULL && aInterface->DeferBatchUpdate( oChild,
+			( stEventInfo.iEventID == EKUIInterfaceContainerEventList::E_ChildLocationChange ? EKUIBatchUpdate::B_ChildLocationChange : EKUIBatchUpdate::B_ChildSizeChange ) ) )
+			return;
+	}
+
 	Super::SendEvent( stEventInfo );
 
 	static TArray<std::function<void( UKUIInterfaceContainer*, FKUIInterfaceEvent& )>> arDispatchers;
@@ -924,47 +1362,54 @@ void UKUIInterfaceContainer::BroadcastEvent( FKUIInterfaceEvent& stEventInfo, bo
 		}
 	}
 
+	// Only walk the children if something below us has subscribed.
+	const bool bSubscriptionEvent = IsSubscriptionEvent( stEventInfo.iEventID );
+	const bool bVisitChildren = ( !bSubscriptionEvent || GetEventSubscribers( stEventInfo.iEventID ) > 0 );
+
 	if ( !bTopDown )
 	{
 		if ( bResponds )
 			SendEvent( stEventInfo );
 
-		for ( int32 i = 0; i < arChildren.Num(); ++i )
+		if ( bVisitChildren )
 		{
-			UKUIInterfaceElement* ctChild = Cast<UKUIInterfaceElement>( arChildren[ i ] );
-
-			if ( ctChild == NULL )
-				continue;
-
-			UKUIInterfaceContainer* ctChildContainer = Cast<UKUIInterfaceContainer>( arChildren[ i ] );
-
-			if ( ctChildContainer == NULL )
-				ctChild->SendEvent( stEventInfo );
-
-			else
-				ctChildContainer->BroadcastEvent( stEventInfo, bTopDown );
+			for ( int32 i = 0; i < arChildren.Num(); ++i )
+				BroadcastEventToChild( arChildren[ i ], stEventInfo, bTopDown, bSubscriptionEvent );
 		}
 	}
 
 	else
 	{
-		for ( int32 i = arChildren.Num() - 1; i >= 0; --i )
+		if ( bVisitChildren )
 		{
-			UKUIInterfaceElement* ctChild = Cast<UKUIInterfaceElement>( arChildren[ i ] );
+			for ( int32 i = arChildren.Num() - 1; i >= 0; --i )
+				BroadcastEventToChild( arChildren[ i ], stEventInfo, bTopDown, bSubscriptionEvent );
+		}
 
-			if ( ctChild == NULL )
-				continue;
+		if ( bResponds )
+			SendEvent( stEventInfo );
+	}
+}
 
-			UKUIInterfaceContainer* ctChildContainer = Cast<UKUIInterfaceContainer>( arChildren[ i ] );
 
-			if ( ctChildContainer == NULL )
-				ctChild->SendEvent( stEventInfo );
+void UKUIInterfaceContainer::BroadcastEventToChild( UKUIInterfaceElement* oChild, FKUIInterfaceEvent& stEventInfo, bool bTopDown, bool bSubscriptionEvent )
+{
+	if ( oChild == NULL )
+		return;
 
-			else
-				ctChildContainer->BroadcastEvent( stEventInfo, bTopDown );
-		}
+	UKUIInterfaceContainer* const ctChildContainer = Cast<UKUIInterfaceContainer>( oChild );
 
-		if ( bResponds )
-			SendEvent( stEventInfo );
+	// Components never subscribe to container events.
+	if ( ctChildContainer == NULL )
+	{
+		if ( !bSubscriptionEvent )
+			oChild->SendEvent( stEventInfo );
+
+		return;
 	}
+
+	if ( bSubscriptionEvent && ctChildContainer->GetEventSubscribers( stEventInfo.iEventID ) == 0 && !ctChildContainer->RespondsToEvent( stEventInfo.iEventID ) )
+		return;
+
+	ctChildContainer->BroadcastEvent( stEventInfo, bTopDown );
 }
@@ -26,7 +26,14 @@ UKUIInterfaceElement::UKUIInterfaceElement( const class FObjectInitializer& oObj
 	eVAlign = EKUIInterfaceVAlign::VA_None;
 	v2AlignLocation = FVector2D::ZeroVector;
 	bValidAlignLocation = false;
+	bCalculatingAlignLocation = false;
 	v2LastScreenRenderLocation = FVector2D( -1.f, -1.f ); // Invalid
+	v2ScreenLocation = FVector2D::ZeroVector;
+	bValidScreenLocation = false;
+	v2HitTestMin = FVector2D::ZeroVector;
+	v2HitTestMax = FVector2D::ZeroVector;
+	iHitTestFrame = 0; // Invalid
+	stLastRenderCacheRect = FBox2D( 0 );
 	arAlignedToThis.SetNum( 0 );
 	oRenderCache = NULL;
 	aLastRenderedBy = NULL;
@@ -174,6 +181,8 @@ void UKUIInterfaceElement::SetLocation( float fX, float fY )
 	v2Location.X = fX;
 	v2Location.Y = fY;
 
+	InvalidateScreenLocation();
+
 	if ( GetContainer() != NULL )
 	{
 		FKUIInterfaceContainerElementEvent stContainerEventInfo( EKUIInterfaceContainerEventList::E_ChildLocationChange, this );
@@ -276,6 +285,12 @@ void UKUIInterfaceElement::SetAlignedTo( UKUIInterfaceElement* oAlignedTo )
 	if ( this->oAlignedTo.Get() == oAlignedTo )
 		return;
 
+	if ( !CanAlignTo( oAlignedTo ) )
+	{
+		KUIErrorUO( "Aligning to this element would create a circular alignment" );
+		return;
+	}
+
 	if ( this->oAlignedTo.IsValid() )
 		this->oAlignedTo->RemoveAlignedToThis( this );
 
@@ -353,10 +368,50 @@ bool UKUIInterfaceElement::HasValidAlignLocation() const
 }
 
 
+bool UKUIInterfaceElement::DependsOnContainerSize() const
+{
+	// Elements aligned to something else are invalidated through it if it moves.
+	if ( GetAlignedTo() != NULL && GetAlignedTo() != GetContainer() )
+		return false;
+
+	switch ( GetHorizontalAlignment() )
+	{
+		case EKUIInterfaceHAlign::HA_Centre:
+		case EKUIInterfaceHAlign::HA_Right:
+		case EKUIInterfaceHAlign::HA_Right_Outer:
+		case EKUIInterfaceHAlign::HA_Fill:
+			return true;
+
+		default:
+			break;
+	}
+
+	switch ( GetVerticalAlignment() )
+	{
+		case EKUIInterfaceVAlign::VA_Centre:
+		case EKUIInterfaceVAlign::VA_Bottom:
+		case EKUIInterfaceVAlign::VA_Bottom_Outer:
+		case EKUIInterfaceVAlign::VA_Fill:
+			return true;
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+
 void UKUIInterfaceElement::InvalidateAlignLocation()
 {
 	bValidAlignLocation = false;
 
+	// The elements aligned to this one are invalidated when the batch update ends.
+	AKUIInterface* const aInterface = GetInterface();
+
+	if ( aInterface != NULL && aInterface->DeferBatchUpdate( this, EKUIBatchUpdate::B_AlignLocation ) )
+		return;
+
 	for ( int32 i = 0; i < arAlignedToThis.Num(); ++i )
 		if ( arAlignedToThis[ i ].IsValid() )
 			arAlignedToThis[ i ]->InvalidateAlignLocation();
@@ -368,7 +423,12 @@ void UKUIInterfaceElement::InvalidateAlignLocation()
 
 void UKUIInterfaceElement::SetAlignLocation( const FVector2D& v2AlignLocation )
 {
-	this->v2AlignLocation = v2AlignLocation;
+	if ( this->v2AlignLocation != v2AlignLocation )
+	{
+		this->v2AlignLocation = v2AlignLocation;
+		InvalidateScreenLocation();
+	}
+
 	bValidAlignLocation = true;
 
 	FKUIInterfaceEvent stEventInfo( EKUIInterfaceElementEventList::E_AlignLocationCalculated );
@@ -379,11 +439,7 @@ void UKUIInterfaceElement::SetAlignLocation( const FVector2D& v2AlignLocation )
 const FVector2D UKUIInterfaceElement::GetRenderLocation() const
 {
 	if ( !bValidAlignLocation )
-	{
-		TArray<UKUIInterfaceElement*> arAlignStack;
-
-		const_cast<UKUIInterfaceElement*>( this )->CalculateAlignLocation( arAlignStack );
-	}
+		const_cast<UKUIInterfaceElement*>( this )->CalculateAlignLocation();
 
 	return ( v2AlignLocation + v2Location );
 }
@@ -436,7 +492,19 @@ bool UKUIInterfaceElement::IsPointOver( const FVector2D& v2Point ) const
 
 const FVector2D UKUIInterfaceElement::GetScreenLocation() const
 {
-	return GetNestedLocation( NULL );
+	// Only walks up the container chain when something along it has moved.
+	if ( !bValidScreenLocation )
+	{
+		if ( this->GetContainer() == NULL )
+			v2ScreenLocation = GetNestedOffset();
+
+		else
+			v2ScreenLocation = this->GetContainer()->GetScreenLocation() + GetNestedOffset();
+
+		bValidScreenLocation = true;
+	}
+
+	return v2ScreenLocation;
 }
 
 
@@ -445,10 +513,31 @@ const FVector2D UKUIInterfaceElement::GetNestedLocation( UKUIInterfaceContainer*
 	if ( this == ctRoot )
 		return FVector2D::ZeroVector;
 
+	if ( ctRoot == NULL )
+		return GetScreenLocation();
+
 	if ( this->GetContainer() == NULL )
-		return v2AlignLocation + v2Location;
+		return GetNestedOffset();
+
+	return ( this->GetContainer()->GetNestedLocation( ctRoot ) + GetNestedOffset() );
+}
 
-	return ( this->GetContainer()->GetNestedLocation( ctRoot ) + v2AlignLocation + v2Location );
+
+const FVector2D UKUIInterfaceElement::GetNestedOffset() const
+{
+	return v2AlignLocation + v2Location;
+}
+
+
+bool UKUIInterfaceElement::HasValidScreenLocation() const
+{
+	return bValidScreenLocation;
+}
+
+
+void UKUIInterfaceElement::InvalidateScreenLocation()
+{
+	bValidScreenLocation = false;
 }
 
 
@@ -457,9 +546,21 @@ void UKUIInterfaceElement::Render( AKUIInterface* aHud, UCanvas* oCanvas, const
 	aLastRenderedBy = aHud;
 
 	if ( !HasValidAlignLocation() )
+		CalculateAlignLocation();
+
+	// Remember where we were drawn in the render cache so the area can be redrawn when we change.
+	if ( oRenderCacheObject != NULL && oRenderCacheObject != this && oRenderCacheObject->GetRenderCache() != NULL )
 	{
-		TArray<UKUIInterfaceElement*> arAlignStack;
-		CalculateAlignLocation( arAlignStack );
+		const FVector2D v2Size = GetSize();
+
+		if ( v2Size.X > 0.f && v2Size.Y > 0.f )
+		{
+			const FVector2D v2CacheLocation = v2Origin + GetRenderLocation() - oRenderCacheObject->GetRenderCache()->GetRenderOrigin();
+			stLastRenderCacheRect = FBox2D( v2CacheLocation, v2CacheLocation + v2Size );
+		}
+
+		else
+			stLastRenderCacheRect = FBox2D( 0 );
 	}
 
 	if ( IsRenderCaching() )
@@ -470,8 +571,13 @@ void UKUIInterfaceElement::Render( AKUIInterface* aHud, UCanvas* oCanvas, const
 				oRenderCache->UpdateRenderCache( this );
 
 			//v2LastScreenRenderLocation = v2Origin + GetRenderLocation()/* + oRenderCacheObject->GetLastScreenRenderLocation()*/;
+			const FVector2D v2ScreenLocation = GetScreenLocation();
+
+			if ( oRenderCacheObject == NULL )
+				UpdateHitTestRect( aHud, v2ScreenLocation );
+
 			oCanvas->Reset();
-			oRenderCache->Render( aHud, oCanvas, GetScreenLocation() );
+			oRenderCache->Render( aHud, oCanvas, v2ScreenLocation );
 
 			KUISendEvent( FKUIInterfaceElementRenderEvent, EKUIInterfaceElementEventList::E_Render, oCanvas, v2Origin );
 		}
@@ -480,7 +586,10 @@ void UKUIInterfaceElement::Render( AKUIInterface* aHud, UCanvas* oCanvas, const
 	else
 	{
 		if ( oRenderCacheObject == NULL )
+		{
 			v2LastScreenRenderLocation = v2Origin + GetRenderLocation();
+			UpdateHitTestRect( aHud, v2LastScreenRenderLocation );
+		}
 
 		oCanvas->Reset();
 
@@ -514,6 +623,20 @@ bool UKUIInterfaceElement::IsMouseOver() const
 		return false;
 	}
 
+	// Use the clipped rect from the last frame, if we were rendered.
+	FVector2D v2HitTestMin;
+	FVector2D v2HitTestMax;
+
+	if ( GetHitTestRect( v2HitTestMin, v2HitTestMax ) )
+	{
+		const FVector2D v2CursorLocation = GetInterface()->GetCursorLocation();
+
+		return ( v2CursorLocation.X >= v2HitTestMin.X &&
+				 v2CursorLocation.Y >= v2HitTestMin.Y &&
+				 v2CursorLocation.X < v2HitTestMax.X &&
+				 v2CursorLocation.Y < v2HitTestMax.Y );
+	}
+
 	if ( GetContainer() != NULL )
 	{
 		if ( !GetContainer()->IsMouseOver() )
@@ -534,6 +657,64 @@ bool UKUIInterfaceElement::IsMouseOver() const
 }
 
 
+bool UKUIInterfaceElement::GetHitTestRect( FVector2D& v2Min, FVector2D& v2Max ) const
+{
+	if ( iHitTestFrame == 0 || !aLastRenderedBy.IsValid() )
+		return false;
+
+	if ( aLastRenderedBy->GetHitTestFrame() != iHitTestFrame )
+		return false;
+
+	v2Min = v2HitTestMin;
+	v2Max = v2HitTestMax;
+	return true;
+}
+
+
+const FBox2D& UKUIInterfaceElement::GetLastRenderCacheRect() const
+{
+	return stLastRenderCacheRect;
+}
+
+
+void UKUIInterfaceElement::UpdateHitTestRect( AKUIInterface* aHud, const FVector2D& v2ScreenLocation )
+{
+	if ( aHud == NULL || !aHud->IsRecordingHitTest() )
+		return;
+
+	FVector2D v2Min = v2ScreenLocation;
+	FVector2D v2Max = v2ScreenLocation + GetSize();
+
+	// The cursor has to be over every container in the chain, so clip to the container's rect.
+	if ( GetContainer() != NULL )
+	{
+		FVector2D v2ContainerMin;
+		FVector2D v2ContainerMax;
+
+		if ( !GetContainer()->GetHitTestRect( v2ContainerMin, v2ContainerMax ) )
+		{
+			iHitTestFrame = 0;
+			return;
+		}
+
+		v2Min.X = max( v2Min.X, v2ContainerMin.X );
+		v2Min.Y = max( v2Min.Y, v2ContainerMin.Y );
+		v2Max.X = min( v2Max.X, v2ContainerMax.X );
+		v2Max.Y = min( v2Max.Y, v2ContainerMax.Y );
+	}
+
+	v2HitTestMin = v2Min;
+	v2HitTestMax = v2Max;
+	iHitTestFrame = aHud->GetHitTestFrame();
+}
+
+
+const FVector2D UKUIInterfaceElement::GetHitTestLocation() const
+{
+	return GetScreenLocation();
+}
+
+
 void UKUIInterfaceElement::AddAlignedToThis( UKUIInterfaceElement* oAlignChild )
 {
 	// Can't remove a null pointer.
@@ -597,34 +778,44 @@ void UKUIInterfaceElement::RemoveAlignedToThis( UKUIInterfaceElement* oAlignChil
 		return;
 	}
 
-	// Swap out the highest index with this child, to maintain contiguity.
-	int32 iHighestIndex = INDEX_NONE;
+	arAlignedToThis.RemoveAtSwap( iIndex );
+}
+
 
-	for ( int32 i = arAlignedToThis.Num() - 1; i > iIndex; --i )
+bool UKUIInterfaceElement::CanAlignTo( UKUIInterfaceElement* oAlignedTo ) const
+{
+	// Follow what each element is aligned to, or its container if nothing, to see if it comes back here.
+	TArray<const UKUIInterfaceElement*> arVisited;
+
+	for ( const UKUIInterfaceElement* oAnchor = oAlignedTo; oAnchor != NULL; )
 	{
-		if ( !arAlignedToThis[ i ].IsValid() )
-			continue;
+		if ( oAnchor == this )
+			return false;
 
-		iHighestIndex = i;
-		break;
-	}
+		// There's already a cycle further up that doesn't involve us.
+		if ( arVisited.Contains( oAnchor ) )
+			return true;
+
+		arVisited.Add( oAnchor );
+
+		if ( oAnchor->GetAlignedTo() != NULL )
+			oAnchor = oAnchor->GetAlignedTo();
 
-	// We found a highest child, so swap.  Otherwise, we were the highest child and no sort is necessary.
-	if ( iHighestIndex != INDEX_NONE )
-		arAlignedToThis[ iIndex ] = arAlignedToThis[ iHighestIndex ];
+		else
+			oAnchor = oAnchor->GetContainer();
+	}
 
-	// Reduce the size of the array by 1.
-	arAlignedToThis.SetNum( iIndex );
+	return true;
 }
 
 
-void UKUIInterfaceElement::CalculateAlignLocation( TArray<UKUIInterfaceElement*>& arAlignStack )
+void UKUIInterfaceElement::CalculateAlignLocation()
 {
 	if ( HasValidAlignLocation() )
 		return;
 
-	// Avoid recursive layout dependencies.
-	if ( arAlignStack.Contains( this ) )
+	// Alignments are checked for cycles when they're set, but containers can still be rearranged into one.
+	if ( bCalculatingAlignLocation )
 		return;
 
 	if ( GetContainer() != NULL && GetContainer()->IsChildsLayoutManaged( this ) )
@@ -649,10 +840,10 @@ void UKUIInterfaceElement::CalculateAlignLocation( TArray<UKUIInterfaceElement*>
 		return;
 	}
 
-	arAlignStack.Add( this );
+	bCalculatingAlignLocation = true;
 
 	if ( !oAlignedTo->HasValidAlignLocation() )
-		oAlignedTo->CalculateAlignLocation( arAlignStack );
+		oAlignedTo->CalculateAlignLocation();
 
 	const FVector2D v2Size = GetSize() + GetMarginSize();
 	FVector2D v2AlignLocation = FVector2D::ZeroVector;
@@ -690,7 +881,7 @@ void UKUIInterfaceElement::CalculateAlignLocation( TArray<UKUIInterfaceElement*>
 	if ( oAlignedTo != GetContainer() && oAlignedTo->GetContainer() != GetContainer() )
 		v2AlignLocation += oAlignedTo->GetScreenLocation() - GetContainer()->GetScreenLocation();
 
-	arAlignStack.Remove( this );
+	bCalculatingAlignLocation = false;
 	SetAlignLocation( v2AlignLocation );
 }
 
@@ -786,6 +977,11 @@ bool UKUIInterfaceElement::IsInputEventConsumer() const
 
 void UKUIInterfaceElement::InvalidateRenderCache()
 {
+	AKUIInterface* const aInterface = GetInterface();
+
+	if ( aInterface != NULL && aInterface->DeferBatchUpdate( this, EKUIBatchUpdate::B_RenderCache ) )
+		return;
+
 	if ( oRenderCache )
 		oRenderCache->InvalidateRenderCache();
 
@@ -795,8 +991,13 @@ void UKUIInterfaceElement::InvalidateRenderCache()
 
 void UKUIInterfaceElement::InvalidateContainerRenderCache()
 {
+	AKUIInterface* const aInterface = GetInterface();
+
+	if ( aInterface != NULL && aInterface->DeferBatchUpdate( this, EKUIBatchUpdate::B_ContainerRenderCache ) )
+		return;
+
 	if ( GetContainer() )
-		GetContainer()->InvalidateRenderCache();
+		GetContainer()->InvalidateChildRenderCache( this );
 }
 
 
@@ -811,6 +1012,9 @@ void UKUIInterfaceElement::EnableRenderCache()
 
 void UKUIInterfaceElement::DisableRenderCache()
 {
+	if ( oRenderCache != NULL )
+		oRenderCache->ReleaseRenderCache();
+
 	oRenderCache = NULL;
 }
 
@@ -821,6 +1025,12 @@ bool UKUIInterfaceElement::IsRenderCaching() const
 }
 
 
+UKUIRenderCache* UKUIInterfaceElement::GetRenderCache() const
+{
+	return oRenderCache;
+}
+
+
 bool UKUIInterfaceElement::RespondsToEvent( uint8 iEventID ) const
 {
 	return ( iEventID >= KUI_BASE_EVENT_FIRST && iEventID <= KUI_BASE_EVENT_LAST );
@@ -967,6 +1177,7 @@ void UKUIInterfaceElement::OnAddedToContainer( const FKUIInterfaceElementContain
 		}
 	}
 
+	InvalidateScreenLocation();
 	InvalidateAlignLocation();
 	InvalidateContainerRenderCache();
 }
@@ -976,6 +1187,7 @@ void UKUIInterfaceElement::OnRemovedFromContainer( const FKUIInterfaceElementCon
 {
 	this->ctContainer = NULL;
 
+	InvalidateScreenLocation();
 	InvalidateAlignLocation();
 	InvalidateContainerRenderCache();
 }
@@ -0,0 +1,364 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIRenderBackend.h"
+
+
+FKUIRenderBackend::FKUIRenderBackend()
+{
+	bBatchText = true;
+	oBatchCanvas = NULL;
+	tBatchTexture = NULL;
+	eBatchBlendMode = SE_BLEND_Translucent;
+	arBatchTriangles.SetNum( 0 );
+	stBatchBounds = FBox2D( 0 );
+	iTextItems = 0;
+	iTextSubmissions = 0;
+}
+
+
+FKUIRenderBackend::~FKUIRenderBackend()
+{
+
+}
+
+
+FKUIRenderBackend& FKUIRenderBackend::Get( AKUIInterface* aHud )
+{
+	static FKUIRenderBackend oCanvasBackend;
+
+	if ( aHud == NULL )
+		return oCanvasBackend;
+
+	FKUIRenderBackend* const oBackend = aHud->GetRenderBackend();
+
+	if ( oBackend == NULL )
+		return oCanvasBackend;
+
+	return *oBackend;
+}
+
+
+void FKUIRenderBackend::DrawItem( UCanvas* oCanvas, FCanvasItem& stItem, const FVector2D& v2Size, const FTexture* tTexture )
+{
+	FlushText();
+	SubmitItem( oCanvas, stItem, v2Size, tTexture );
+}
+
+
+void FKUIRenderBackend::DrawTile( UCanvas* oCanvas, float fX, float fY, float fSizeX, float fSizeY, float fU, float fV, float fSizeU, float fSizeV,
+	const FLinearColor& lcColor, const FTexture* tTexture, bool bAlphaBlend )
+{
+	FlushText();
+	SubmitTile( oCanvas, fX, fY, fSizeX, fSizeY, fU, fV, fSizeU, fSizeV, lcColor, tTexture, bAlphaBlend );
+}
+
+
+void FKUIRenderBackend::DrawIcon( UCanvas* oCanvas, const FCanvasIcon& stIcon, float fX, float fY, float fScale )
+{
+	FlushText();
+	SubmitIcon( oCanvas, stIcon, fX, fY, fScale );
+}
+
+
+void FKUIRenderBackend::DrawTextItem( UCanvas* oCanvas, FCanvasTextItem& stItem, const FVector2D& v2Size )
+{
+	++iTextItems;
+
+	if ( !bBatchText || !CanBatchText( stItem ) )
+	{
+		FlushText();
+		++iTextSubmissions;
+		SubmitItem( oCanvas, stItem, v2Size, NULL );
+		return;
+	}
+
+	if ( oCanvas != oBatchCanvas || stItem.BlendMode != eBatchBlendMode )
+		FlushText();
+
+	oBatchCanvas = oCanvas;
+	eBatchBlendMode = stItem.BlendMode;
+
+	// Same passes, in the same order, as FCanvasTextItem::Draw.
+	const float fAlphaModulate = ( oCanvas->Canvas != NULL ? oCanvas->Canvas->AlphaModulate : 1.f );
+	FLinearColor lcColor;
+
+	if ( stItem.bOutlined )
+	{
+		lcColor = stItem.OutlineColor;
+		lcColor.A *= fAlphaModulate;
+
+		AddTextQuads( oCanvas, stItem, stItem.Position + FVector2D( -1.f, -1.f ), lcColor );
+		AddTextQuads( oCanvas, stItem, stItem.Position + FVector2D( -1.f, 1.f ), lcColor );
+		AddTextQuads( oCanvas, stItem, stItem.Position + FVector2D( 1.f, 1.f ), lcColor );
+		AddTextQuads( oCanvas, stItem, stItem.Position + FVector2D( 1.f, -1.f ), lcColor );
+	}
+
+	if ( !stItem.ShadowOffset.IsZero() && stItem.ShadowColor.A > 0.f )
+	{
+		lcColor = stItem.ShadowColor;
+		lcColor.A = stItem.Color.A * fAlphaModulate;
+
+		AddTextQuads( oCanvas, stItem, stItem.Position + stItem.ShadowOffset, lcColor );
+	}
+
+	lcColor = stItem.Color;
+	lcColor.A *= fAlphaModulate;
+
+	AddTextQuads( oCanvas, stItem, stItem.Position, lcColor );
+}
+
+
+void FKUIRenderBackend::FlushText()
+{
+	if ( arBatchTriangles.Num() == 0 )
+	{
+		oBatchCanvas = NULL;
+		return;
+	}
+
+	FCanvasTriangleItem stBatchItem( arBatchTriangles, tBatchTexture );
+	stBatchItem.BlendMode = eBatchBlendMode;
+	stBatchItem.Position = stBatchBounds.Min;
+
+	UCanvas* const oCanvas = oBatchCanvas;
+	const FVector2D v2Size = stBatchBounds.Max - stBatchBounds.Min;
+	const FTexture* const tTexture = tBatchTexture;
+
+	arBatchTriangles.Reset();
+	stBatchBounds = FBox2D( 0 );
+	oBatchCanvas = NULL;
+	tBatchTexture = NULL;
+
+	++iTextSubmissions;
+	SubmitItem( oCanvas, stBatchItem, v2Size, tTexture );
+}
+
+
+bool FKUIRenderBackend::IsBatchingText() const
+{
+	return bBatchText;
+}
+
+
+void FKUIRenderBackend::SetBatchingText( bool bBatchText )
+{
+	FlushText();
+
+	this->bBatchText = bBatchText;
+}
+
+
+void FKUIRenderBackend::GetTextBatchStats( int32& iTextItems, int32& iTextSubmissions ) const
+{
+	iTextItems = this->iTextItems;
+	iTextSubmissions = this->iTextSubmissions;
+}
+
+
+void FKUIRenderBackend::ResetTextBatchStats()
+{
+	iTextItems = 0;
+	iTextSubmissions = 0;
+}
+
+
+bool FKUIRenderBackend::CanRenderToTarget() const
+{
+	return true;
+}
+
+
+void FKUIRenderBackend::SubmitItem( UCanvas* oCanvas, FCanvasItem& stItem, const FVector2D& v2Size, const FTexture* tTexture )
+{
+	oCanvas->DrawItem( stItem );
+}
+
+
+void FKUIRenderBackend::SubmitTile( UCanvas* oCanvas, float fX, float fY, float fSizeX, float fSizeY, float fU, float fV, float fSizeU, float fSizeV,
+	const FLinearColor& lcColor, const FTexture* tTexture, bool bAlphaBlend )
+{
+	if ( oCanvas->Canvas == NULL )
+		return;
+
+	oCanvas->Canvas->DrawTile( fX, fY, fSizeX, fSizeY, fU, fV, fSizeU, fSizeV, lcColor, tTexture, bAlphaBlend );
+}
+
+
+void FKUIRenderBackend::SubmitIcon( UCanvas* oCanvas, const FCanvasIcon& stIcon, float fX, float fY, float fScale )
+{
+	oCanvas->DrawIcon( stIcon, fX, fY, fScale );
+}
+
+
+bool FKUIRenderBackend::CanBatchText( const FCanvasTextItem& stItem ) const
+{
+	// Runtime and distance field fonts, and the features that need the canvas, are left to the canvas.
+	if ( stItem.Font == NULL || stItem.Font->FontCacheType != EFontCacheType::Offline )
+		return false;
+
+	if ( stItem.Font->ImportOptions.bUseDistanceFieldAlpha )
+		return false;
+
+	if ( stItem.bCentreX || stItem.bCentreY || stItem.FontRenderInfo.bClipText || stItem.FontRenderInfo.GlowInfo.bEnableGlow )
+		return false;
+
+	if ( !stItem.bDontCorrectStereoscopic || stItem.Depth != 1.f )
+		return false;
+
+	return true;
+}
+
+
+void FKUIRenderBackend::AddTextQuads( UCanvas* oCanvas, const FCanvasTextItem& stItem, const FVector2D& v2Location, const FLinearColor& lcColor )
+{
+	const UFont* const foFont = stItem.Font;
+	const FString& strText = stItem.Text.ToString();
+	const float fCharIncrement = ( static_cast<float>( foFont->Kerning ) + stItem.HorizSpacingAdjust ) * stItem.Scale.X;
+	FVector2D v2Pen = FVector2D::ZeroVector;
+
+	for ( int32 i = 0; i < strText.Len(); ++i )
+	{
+		const TCHAR chChar = strText[ i ];
+
+		if ( chChar == '\n' )
+		{
+			v2Pen.X = 0.f;
+			v2Pen.Y += foFont->GetMaxCharHeight() * stItem.Scale.Y;
+			continue;
+		}
+
+		const int32 iCharIndex = foFont->RemapChar( chChar );
+
+		if ( !foFont->Characters.IsValidIndex( iCharIndex ) )
+			continue;
+
+		const FFontCharacter& stChar = foFont->Characters[ iCharIndex ];
+
+		if ( !foFont->Textures.IsValidIndex( stChar.TextureIndex ) || foFont->Textures[ stChar.TextureIndex ] == NULL )
+			continue;
+
+		UTexture2D* const tFontTexture = foFont->Textures[ stChar.TextureIndex ];
+
+		// Glyphs on a different font page start a new batch.
+		if ( tFontTexture->Resource != tBatchTexture )
+		{
+			if ( arBatchTriangles.Num() > 0 )
+			{
+				FlushText();
+				oBatchCanvas = oCanvas;
+				eBatchBlendMode = stItem.BlendMode;
+			}
+
+			tBatchTexture = tFontTexture->Resource;
+		}
+
+		const FIntPoint v2TextureSize = tFontTexture->GetImportedSize();
+		const FVector2D v2InvTextureSize( 1.f / static_cast<float>( v2TextureSize.X ), 1.f / static_cast<float>( v2TextureSize.Y ) );
+
+		const FVector2D v2Min( v2Location.X + v2Pen.X, v2Location.Y + v2Pen.Y + stChar.VerticalOffset * stItem.Scale.Y );
+		const FVector2D v2Max( v2Min.X + stChar.USize * stItem.Scale.X, v2Min.Y + stChar.VSize * stItem.Scale.Y );
+		const FVector2D v2UVMin( stChar.StartU * v2InvTextureSize.X, stChar.StartV * v2InvTextureSize.Y );
+		const FVector2D v2UVMax( v2UVMin.X + stChar.USize * v2InvTextureSize.X, v2UVMin.Y + stChar.VSize * v2InvTextureSize.Y );
+
+		FCanvasUVTri stTriangle;
+		stTriangle.V0_Color = lcColor;
+		stTriangle.V1_Color = lcColor;
+		stTriangle.V2_Color = lcColor;
+
+		stTriangle.V0_Pos = v2Min;
+		stTriangle.V0_UV = v2UVMin;
+		stTriangle.V1_Pos = FVector2D( v2Max.X, v2Min.Y );
+		stTriangle.V1_UV = FVector2D( v2UVMax.X, v2UVMin.Y );
+		stTriangle.V2_Pos = v2Max;
+		stTriangle.V2_UV = v2UVMax;
+		arBatchTriangles.Add( stTriangle );
+
+		stTriangle.V1_Pos = v2Max;
+		stTriangle.V1_UV = v2UVMax;
+		stTriangle.V2_Pos = FVector2D( v2Min.X, v2Max.Y );
+		stTriangle.V2_UV = FVector2D( v2UVMin.X, v2UVMax.Y );
+		arBatchTriangles.Add( stTriangle );
+
+		stBatchBounds += v2Min;
+		stBatchBounds += v2Max;
+
+		float fAdvance = stChar.USize * stItem.Scale.X;
+
+		if ( i + 1 < strText.Len() && !FChar::IsWhitespace( strText[ i + 1 ] ) )
+			fAdvance += fCharIncrement;
+
+		v2Pen.X += fAdvance;
+	}
+}
+
+
+FKUIRecordingRenderBackend::FKUIRecordingRenderBackend()
+{
+	arDrawCalls.SetNum( 0 );
+}
+
+
+void FKUIRecordingRenderBackend::SubmitItem( UCanvas* oCanvas, FCanvasItem& stItem, const FVector2D& v2Size, const FTexture* tTexture )
+{
+	Record( EKUIDrawCallType::DC_Item, stItem.Position, stItem.Position + v2Size, tTexture, stItem.BlendMode );
+}
+
+
+void FKUIRecordingRenderBackend::SubmitTile( UCanvas* oCanvas, float fX, float fY, float fSizeX, float fSizeY, float fU, float fV, float fSizeU, float fSizeV,
+	const FLinearColor& lcColor, const FTexture* tTexture, bool bAlphaBlend )
+{
+	Record( EKUIDrawCallType::DC_Tile, FVector2D( fX, fY ), FVector2D( fX + fSizeX, fY + fSizeY ), tTexture, bAlphaBlend ? SE_BLEND_Translucent : SE_BLEND_Opaque );
+}
+
+
+void FKUIRecordingRenderBackend::SubmitIcon( UCanvas* oCanvas, const FCanvasIcon& stIcon, float fX, float fY, float fScale )
+{
+	const FVector2D v2Size( stIcon.UL * fScale, stIcon.VL * fScale );
+
+	Record( EKUIDrawCallType::DC_Icon, FVector2D( fX, fY ), FVector2D( fX, fY ) + v2Size, stIcon.Texture != NULL ? stIcon.Texture->Resource : NULL, SE_BLEND_Translucent );
+}
+
+
+bool FKUIRecordingRenderBackend::CanRenderToTarget() const
+{
+	return false;
+}
+
+
+const TArray<FKUIDrawCall>& FKUIRecordingRenderBackend::GetDrawCalls() const
+{
+	return arDrawCalls;
+}
+
+
+int32 FKUIRecordingRenderBackend::GetDrawCallCount( EKUIDrawCallType::Type eType ) const
+{
+	int32 iCount = 0;
+
+	for ( int32 i = 0; i < arDrawCalls.Num(); ++i )
+		if ( arDrawCalls[ i ].eType == eType )
+			++iCount;
+
+	return iCount;
+}
+
+
+void FKUIRecordingRenderBackend::Reset()
+{
+	arDrawCalls.Reset();
+}
+
+
+void FKUIRecordingRenderBackend::Record( EKUIDrawCallType::Type eType, const FVector2D& v2Min, const FVector2D& v2Max, const FTexture* tTexture, ESimpleElementBlendMode eBlendMode )
+{
+	FKUIDrawCall stDrawCall;
+	stDrawCall.eType = eType;
+	stDrawCall.v2Min = v2Min;
+	stDrawCall.v2Max = v2Max;
+	stDrawCall.tTexture = tTexture;
+	stDrawCall.eBlendMode = eBlendMode;
+
+	arDrawCalls.Add( stDrawCall );
+}
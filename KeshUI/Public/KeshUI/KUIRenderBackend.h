@@ -0,0 +1,151 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+class AKUIInterface;
+class UCanvas;
+class FCanvasItem;
+class FCanvasTextItem;
+class FTexture;
+struct FCanvasIcon;
+
+namespace EKUIDrawCallType
+{
+	enum Type
+	{
+		DC_Item,
+		DC_Tile,
+		DC_Icon,
+		DC_Max
+	};
+}
+
+/* A draw call captured by the recording backend. */
+struct FKUIDrawCall
+{
+	EKUIDrawCallType::Type eType;
+	FVector2D v2Min;
+	FVector2D v2Max;
+	const FTexture* tTexture;
+	ESimpleElementBlendMode eBlendMode;
+};
+
+
+/**
+ * Everything the interface draws goes through a backend.  The default issues the draws to the canvas;
+ * subclasses can capture them instead, so the element tree can be driven without a renderer.
+ *
+ * Text is merged: consecutive text items that use the same font texture and blend mode have their
+ * glyph quads collected into one triangle list, which is submitted when anything else is drawn, the
+ * texture or canvas changes or the batch is flushed.  Draw order is unchanged.
+ */
+class KESHUI_API FKUIRenderBackend
+{
+
+public:
+
+	FKUIRenderBackend();
+
+	virtual ~FKUIRenderBackend();
+
+	/* Returns the interface's backend, or the canvas backend if there's no interface. */
+	static FKUIRenderBackend& Get( AKUIInterface* aHud );
+
+	/* Draws a canvas item covering the given size. */
+	void DrawItem( UCanvas* oCanvas, FCanvasItem& stItem, const FVector2D& v2Size, const FTexture* tTexture = NULL );
+
+	/* Draws a portion of a texture. */
+	void DrawTile( UCanvas* oCanvas, float fX, float fY, float fSizeX, float fSizeY, float fU, float fV, float fSizeU, float fSizeV,
+		const FLinearColor& lcColor, const FTexture* tTexture, bool bAlphaBlend );
+
+	/* Draws an icon. */
+	void DrawIcon( UCanvas* oCanvas, const FCanvasIcon& stIcon, float fX, float fY, float fScale );
+
+	/* Draws a text item, merging it with the text drawn before it where possible. */
+	void DrawTextItem( UCanvas* oCanvas, FCanvasTextItem& stItem, const FVector2D& v2Size );
+
+	/* Submits any merged text.  Must be called before the canvas it was drawn to is finished with. */
+	void FlushText();
+
+	/* Returns true if text is merged. */
+	bool IsBatchingText() const;
+
+	/* Sets whether text is merged.  Flushes the current batch. */
+	void SetBatchingText( bool bBatchText );
+
+	/* Returns the number of text items drawn and the number of submissions they took since the last reset. */
+	void GetTextBatchStats( int32& iTextItems, int32& iTextSubmissions ) const;
+
+	/* Resets the text batching counters. */
+	void ResetTextBatchStats();
+
+	/* Returns true if render caches can draw into render targets. */
+	virtual bool CanRenderToTarget() const;
+
+protected:
+
+	bool bBatchText;
+	UCanvas* oBatchCanvas;
+	const FTexture* tBatchTexture;
+	ESimpleElementBlendMode eBatchBlendMode;
+	TArray<FCanvasUVTri> arBatchTriangles;
+	FBox2D stBatchBounds;
+	int32 iTextItems;
+	int32 iTextSubmissions;
+
+	/* Issues a canvas item. */
+	virtual void SubmitItem( UCanvas* oCanvas, FCanvasItem& stItem, const FVector2D& v2Size, const FTexture* tTexture );
+
+	/* Issues a tile. */
+	virtual void SubmitTile( UCanvas* oCanvas, float fX, float fY, float fSizeX, float fSizeY, float fU, float fV, float fSizeU, float fSizeV,
+		const FLinearColor& lcColor, const FTexture* tTexture, bool bAlphaBlend );
+
+	/* Issues an icon. */
+	virtual void SubmitIcon( UCanvas* oCanvas, const FCanvasIcon& stIcon, float fX, float fY, float fScale );
+
+	/* Returns true if the text item's glyphs can be generated here rather than by the canvas. */
+	virtual bool CanBatchText( const FCanvasTextItem& stItem ) const;
+
+	/* Adds quads for one pass of a text item at the given location. */
+	void AddTextQuads( UCanvas* oCanvas, const FCanvasTextItem& stItem, const FVector2D& v2Location, const FLinearColor& lcColor );
+
+};
+
+
+/**
+ * Captures draw calls into a buffer instead of issuing them.  Render caches are drawn straight
+ * through, so every element is still visited.
+ */
+class KESHUI_API FKUIRecordingRenderBackend : public FKUIRenderBackend
+{
+
+public:
+
+	FKUIRecordingRenderBackend();
+
+	virtual bool CanRenderToTarget() const override;
+
+	/* Returns the draw calls captured since the last reset. */
+	const TArray<FKUIDrawCall>& GetDrawCalls() const;
+
+	/* Returns the number of captured draw calls of the given type. */
+	int32 GetDrawCallCount( EKUIDrawCallType::Type eType ) const;
+
+	/* Clears the captured draw calls, keeping the buffer. */
+	void Reset();
+
+protected:
+
+	TArray<FKUIDrawCall> arDrawCalls;
+
+	virtual void SubmitItem( UCanvas* oCanvas, FCanvasItem& stItem, const FVector2D& v2Size, const FTexture* tTexture ) override;
+
+	virtual void SubmitTile( UCanvas* oCanvas, float fX, float fY, float fSizeX, float fSizeY, float fU, float fV, float fSizeU, float fSizeV,
+		const FLinearColor& lcColor, const FTexture* tTexture, bool bAlphaBlend ) override;
+
+	virtual void SubmitIcon( UCanvas* oCanvas, const FCanvasIcon& stIcon, float fX, float fY, float fScale ) override;
+
+	/* Adds a draw call to the buffer. */
+	void Record( EKUIDrawCallType::Type eType, const FVector2D& v2Min, const FVector2D& v2Max, const FTexture* tTexture, ESimpleElementBlendMode eBlendMode );
+
+};
@@ -2,6 +2,9 @@
 
 #include "KeshUI/KeshUI.h"
 #include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/KUIRenderTargetPool.h"
+#include "KeshUI/KUIRenderBackend.h"
 #include "KeshUI/KUIRenderCache.h"
 
 
@@ -9,20 +12,44 @@ UKUIRenderCache::UKUIRenderCache( const class FObjectInitializer& oObjectInitial
 : Super( oObjectInitializer )
 {
 	bValidRenderCache = false;
+	stDirtyRect = FBox2D( 0 );
+	stRedrawRect = FBox2D( 0 );
+	v2RenderOrigin = FVector2D::ZeroVector;
+	arDirtyElements.SetNum( 0 );
 }
 
 
 void UKUIRenderCache::DestroyRenderCache()
 {
+	if ( GetTexture() != NULL && GetTexture()->IsA<UTextureRenderTarget2D>() )
+		ReleaseRenderTarget( Cast<UTextureRenderTarget2D>( GetTexture() ) );
+
 	SetTexture( NULL );
 	bValidRenderCache = false;
 }
 
 
+void UKUIRenderCache::ReleaseRenderCache()
+{
+	DestroyRenderCache();
+}
+
+
 void UKUIRenderCache::CreateRenderCache( const FVector2D& v2Size )
 {
 	DestroyRenderCache();
 
+	SetTexture( CreateRenderTarget( v2Size ) );
+}
+
+
+UTextureRenderTarget2D* UKUIRenderCache::CreateRenderTarget( const FVector2D& v2Size )
+{
+	UKUIRenderTargetPool* const oPool = GetRenderTargetPool();
+
+	if ( oPool != NULL )
+		return oPool->LeaseRenderTarget( v2Size );
+
 	UTextureRenderTarget2D* const tRenderTarget = NewObject<UTextureRenderTarget2D>( this );
 	tRenderTarget->bNeedsTwoCopies = false;
 	tRenderTarget->InitAutoFormat( floor( v2Size.X ), floor( v2Size.Y ) );
@@ -33,12 +60,48 @@ void UKUIRenderCache::CreateRenderCache( const FVector2D& v2Size )
 	tRenderTarget->LODGroup = TextureGroup::TEXTUREGROUP_UI;
 	tRenderTarget->UpdateResourceImmediate();
 
-	SetTexture( tRenderTarget );
+	return tRenderTarget;
+}
+
+
+void UKUIRenderCache::ReleaseRenderTarget( UTextureRenderTarget2D* tRenderTarget )
+{
+	if ( tRenderTarget == NULL )
+		return;
+
+	UKUIRenderTargetPool* const oPool = GetRenderTargetPool();
+
+	if ( oPool != NULL && tRenderTarget->GetOuter() == oPool )
+		oPool->ReturnRenderTarget( tRenderTarget );
+}
+
+
+FIntPoint UKUIRenderCache::GetRenderTargetSize( const FVector2D& v2Size ) const
+{
+	UKUIRenderTargetPool* const oPool = GetRenderTargetPool();
+
+	if ( oPool != NULL )
+		return oPool->GetBucketSize( v2Size );
+
+	return FIntPoint( floor( v2Size.X ), floor( v2Size.Y ) );
+}
+
+
+UKUIRenderTargetPool* UKUIRenderCache::GetRenderTargetPool() const
+{
+	AKUIInterface* const aInterface = GetInterface();
+
+	if ( aInterface == NULL )
+		return NULL;
+
+	return aInterface->GetRenderTargetPool();
 }
 
 
 void UKUIRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElement )
 {
+	SCOPE_CYCLE_COUNTER( STAT_KUIRenderCacheUpdate );
+
 	if ( oElement == NULL )
 	{
 		KUIErrorUO( "Trying to update render cache of null element" );
@@ -60,7 +123,16 @@ void UKUIRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElement )
 		}
 
 		SetSizeStruct( v2ElemSize );
-		CreateRenderCache( v2ElemSize );
+
+		// Pooled targets are rounded up, so small size changes can reuse the current one.
+		UTextureRenderTarget2D* const tCurrentTarget = Cast<UTextureRenderTarget2D>( GetTexture() );
+		const FIntPoint v2TargetSize = GetRenderTargetSize( v2ElemSize );
+
+		if ( tCurrentTarget != NULL && tCurrentTarget->SizeX == v2TargetSize.X && tCurrentTarget->SizeY == v2TargetSize.Y )
+			InvalidateRenderCache();
+
+		else
+			CreateRenderCache( v2ElemSize );
 	}
 
 	if ( GetTexture() == NULL )
@@ -79,17 +151,86 @@ void UKUIRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElement )
 	//tRenderTarget->UpdateResource();
 	//tRenderTarget->UpdateResourceImmediate();
 
-	UCanvas* uoCanvas = Cast<UCanvas>( StaticFindObjectFast( UCanvas::StaticClass(), GetTransientPackage(), FName( TEXT( "Render Cache Canvas" ) ) ) );
+	if ( bValidRenderCache )
+		UpdateDirtyElements( oElement );
+
+	// Only redraw the dirty area if the rest of the cache is still good.
+	if ( bValidRenderCache )
+	{
+		stRedrawRect = FBox2D( FVector2D::ZeroVector, v2ElemSize );
+
+		if ( stDirtyRect.bIsValid && stRedrawRect.Intersect( stDirtyRect ) )
+		{
+			stRedrawRect.Min.X = max( stRedrawRect.Min.X, stDirtyRect.Min.X );
+			stRedrawRect.Min.Y = max( stRedrawRect.Min.Y, stDirtyRect.Min.Y );
+			stRedrawRect.Max.X = min( stRedrawRect.Max.X, stDirtyRect.Max.X );
+			stRedrawRect.Max.Y = min( stRedrawRect.Max.Y, stDirtyRect.Max.Y );
+
+			//KUILogDebugUO( "Updating render cache rect" );
+			RenderToTarget( oElement, tRenderTarget, FVector2D::ZeroVector, FName( TEXT( "Render Cache Canvas" ) ) );
+		}
+	}
+
+	else
+	{
+		stRedrawRect = FBox2D( 0 );
+
+		//KUILogDebugUO( "Updating render cache" );
+		RenderToTarget( oElement, tRenderTarget, FVector2D::ZeroVector, FName( TEXT( "Render Cache Canvas" ) ) );
+	}
+
+	stDirtyRect = FBox2D( 0 );
+	stRedrawRect = FBox2D( 0 );
+	arDirtyElements.Reset();
+	bValidRenderCache = true;
+}
+
+
+void UKUIRenderCache::RenderToTarget( UKUIInterfaceElement* oElement, UTextureRenderTarget2D* tRenderTarget, const FVector2D& v2Origin, const FName& nCanvasName )
+{
+	if ( oElement == NULL || tRenderTarget == NULL )
+	{
+		KUIErrorUO( "Null element or render target" );
+		return;
+	}
+
+	v2RenderOrigin = v2Origin;
+
+	UCanvas* uoCanvas = Cast<UCanvas>( StaticFindObjectFast( UCanvas::StaticClass(), GetTransientPackage(), nCanvasName ) );
 
 	if ( uoCanvas == NULL )
 	{
-		uoCanvas = NewObject<UCanvas>( GetTransientPackage(), FName( TEXT( "Render Cache Canvas" ) ) );
+		uoCanvas = NewObject<UCanvas>( GetTransientPackage(), nCanvasName );
 		uoCanvas->AddToRoot();
 	}
 
-	uoCanvas->Init( floor( v2Size.X ), floor( v2Size.Y ), NULL );
+	FKUIRenderBackend& stBackend = FKUIRenderBackend::Get( GetInterface() );
+
+	// Nested caches share the canvas, so text merged for the outer target is drawn before it's pointed at this one.
+	stBackend.FlushText();
+
+	FCanvas* const oOuterCanvas = uoCanvas->Canvas;
+	FSceneView* const oOuterSceneView = uoCanvas->SceneView;
+	const int32 iOuterSizeX = uoCanvas->SizeX;
+	const int32 iOuterSizeY = uoCanvas->SizeY;
+
+	uoCanvas->Init( tRenderTarget->SizeX, tRenderTarget->SizeY, NULL );
 	uoCanvas->Update();
 
+	// Without a renderer the elements are still visited, but nothing reaches the target.
+	if ( !FKUIRenderBackend::Get( GetInterface() ).CanRenderToTarget() )
+	{
+		uoCanvas->Canvas = NULL;
+		oElement->Render( GetInterface(), uoCanvas, v2Origin, oElement );
+		stBackend.FlushText();
+
+		uoCanvas->Init( iOuterSizeX, iOuterSizeY, oOuterSceneView );
+		uoCanvas->Update();
+		uoCanvas->Canvas = oOuterCanvas;
+		stBackend.FlushText();
+		return;
+	}
+
 	ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
 		RenderCacheRenderTargetMakeCurrentCommand,
 		FTextureRenderTarget2DResource*,
@@ -104,12 +245,34 @@ void UKUIRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElement )
 
 	FCanvas oCanvas( tRenderTarget->GameThread_GetRenderTargetResource(), NULL, GetWorld(), GetInterface()->GetWorld()->FeatureLevel );
 	uoCanvas->Canvas = &oCanvas;
-	oCanvas.Clear( tRenderTarget->ClearColor );
 
-	//KUILogDebugUO( "Updating render cache" );
-	oElement->Render( GetInterface(), uoCanvas, FVector2D::ZeroVector, oElement );
+	// Partial redraws are masked to the redraw area, which is cleared rather than the whole target.
+	if ( stRedrawRect.bIsValid )
+	{
+		const FVector2D v2RedrawLocation = v2Origin + stRedrawRect.Min;
+		const FVector2D v2RedrawSize = stRedrawRect.Max - stRedrawRect.Min;
+
+		oCanvas.PushMaskRegion( v2RedrawLocation.X, v2RedrawLocation.Y, v2RedrawSize.X, v2RedrawSize.Y );
+
+		FCanvasTileItem stClearItem( v2RedrawLocation, GWhiteTexture, v2RedrawSize, tRenderTarget->ClearColor );
+		stClearItem.BlendMode = SE_BLEND_Opaque;
+		oCanvas.DrawItem( stClearItem );
+	}
+
+	else
+		oCanvas.Clear( tRenderTarget->ClearColor );
+
+	oElement->Render( GetInterface(), uoCanvas, v2Origin, oElement );
+	stBackend.FlushText();
 
-	uoCanvas->Canvas = NULL;
+	if ( stRedrawRect.bIsValid )
+		oCanvas.PopMaskRegion();
+
+	// Give the outer cache its canvas back.
+	uoCanvas->Init( iOuterSizeX, iOuterSizeY, oOuterSceneView );
+	uoCanvas->Update();
+	uoCanvas->Canvas = oOuterCanvas;
+	stBackend.FlushText();
 	
 	if ( IsInGameThread() )
 		oCanvas.Flush_GameThread();
@@ -129,14 +292,12 @@ void UKUIRenderCache::UpdateRenderCache( UKUIInterfaceElement* oElement )
 			RHICmdList.CopyToResolveTarget( RenderTargetResource->GetRenderTargetTexture(), RenderTargetResource->TextureRHI, true, FResolveParams() );
 		}
 	)
-
-	bValidRenderCache = true;
 }
 
 
 bool UKUIRenderCache::IsRenderCacheValid() const
 {
-	return bValidRenderCache;
+	return ( bValidRenderCache && !stDirtyRect.bIsValid && arDirtyElements.Num() == 0 );
 }
 
 
@@ -146,6 +307,149 @@ void UKUIRenderCache::InvalidateRenderCache()
 }
 
 
+void UKUIRenderCache::InvalidateRenderCacheRect( const FVector2D& v2Min, const FVector2D& v2Max )
+{
+	// The whole thing is being redrawn anyway.
+	if ( !bValidRenderCache )
+		return;
+
+	if ( v2Max.X <= v2Min.X || v2Max.Y <= v2Min.Y )
+		return;
+
+	stDirtyRect += FBox2D( v2Min, v2Max );
+}
+
+
+void UKUIRenderCache::InvalidateRenderCacheElement( UKUIInterfaceElement* oElement )
+{
+	if ( !bValidRenderCache )
+		return;
+
+	if ( oElement == NULL )
+	{
+		InvalidateRenderCache();
+		return;
+	}
+
+	const FBox2D& stLastRect = oElement->GetLastRenderCacheRect();
+
+	if ( stLastRect.bIsValid )
+		InvalidateRenderCacheRect( stLastRect.Min, stLastRect.Max );
+
+	arDirtyElements.AddUnique( oElement );
+
+	// Children of containers that don't cache themselves move with them.
+	UKUIInterfaceContainer* const ctContainer = Cast<UKUIInterfaceContainer>( oElement );
+
+	if ( ctContainer == NULL || ctContainer->IsRenderCaching() )
+		return;
+
+	for ( TArray<UKUIInterfaceElement*>::TIterator itChildren = ctContainer->GetChildIterator(); itChildren; ++itChildren )
+	{
+		if ( *itChildren == NULL )
+			continue;
+
+		InvalidateRenderCacheElement( *itChildren );
+	}
+}
+
+
+bool UKUIRenderCache::ShouldRedraw( UKUIInterfaceElement* oElement, const FVector2D& v2Origin ) const
+{
+	if ( !stRedrawRect.bIsValid )
+		return true;
+
+	if ( oElement == NULL )
+		return false;
+
+	// Children of non-caching containers can be drawn outside of it.
+	if ( oElement->IsA<UKUIInterfaceContainer>() && !oElement->IsRenderCaching() )
+		return true;
+
+	const FVector2D v2Size = oElement->GetSize();
+
+	if ( v2Size.X <= 0.f || v2Size.Y <= 0.f )
+		return true;
+
+	const FVector2D v2Location = v2Origin + oElement->GetRenderLocation() - v2RenderOrigin;
+
+	return ( v2Location.X < stRedrawRect.Max.X &&
+			 v2Location.Y < stRedrawRect.Max.Y &&
+			 ( v2Location.X + v2Size.X ) > stRedrawRect.Min.X &&
+			 ( v2Location.Y + v2Size.Y ) > stRedrawRect.Min.Y );
+}
+
+
+const FVector2D& UKUIRenderCache::GetRenderOrigin() const
+{
+	return v2RenderOrigin;
+}
+
+
+void UKUIRenderCache::UpdateDirtyElements( UKUIInterfaceElement* oOwner )
+{
+	for ( int32 i = 0; i < arDirtyElements.Num(); ++i )
+	{
+		UKUIInterfaceElement* const oElement = arDirtyElements[ i ].Get();
+
+		if ( oElement == NULL || !oElement->IsVisible() )
+			continue;
+
+		if ( oElement == oOwner )
+		{
+			InvalidateRenderCache();
+			break;
+		}
+
+		const FBox2D stRect = GetElementRect( oOwner, oElement );
+
+		if ( stRect.bIsValid )
+		{
+			InvalidateRenderCacheRect( stRect.Min, stRect.Max );
+			continue;
+		}
+
+		// Zero sized containers' children are marked separately.
+		if ( oElement->IsA<UKUIInterfaceContainer>() )
+			continue;
+
+		// We can't tell what this covers, so redraw everything.
+		InvalidateRenderCache();
+		break;
+	}
+
+	arDirtyElements.Reset();
+}
+
+
+FBox2D UKUIRenderCache::GetElementRect( UKUIInterfaceElement* oOwner, UKUIInterfaceElement* oElement ) const
+{
+	const FVector2D v2Size = oElement->GetSize();
+
+	if ( v2Size.X <= 0.f || v2Size.Y <= 0.f )
+		return FBox2D( 0 );
+
+	FVector2D v2Location = GetContentOrigin( oOwner );
+	const UKUIInterfaceElement* oParent = oElement;
+
+	for ( ; oParent != NULL && oParent != oOwner; oParent = oParent->GetContainer() )
+		v2Location += oParent->GetRenderLocation();
+
+	// No longer in the cached element.
+	if ( oParent == NULL )
+		return FBox2D( 0 );
+
+	return FBox2D( v2Location, v2Location + v2Size );
+}
+
+
+FVector2D UKUIRenderCache::GetContentOrigin( UKUIInterfaceElement* oOwner ) const
+{
+	// Containers draw their children offset by their own render location.
+	return oOwner->GetRenderLocation();
+}
+
+
 void UKUIRenderCache::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVector2D& v2Origin, UKUIInterfaceElement* oRenderCacheObject )
 {
 	if ( GetTexture() == NULL )
@@ -162,15 +466,19 @@ void UKUIRenderCache::Render( AKUIInterface* aHud, UCanvas* oCanvas, const FVect
 
 	UTextureRenderTarget2D* const tRenderTarget = Cast<UTextureRenderTarget2D>( GetTexture() );
 
-	oCanvas->Canvas->DrawTile(
+	// The render target may be larger than the cached area.
+	const FVector2D v2UVScale( GetSize().X / tRenderTarget->SizeX, GetSize().Y / tRenderTarget->SizeY );
+
+	FKUIRenderBackend::Get( aHud ).DrawTile(
+		oCanvas,
 		v2Origin.X,
 		v2Origin.Y,
 		GetSize().X,
 		GetSize().Y,
-		GetTextureCoords().X,
-		GetTextureCoords().Y,
-		GetTextureCoords().X + GetTextureSize().X,
-		GetTextureCoords().Y + GetTextureSize().Y,
+		GetTextureCoords().X * v2UVScale.X,
+		GetTextureCoords().Y * v2UVScale.Y,
+		( GetTextureCoords().X + GetTextureSize().X ) * v2UVScale.X,
+		( GetTextureCoords().Y + GetTextureSize().Y ) * v2UVScale.Y,
 		GetDrawColor().ReinterpretAsLinear(),
 		tRenderTarget->Resource,
 		true
@@ -0,0 +1,201 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIRenderCacheTileGrid.h"
+
+
+FKUIRenderCacheTileGrid::FKUIRenderCacheTileGrid( int32 iTileSize, int32 iMargin )
+{
+	this->iTileSize = max( 1, iTileSize );
+	this->iMargin = max( 0, iMargin );
+	v2ContentSize = FVector2D::ZeroVector;
+	v2VisibleMin = FVector2D::ZeroVector;
+	v2VisibleMax = FVector2D::ZeroVector;
+	iColumns = 0;
+	iRows = 0;
+	arTiles.SetNum( 0 );
+	arFreeSlots.SetNum( 0 );
+	iSlotCount = 0;
+}
+
+
+void FKUIRenderCacheTileGrid::SetContentSize( const FVector2D& v2ContentSize )
+{
+	this->v2ContentSize = v2ContentSize;
+
+	const int32 iNewColumns = FMath::CeilToInt( v2ContentSize.X / static_cast<float>( iTileSize ) );
+	const int32 iNewRows = FMath::CeilToInt( v2ContentSize.Y / static_cast<float>( iTileSize ) );
+
+	if ( iNewColumns == iColumns && iNewRows == iRows )
+		return;
+
+	iColumns = iNewColumns;
+	iRows = iNewRows;
+
+	EvictAll();
+}
+
+
+void FKUIRenderCacheTileGrid::SetVisibleRegion( const FVector2D& v2Min, const FVector2D& v2Max )
+{
+	v2VisibleMin = v2Min;
+	v2VisibleMax = v2Max;
+
+	if ( iColumns == 0 || iRows == 0 || v2Max.X <= v2Min.X || v2Max.Y <= v2Min.Y )
+	{
+		EvictAll();
+		return;
+	}
+
+	const int32 iMinColumn = max( 0, floor( v2Min.X / iTileSize ) - iMargin );
+	const int32 iMinRow = max( 0, floor( v2Min.Y / iTileSize ) - iMargin );
+	const int32 iMaxColumn = min( iColumns - 1, floor( ( v2Max.X - 1.f ) / iTileSize ) + iMargin );
+	const int32 iMaxRow = min( iRows - 1, floor( ( v2Max.Y - 1.f ) / iTileSize ) + iMargin );
+
+	// Evict tiles that are no longer near the visible region.
+	for ( int32 i = arTiles.Num() - 1; i >= 0; --i )
+	{
+		const FKUIRenderCacheTile& stTile = arTiles[ i ];
+
+		if ( stTile.iColumn >= iMinColumn && stTile.iColumn <= iMaxColumn && stTile.iRow >= iMinRow && stTile.iRow <= iMaxRow )
+			continue;
+
+		arFreeSlots.Add( stTile.iSlot );
+		arTiles.RemoveAtSwap( i );
+	}
+
+	// Add the newly exposed tiles.
+	for ( int32 iRow = iMinRow; iRow <= iMaxRow; ++iRow )
+	{
+		for ( int32 iColumn = iMinColumn; iColumn <= iMaxColumn; ++iColumn )
+		{
+			bool bResident = false;
+
+			for ( int32 i = 0; i < arTiles.Num(); ++i )
+			{
+				if ( arTiles[ i ].iColumn != iColumn || arTiles[ i ].iRow != iRow )
+					continue;
+
+				bResident = true;
+				break;
+			}
+
+			if ( bResident )
+				continue;
+
+			FKUIRenderCacheTile stTile;
+			stTile.iColumn = iColumn;
+			stTile.iRow = iRow;
+			stTile.bValid = false;
+
+			if ( arFreeSlots.Num() > 0 )
+				stTile.iSlot = arFreeSlots.Pop();
+
+			else
+			{
+				stTile.iSlot = iSlotCount;
+				++iSlotCount;
+			}
+
+			arTiles.Add( stTile );
+		}
+	}
+}
+
+
+void FKUIRenderCacheTileGrid::InvalidateRect( const FVector2D& v2Min, const FVector2D& v2Max )
+{
+	if ( v2Max.X <= v2Min.X || v2Max.Y <= v2Min.Y )
+		return;
+
+	for ( int32 i = 0; i < arTiles.Num(); ++i )
+	{
+		const FVector2D v2TileMin = GetTileOrigin( arTiles[ i ] );
+
+		if ( v2Max.X <= v2TileMin.X || v2Max.Y <= v2TileMin.Y )
+			continue;
+
+		if ( v2Min.X >= v2TileMin.X + iTileSize || v2Min.Y >= v2TileMin.Y + iTileSize )
+			continue;
+
+		arTiles[ i ].bValid = false;
+	}
+}
+
+
+void FKUIRenderCacheTileGrid::InvalidateAll()
+{
+	for ( int32 i = 0; i < arTiles.Num(); ++i )
+		arTiles[ i ].bValid = false;
+}
+
+
+void FKUIRenderCacheTileGrid::ValidateTile( int32 iIndex )
+{
+	if ( !arTiles.IsValidIndex( iIndex ) )
+		return;
+
+	arTiles[ iIndex ].bValid = true;
+}
+
+
+bool FKUIRenderCacheTileGrid::HasInvalidTiles() const
+{
+	for ( int32 i = 0; i < arTiles.Num(); ++i )
+		if ( !arTiles[ i ].bValid )
+			return true;
+
+	return false;
+}
+
+
+bool FKUIRenderCacheTileGrid::IsVisibleRegionChanged( const FVector2D& v2Min, const FVector2D& v2Max ) const
+{
+	return ( v2Min != v2VisibleMin || v2Max != v2VisibleMax );
+}
+
+
+const TArray<FKUIRenderCacheTile>& FKUIRenderCacheTileGrid::GetTiles() const
+{
+	return arTiles;
+}
+
+
+FVector2D FKUIRenderCacheTileGrid::GetTileOrigin( const FKUIRenderCacheTile& stTile ) const
+{
+	return FVector2D( stTile.iColumn * iTileSize, stTile.iRow * iTileSize );
+}
+
+
+int32 FKUIRenderCacheTileGrid::GetTileSize() const
+{
+	return iTileSize;
+}
+
+
+int32 FKUIRenderCacheTileGrid::GetSlotCount() const
+{
+	return iSlotCount;
+}
+
+
+void FKUIRenderCacheTileGrid::Reset()
+{
+	arTiles.SetNum( 0 );
+	arFreeSlots.SetNum( 0 );
+	iSlotCount = 0;
+	iColumns = 0;
+	iRows = 0;
+	v2ContentSize = FVector2D::ZeroVector;
+	v2VisibleMin = FVector2D::ZeroVector;
+	v2VisibleMax = FVector2D::ZeroVector;
+}
+
+
+void FKUIRenderCacheTileGrid::EvictAll()
+{
+	for ( int32 i = 0; i < arTiles.Num(); ++i )
+		arFreeSlots.Add( arTiles[ i ].iSlot );
+
+	arTiles.SetNum( 0 );
+}
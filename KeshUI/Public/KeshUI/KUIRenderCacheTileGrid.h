@@ -0,0 +1,82 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#define KUI_RENDER_CACHE_TILE_SIZE 256
+#define KUI_RENDER_CACHE_TILE_MARGIN 1
+
+/* A resident tile of a tiled render cache. */
+struct FKUIRenderCacheTile
+{
+	int32 iColumn;
+	int32 iRow;
+	int32 iSlot;
+	bool bValid;
+};
+
+/**
+ * Keeps track of which fixed-size tiles of a large content area are resident, which pool slot
+ * holds each one and whether it needs redrawing.  Only the tiles covering the visible region,
+ * plus a margin, are kept, so the number of slots is bounded by the size of the viewport.
+ * Has no rendering dependencies; the owner maps slots to render targets.
+ */
+class KESHUI_API FKUIRenderCacheTileGrid
+{
+
+public:
+
+	FKUIRenderCacheTileGrid( int32 iTileSize = KUI_RENDER_CACHE_TILE_SIZE, int32 iMargin = KUI_RENDER_CACHE_TILE_MARGIN );
+
+	/* Sets the size of the tiled content.  Evicts all tiles if the tile layout changes. */
+	void SetContentSize( const FVector2D& v2ContentSize );
+
+	/* Makes the tiles around the visible region resident and evicts the rest. */
+	void SetVisibleRegion( const FVector2D& v2Min, const FVector2D& v2Max );
+
+	/* Marks the resident tiles overlapping the rect for redrawing. */
+	void InvalidateRect( const FVector2D& v2Min, const FVector2D& v2Max );
+
+	/* Marks all resident tiles for redrawing. */
+	void InvalidateAll();
+
+	/* Marks a tile as redrawn. */
+	void ValidateTile( int32 iIndex );
+
+	/* Returns true if any resident tile needs redrawing. */
+	bool HasInvalidTiles() const;
+
+	/* Returns true if the visible region is different to the one last set. */
+	bool IsVisibleRegionChanged( const FVector2D& v2Min, const FVector2D& v2Max ) const;
+
+	/* Returns the resident tiles. */
+	const TArray<FKUIRenderCacheTile>& GetTiles() const;
+
+	/* Returns the content location of the top left of a tile. */
+	FVector2D GetTileOrigin( const FKUIRenderCacheTile& stTile ) const;
+
+	/* Returns the width and height of the tiles. */
+	int32 GetTileSize() const;
+
+	/* Returns the number of slots that have ever been handed out. */
+	int32 GetSlotCount() const;
+
+	/* Evicts all tiles and forgets all slots. */
+	void Reset();
+
+protected:
+
+	int32 iTileSize;
+	int32 iMargin;
+	FVector2D v2ContentSize;
+	FVector2D v2VisibleMin;
+	FVector2D v2VisibleMax;
+	int32 iColumns;
+	int32 iRows;
+	TArray<FKUIRenderCacheTile> arTiles;
+	TArray<int32> arFreeSlots;
+	int32 iSlotCount;
+
+	/* Moves all the resident tiles to the free list. */
+	void EvictAll();
+
+};
@@ -0,0 +1,217 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIRenderTargetPool.h"
+
+
+UKUIRenderTargetPool::UKUIRenderTargetPool( const class FObjectInitializer& oObjectInitializer )
+: Super( oObjectInitializer )
+{
+	iMemoryBudget = KUI_RENDER_TARGET_POOL_BUDGET;
+	iReturnCounter = 0;
+	arFreeTargets.SetNum( 0 );
+	arFreeReturned.SetNum( 0 );
+	arLeasedTargets.SetNum( 0 );
+	iLeases = 0;
+	iHits = 0;
+	iEvictions = 0;
+}
+
+
+UTextureRenderTarget2D* UKUIRenderTargetPool::LeaseRenderTarget( const FVector2D& v2Size )
+{
+	const FIntPoint v2BucketSize = GetBucketSize( v2Size );
+
+	++iLeases;
+
+	// Use the most recently returned target of the right size, it's the least likely to be evicted next.
+	int32 iBestIndex = INDEX_NONE;
+
+	for ( int32 i = 0; i < arFreeTargets.Num(); ++i )
+	{
+		if ( arFreeTargets[ i ] == NULL )
+			continue;
+
+		if ( arFreeTargets[ i ]->SizeX != v2BucketSize.X || arFreeTargets[ i ]->SizeY != v2BucketSize.Y )
+			continue;
+
+		if ( iBestIndex == INDEX_NONE || arFreeReturned[ i ] > arFreeReturned[ iBestIndex ] )
+			iBestIndex = i;
+	}
+
+	UTextureRenderTarget2D* tRenderTarget = NULL;
+
+	if ( iBestIndex != INDEX_NONE )
+	{
+		++iHits;
+
+		tRenderTarget = arFreeTargets[ iBestIndex ];
+		arFreeTargets.RemoveAtSwap( iBestIndex );
+		arFreeReturned.RemoveAtSwap( iBestIndex );
+	}
+
+	else
+		tRenderTarget = CreateRenderTarget( v2BucketSize );
+
+	PruneLeasedTargets();
+	arLeasedTargets.Add( tRenderTarget );
+
+	TrimToBudget();
+
+	return tRenderTarget;
+}
+
+
+void UKUIRenderTargetPool::ReturnRenderTarget( UTextureRenderTarget2D* tRenderTarget )
+{
+	if ( tRenderTarget == NULL )
+		return;
+
+	const int32 iIndex = arLeasedTargets.Find( tRenderTarget );
+
+	if ( iIndex == INDEX_NONE )
+	{
+		KUIErrorUO( "Returning a render target that was not leased from this pool" );
+		return;
+	}
+
+	arLeasedTargets.RemoveAtSwap( iIndex );
+
+	++iReturnCounter;
+	arFreeTargets.Add( tRenderTarget );
+	arFreeReturned.Add( iReturnCounter );
+
+	TrimToBudget();
+}
+
+
+FIntPoint UKUIRenderTargetPool::GetBucketSize( const FVector2D& v2Size ) const
+{
+	const int32 iWidth = max( 1, FMath::CeilToInt( v2Size.X ) );
+	const int32 iHeight = max( 1, FMath::CeilToInt( v2Size.Y ) );
+
+	return FIntPoint(
+		( ( iWidth + KUI_RENDER_TARGET_POOL_GRANULARITY - 1 ) / KUI_RENDER_TARGET_POOL_GRANULARITY ) * KUI_RENDER_TARGET_POOL_GRANULARITY,
+		( ( iHeight + KUI_RENDER_TARGET_POOL_GRANULARITY - 1 ) / KUI_RENDER_TARGET_POOL_GRANULARITY ) * KUI_RENDER_TARGET_POOL_GRANULARITY
+	);
+}
+
+
+int64 UKUIRenderTargetPool::GetMemoryBudget() const
+{
+	return iMemoryBudget;
+}
+
+
+void UKUIRenderTargetPool::SetMemoryBudget( int64 iMemoryBudget )
+{
+	this->iMemoryBudget = max( 0, iMemoryBudget );
+
+	TrimToBudget();
+}
+
+
+void UKUIRenderTargetPool::Flush()
+{
+	iEvictions += arFreeTargets.Num();
+
+	arFreeTargets.SetNum( 0 );
+	arFreeReturned.SetNum( 0 );
+}
+
+
+FKUIRenderTargetPoolStats UKUIRenderTargetPool::GetStats() const
+{
+	FKUIRenderTargetPoolStats stStats;
+	stStats.iBytesHeld = 0;
+	stStats.iBytesLeased = 0;
+	stStats.iTargetsLeased = 0;
+	stStats.iTargetsFree = 0;
+	stStats.iLeases = iLeases;
+	stStats.iHits = iHits;
+	stStats.iEvictions = iEvictions;
+
+	for ( int32 i = 0; i < arLeasedTargets.Num(); ++i )
+	{
+		if ( !arLeasedTargets[ i ].IsValid() )
+			continue;
+
+		stStats.iBytesLeased += GetRenderTargetBytes( arLeasedTargets[ i ].Get() );
+		++stStats.iTargetsLeased;
+	}
+
+	stStats.iBytesHeld = stStats.iBytesLeased;
+
+	for ( int32 i = 0; i < arFreeTargets.Num(); ++i )
+	{
+		if ( arFreeTargets[ i ] == NULL )
+			continue;
+
+		stStats.iBytesHeld += GetRenderTargetBytes( arFreeTargets[ i ] );
+		++stStats.iTargetsFree;
+	}
+
+	return stStats;
+}
+
+
+void UKUIRenderTargetPool::ResetStats()
+{
+	iLeases = 0;
+	iHits = 0;
+	iEvictions = 0;
+}
+
+
+UTextureRenderTarget2D* UKUIRenderTargetPool::CreateRenderTarget( const FIntPoint& v2Size )
+{
+	UTextureRenderTarget2D* const tRenderTarget = NewObject<UTextureRenderTarget2D>( this );
+	tRenderTarget->bNeedsTwoCopies = false;
+	tRenderTarget->InitAutoFormat( v2Size.X, v2Size.Y );
+	tRenderTarget->ClearColor = FLinearColor::Transparent;
+	tRenderTarget->bHDR = false;
+	tRenderTarget->CompressionSettings = TextureCompressionSettings::TC_EditorIcon;
+	tRenderTarget->Filter = TextureFilter::TF_Nearest;
+	tRenderTarget->LODGroup = TextureGroup::TEXTUREGROUP_UI;
+	tRenderTarget->UpdateResourceImmediate();
+
+	return tRenderTarget;
+}
+
+
+void UKUIRenderTargetPool::TrimToBudget()
+{
+	int64 iBytesHeld = GetStats().iBytesHeld;
+
+	while ( iBytesHeld > iMemoryBudget && arFreeTargets.Num() > 0 )
+	{
+		int32 iOldestIndex = 0;
+
+		for ( int32 i = 1; i < arFreeReturned.Num(); ++i )
+			if ( arFreeReturned[ i ] < arFreeReturned[ iOldestIndex ] )
+				iOldestIndex = i;
+
+		iBytesHeld -= GetRenderTargetBytes( arFreeTargets[ iOldestIndex ] );
+		++iEvictions;
+
+		arFreeTargets.RemoveAtSwap( iOldestIndex );
+		arFreeReturned.RemoveAtSwap( iOldestIndex );
+	}
+}
+
+
+void UKUIRenderTargetPool::PruneLeasedTargets()
+{
+	for ( int32 i = arLeasedTargets.Num() - 1; i >= 0; --i )
+		if ( !arLeasedTargets[ i ].IsValid() )
+			arLeasedTargets.RemoveAtSwap( i );
+}
+
+
+int64 UKUIRenderTargetPool::GetRenderTargetBytes( const UTextureRenderTarget2D* tRenderTarget )
+{
+	if ( tRenderTarget == NULL )
+		return 0;
+
+	return static_cast<int64>( tRenderTarget->SizeX ) * static_cast<int64>( tRenderTarget->SizeY ) * KUI_RENDER_TARGET_POOL_BYTES_PER_PIXEL;
+}
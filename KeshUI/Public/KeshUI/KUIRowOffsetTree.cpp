@@ -0,0 +1,130 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIRowOffsetTree.h"
+
+
+FKUIRowOffsetTree::FKUIRowOffsetTree()
+{
+	arExtents.SetNum( 0 );
+	arTree.SetNum( 0 );
+}
+
+
+void FKUIRowOffsetTree::Reset( int32 iCount )
+{
+	iCount = max( 0, iCount );
+
+	arExtents.Init( 0.f, iCount );
+	arTree.Init( 0.f, iCount + 1 );
+}
+
+
+void FKUIRowOffsetTree::Build( const TArray<float>& arNewExtents )
+{
+	const int32 iCount = arNewExtents.Num();
+
+	arExtents = arNewExtents;
+	arTree.SetNum( iCount + 1 );
+	arTree[ 0 ] = 0.f;
+
+	for ( int32 i = 0; i < iCount; ++i )
+		arTree[ i + 1 ] = arNewExtents[ i ];
+
+	// Build the tree in place, pushing each node's sum to its parent.
+	for ( int32 i = 1; i <= iCount; ++i )
+	{
+		const int32 iParent = i + ( i & -i );
+
+		if ( iParent <= iCount )
+			arTree[ iParent ] += arTree[ i ];
+	}
+}
+
+
+int32 FKUIRowOffsetTree::Num() const
+{
+	return arExtents.Num();
+}
+
+
+float FKUIRowOffsetTree::GetExtent( int32 iRow ) const
+{
+	if ( !arExtents.IsValidIndex( iRow ) )
+		return 0.f;
+
+	return arExtents[ iRow ];
+}
+
+
+void FKUIRowOffsetTree::SetExtent( int32 iRow, float fExtent )
+{
+	if ( !arExtents.IsValidIndex( iRow ) )
+		return;
+
+	const float fDelta = fExtent - arExtents[ iRow ];
+
+	if ( fDelta == 0.f )
+		return;
+
+	arExtents[ iRow ] = fExtent;
+
+	for ( int32 i = iRow + 1; i <= arExtents.Num(); i += ( i & -i ) )
+		arTree[ i ] += fDelta;
+}
+
+
+float FKUIRowOffsetTree::GetOffset( int32 iRow ) const
+{
+	iRow = clamp( iRow, 0, arExtents.Num() );
+
+	float fOffset = 0.f;
+
+	for ( int32 i = iRow; i > 0; i -= ( i & -i ) )
+		fOffset += arTree[ i ];
+
+	return fOffset;
+}
+
+
+float FKUIRowOffsetTree::GetTotal() const
+{
+	return GetOffset( arExtents.Num() );
+}
+
+
+int32 FKUIRowOffsetTree::FindRow( float fOffset, float& fRemaining ) const
+{
+	const int32 iCount = arExtents.Num();
+
+	fRemaining = 0.f;
+
+	if ( fOffset < 0.f || iCount == 0 )
+		return INDEX_NONE;
+
+	// Find the number of rows that end at or above the offset.
+	int32 iStep = 1;
+
+	while ( ( iStep << 1 ) <= iCount )
+		iStep <<= 1;
+
+	int32 iIndex = 0;
+	fRemaining = fOffset;
+
+	for ( ; iStep > 0; iStep >>= 1 )
+	{
+		if ( iIndex + iStep > iCount )
+			continue;
+
+		if ( arTree[ iIndex + iStep ] > fRemaining )
+			continue;
+
+		iIndex += iStep;
+		fRemaining -= arTree[ iIndex ];
+	}
+
+	if ( iIndex >= iCount )
+		return INDEX_NONE;
+
+	return iIndex;
+}
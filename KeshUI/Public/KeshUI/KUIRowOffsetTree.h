@@ -0,0 +1,49 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+
+/**
+ * Fenwick tree over the extents of a list's rows.  Finding a row's offset, changing one row's extent and
+ * finding the row at an offset are all O(log n).  Building it from scratch is O(n).
+ */
+class KESHUI_API FKUIRowOffsetTree
+{
+
+public:
+
+	FKUIRowOffsetTree();
+
+	/* Sets the number of rows, all with no extent. */
+	void Reset( int32 iCount = 0 );
+
+	/* Rebuilds the tree from the given extents. */
+	void Build( const TArray<float>& arNewExtents );
+
+	/* Returns the number of rows. */
+	int32 Num() const;
+
+	/* Returns the extent of a row. */
+	float GetExtent( int32 iRow ) const;
+
+	/* Changes the extent of a row and the offsets of the rows after it. */
+	void SetExtent( int32 iRow, float fExtent );
+
+	/* Returns the sum of the extents of the rows before the given one.  Num() gives the total. */
+	float GetOffset( int32 iRow ) const;
+
+	/* Returns the total of the extents. */
+	float GetTotal() const;
+
+	/**
+	 * Returns the last row that starts at or before the offset, and sets how far into that row the offset is.
+	 * Returns INDEX_NONE if the offset is before the first row or past the last.
+	 */
+	int32 FindRow( float fOffset, float& fRemaining ) const;
+
+protected:
+
+	TArray<float> arExtents;
+	TArray<float> arTree;
+
+};
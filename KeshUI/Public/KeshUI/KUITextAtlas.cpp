@@ -0,0 +1,384 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIRenderBackend.h"
+#include "KeshUI/KUITextAtlas.h"
+
+
+UKUITextAtlas::UKUITextAtlas( const class FObjectInitializer& oObjectInitializer )
+: Super( oObjectInitializer )
+{
+	iMemoryBudget = KUI_TEXT_ATLAS_BUDGET;
+	iUseCounter = 0;
+	iSerialCounter = 0;
+	arPages.SetNum( 0 );
+	arPageInfo.SetNum( 0 );
+	arEntries.SetNum( 0 );
+	arFreeEntries.SetNum( 0 );
+	iHits = 0;
+	iMisses = 0;
+	iEvictions = 0;
+}
+
+
+FKUITextAtlasHandle UKUITextAtlas::FindOrAddText( AKUIInterface* aHud, const FKUITextAtlasKey& stKey, FCanvasTextItem& stItem, const FVector2D& v2Size )
+{
+	FKUITextAtlasHandle stHandle;
+
+	if ( stKey.foFont == NULL || stKey.strText.Len() == 0 )
+		return stHandle;
+
+	++iUseCounter;
+
+	const int32* const iFoundSlot = mpEntries.Find( stKey );
+
+	if ( iFoundSlot != NULL )
+	{
+		++iHits;
+
+		const FKUITextAtlasEntry& stEntry = arEntries[ *iFoundSlot ];
+		arPageInfo[ stEntry.iPage ].iLastUsed = iUseCounter;
+
+		stHandle.iSlot = *iFoundSlot;
+		stHandle.iSerial = stEntry.iSerial;
+		return stHandle;
+	}
+
+	// Without a renderer there's nothing to rasterize into.
+	if ( aHud == NULL || !FKUIRenderBackend::Get( aHud ).CanRenderToTarget() )
+		return stHandle;
+
+	const FIntPoint v2EntrySize( FMath::CeilToInt( v2Size.X ), FMath::CeilToInt( v2Size.Y ) );
+
+	if ( v2EntrySize.X <= 0 || v2EntrySize.Y <= 0 )
+		return stHandle;
+
+	// Too large to share a page, draw it normally.
+	if ( v2EntrySize.X + KUI_TEXT_ATLAS_PADDING > KUI_TEXT_ATLAS_PAGE_SIZE || v2EntrySize.Y + KUI_TEXT_ATLAS_PADDING > KUI_TEXT_ATLAS_PAGE_SIZE )
+		return stHandle;
+
+	++iMisses;
+
+	int32 iPage = INDEX_NONE;
+	FIntPoint v2Location = FIntPoint::ZeroValue;
+
+	if ( !AllocateRect( v2EntrySize, iPage, v2Location ) )
+		return stHandle;
+
+	int32 iSlot = INDEX_NONE;
+
+	if ( arFreeEntries.Num() > 0 )
+		iSlot = arFreeEntries.Pop();
+
+	else
+		iSlot = arEntries.AddDefaulted();
+
+	FKUITextAtlasEntry& stEntry = arEntries[ iSlot ];
+	stEntry.stKey = stKey;
+	stEntry.iPage = iPage;
+	stEntry.v2Location = v2Location;
+	stEntry.v2Size = v2EntrySize;
+	stEntry.iSerial = ++iSerialCounter;
+	stEntry.bUsed = true;
+
+	mpEntries.Add( stKey, iSlot );
+
+	RasterizeText( aHud, iPage, v2Location, v2EntrySize, stItem, stKey.cColor.ReinterpretAsLinear() );
+
+	stHandle.iSlot = iSlot;
+	stHandle.iSerial = stEntry.iSerial;
+	return stHandle;
+}
+
+
+bool UKUITextAtlas::IsValidHandle( const FKUITextAtlasHandle& stHandle ) const
+{
+	if ( stHandle.iSlot < 0 || stHandle.iSlot >= arEntries.Num() )
+		return false;
+
+	const FKUITextAtlasEntry& stEntry = arEntries[ stHandle.iSlot ];
+
+	return ( stEntry.bUsed && stEntry.iSerial == stHandle.iSerial );
+}
+
+
+void UKUITextAtlas::DrawLabel( AKUIInterface* aHud, UCanvas* oCanvas, const FKUITextAtlasHandle& stHandle, const FVector2D& v2Location, const FLinearColor& lcTint )
+{
+	if ( !IsValidHandle( stHandle ) )
+		return;
+
+	const FKUITextAtlasEntry& stEntry = arEntries[ stHandle.iSlot ];
+	UTextureRenderTarget2D* const tPage = arPages[ stEntry.iPage ];
+
+	if ( tPage == NULL )
+		return;
+
+	arPageInfo[ stEntry.iPage ].iLastUsed = ++iUseCounter;
+
+	const float fPageSize = static_cast<float>( KUI_TEXT_ATLAS_PAGE_SIZE );
+
+	FKUIRenderBackend::Get( aHud ).DrawTile(
+		oCanvas,
+		v2Location.X,
+		v2Location.Y,
+		stEntry.v2Size.X,
+		stEntry.v2Size.Y,
+		stEntry.v2Location.X / fPageSize,
+		stEntry.v2Location.Y / fPageSize,
+		stEntry.v2Size.X / fPageSize,
+		stEntry.v2Size.Y / fPageSize,
+		lcTint,
+		tPage->Resource,
+		true
+	);
+}
+
+
+int64 UKUITextAtlas::GetMemoryBudget() const
+{
+	return iMemoryBudget;
+}
+
+
+void UKUITextAtlas::SetMemoryBudget( int64 iMemoryBudget )
+{
+	this->iMemoryBudget = max( 0, iMemoryBudget );
+
+	// Drop pages from the end so the remaining pages keep their indices.
+	while ( arPages.Num() > 1 && arPages.Num() * GetPageBytes() > this->iMemoryBudget )
+	{
+		EvictPage( arPages.Num() - 1 );
+		arPages.Pop();
+		arPageInfo.Pop();
+	}
+}
+
+
+void UKUITextAtlas::Flush()
+{
+	iEvictions += mpEntries.Num();
+
+	arPages.SetNum( 0 );
+	arPageInfo.SetNum( 0 );
+	arEntries.SetNum( 0 );
+	arFreeEntries.SetNum( 0 );
+	mpEntries.Empty();
+}
+
+
+FKUITextAtlasStats UKUITextAtlas::GetStats() const
+{
+	FKUITextAtlasStats stStats;
+	stStats.iBytesHeld = arPages.Num() * GetPageBytes();
+	stStats.iPages = arPages.Num();
+	stStats.iEntries = mpEntries.Num();
+	stStats.iHits = iHits;
+	stStats.iMisses = iMisses;
+	stStats.iEvictions = iEvictions;
+
+	return stStats;
+}
+
+
+void UKUITextAtlas::ResetStats()
+{
+	iHits = 0;
+	iMisses = 0;
+	iEvictions = 0;
+}
+
+
+bool UKUITextAtlas::AllocateRect( const FIntPoint& v2Size, int32& iPage, FIntPoint& v2Location )
+{
+	for ( int32 i = 0; i < arPageInfo.Num(); ++i )
+	{
+		if ( AllocateRectInPage( i, v2Size, v2Location ) )
+		{
+			iPage = i;
+			return true;
+		}
+	}
+
+	if ( arPages.Num() == 0 || ( arPages.Num() + 1 ) * GetPageBytes() <= iMemoryBudget )
+	{
+		UTextureRenderTarget2D* const tPage = CreatePage();
+
+		if ( tPage == NULL )
+			return false;
+
+		arPages.Add( tPage );
+
+		FKUITextAtlasPage stPageInfo;
+		stPageInfo.iNextShelfY = 0;
+		stPageInfo.iLastUsed = iUseCounter;
+		arPageInfo.Add( stPageInfo );
+
+		iPage = arPages.Num() - 1;
+		return AllocateRectInPage( iPage, v2Size, v2Location );
+	}
+
+	// Out of budget, so reuse the page that has gone the longest without being drawn.
+	int32 iOldestPage = 0;
+
+	for ( int32 i = 1; i < arPageInfo.Num(); ++i )
+		if ( arPageInfo[ i ].iLastUsed < arPageInfo[ iOldestPage ].iLastUsed )
+			iOldestPage = i;
+
+	EvictPage( iOldestPage );
+
+	iPage = iOldestPage;
+	return AllocateRectInPage( iPage, v2Size, v2Location );
+}
+
+
+bool UKUITextAtlas::AllocateRectInPage( int32 iPage, const FIntPoint& v2Size, FIntPoint& v2Location )
+{
+	FKUITextAtlasPage& stPageInfo = arPageInfo[ iPage ];
+	const int32 iWidth = v2Size.X + KUI_TEXT_ATLAS_PADDING;
+	const int32 iHeight = v2Size.Y + KUI_TEXT_ATLAS_PADDING;
+
+	// Use the shortest shelf that fits, but don't waste more than half a label's height on it.
+	int32 iBestShelf = INDEX_NONE;
+
+	for ( int32 i = 0; i < stPageInfo.arShelves.Num(); ++i )
+	{
+		const FKUITextAtlasShelf& stShelf = stPageInfo.arShelves[ i ];
+
+		if ( stShelf.iHeight < iHeight || stShelf.iHeight > iHeight + iHeight / 2 )
+			continue;
+
+		if ( stShelf.iNextX + iWidth > KUI_TEXT_ATLAS_PAGE_SIZE )
+			continue;
+
+		if ( iBestShelf == INDEX_NONE || stShelf.iHeight < stPageInfo.arShelves[ iBestShelf ].iHeight )
+			iBestShelf = i;
+	}
+
+	if ( iBestShelf == INDEX_NONE )
+	{
+		if ( stPageInfo.iNextShelfY + iHeight > KUI_TEXT_ATLAS_PAGE_SIZE )
+			return false;
+
+		FKUITextAtlasShelf stShelf;
+		stShelf.iY = stPageInfo.iNextShelfY;
+		stShelf.iHeight = iHeight;
+		stShelf.iNextX = 0;
+
+		iBestShelf = stPageInfo.arShelves.Add( stShelf );
+		stPageInfo.iNextShelfY += iHeight;
+	}
+
+	FKUITextAtlasShelf& stShelf = stPageInfo.arShelves[ iBestShelf ];
+	v2Location = FIntPoint( stShelf.iNextX, stShelf.iY );
+	stShelf.iNextX += iWidth;
+	stPageInfo.iLastUsed = iUseCounter;
+
+	return true;
+}
+
+
+UTextureRenderTarget2D* UKUITextAtlas::CreatePage()
+{
+	UTextureRenderTarget2D* const tRenderTarget = NewObject<UTextureRenderTarget2D>( this );
+	tRenderTarget->bNeedsTwoCopies = false;
+	tRenderTarget->InitAutoFormat( KUI_TEXT_ATLAS_PAGE_SIZE, KUI_TEXT_ATLAS_PAGE_SIZE );
+	tRenderTarget->ClearColor = FLinearColor::Transparent;
+	tRenderTarget->bHDR = false;
+	tRenderTarget->CompressionSettings = TextureCompressionSettings::TC_EditorIcon;
+	tRenderTarget->Filter = TextureFilter::TF_Nearest;
+	tRenderTarget->LODGroup = TextureGroup::TEXTUREGROUP_UI;
+	tRenderTarget->UpdateResourceImmediate();
+
+	return tRenderTarget;
+}
+
+
+void UKUITextAtlas::EvictPage( int32 iPage )
+{
+	for ( int32 i = 0; i < arEntries.Num(); ++i )
+	{
+		FKUITextAtlasEntry& stEntry = arEntries[ i ];
+
+		if ( !stEntry.bUsed || stEntry.iPage != iPage )
+			continue;
+
+		mpEntries.Remove( stEntry.stKey );
+		stEntry.stKey.strText.Empty();
+		stEntry.bUsed = false;
+		stEntry.iSerial = 0;
+		arFreeEntries.Add( i );
+
+		++iEvictions;
+	}
+
+	// Slots are cleared as they're reused, so the texture itself doesn't need clearing.
+	arPageInfo[ iPage ].arShelves.Reset();
+	arPageInfo[ iPage ].iNextShelfY = 0;
+}
+
+
+void UKUITextAtlas::RasterizeText( AKUIInterface* aHud, int32 iPage, const FIntPoint& v2Location, const FIntPoint& v2Size, FCanvasTextItem& stItem, const FLinearColor& lcColor )
+{
+	UTextureRenderTarget2D* const tRenderTarget = arPages[ iPage ];
+
+	if ( tRenderTarget == NULL || aHud == NULL || aHud->GetWorld() == NULL )
+		return;
+
+	ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
+		TextAtlasRenderTargetMakeCurrentCommand,
+		FTextureRenderTarget2DResource*,
+		TextureRenderTarget,
+		static_cast<FTextureRenderTarget2DResource*>( tRenderTarget->GameThread_GetRenderTargetResource() ),
+		{
+			SetRenderTarget( RHICmdList, TextureRenderTarget->GetRenderTargetTexture(), FTexture2DRHIRef() );
+			RHICmdList.SetViewport( 0, 0, 0.0f, TextureRenderTarget->GetSizeXY().X, TextureRenderTarget->GetSizeXY().Y, 1.0f );
+		}
+	)
+
+	FCanvas oCanvas( tRenderTarget->GameThread_GetRenderTargetResource(), NULL, aHud->GetWorld(), aHud->GetWorld()->FeatureLevel );
+
+	// Only touch this label's slot, the rest of the page belongs to other labels.
+	oCanvas.PushMaskRegion( v2Location.X, v2Location.Y, v2Size.X, v2Size.Y );
+
+	FCanvasTileItem stClearItem( FVector2D( v2Location ), GWhiteTexture, FVector2D( v2Size ), tRenderTarget->ClearColor );
+	stClearItem.BlendMode = SE_BLEND_Opaque;
+	oCanvas.DrawItem( stClearItem );
+
+	// The label is drawn from its top left corner in its own colour, then the item is put back.
+	const FVector2D v2OldPosition = stItem.Position;
+	const FLinearColor lcOldColor = stItem.Color;
+	const bool bOldCentreX = stItem.bCentreX;
+	const bool bOldCentreY = stItem.bCentreY;
+
+	stItem.Position = FVector2D( v2Location );
+	stItem.SetColor( lcColor );
+	stItem.bCentreX = false;
+	stItem.bCentreY = false;
+
+	oCanvas.DrawItem( stItem );
+
+	stItem.Position = v2OldPosition;
+	stItem.SetColor( lcOldColor );
+	stItem.bCentreX = bOldCentreX;
+	stItem.bCentreY = bOldCentreY;
+
+	oCanvas.PopMaskRegion();
+	oCanvas.Flush_GameThread();
+
+	ENQUEUE_UNIQUE_RENDER_COMMAND_ONEPARAMETER(
+		TextAtlasRenderTargetResolveCommand,
+		FTextureRenderTargetResource*,
+		RenderTargetResource,
+		static_cast<FTextureRenderTarget2DResource*>( tRenderTarget->GameThread_GetRenderTargetResource() ),
+		{
+			RHICmdList.CopyToResolveTarget( RenderTargetResource->GetRenderTargetTexture(), RenderTargetResource->TextureRHI, true, FResolveParams() );
+		}
+	)
+}
+
+
+int64 UKUITextAtlas::GetPageBytes()
+{
+	return static_cast<int64>( KUI_TEXT_ATLAS_PAGE_SIZE ) * static_cast<int64>( KUI_TEXT_ATLAS_PAGE_SIZE ) * KUI_TEXT_ATLAS_BYTES_PER_PIXEL;
+}
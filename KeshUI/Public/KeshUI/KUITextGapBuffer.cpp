@@ -0,0 +1,182 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUITextGapBuffer.h"
+
+
+FKUITextGapBuffer::FKUITextGapBuffer()
+{
+	arBuffer.SetNum( 0 );
+	iGapStart = 0;
+	iGapEnd = 0;
+}
+
+
+int32 FKUITextGapBuffer::Len() const
+{
+	return arBuffer.Num() - ( iGapEnd - iGapStart );
+}
+
+
+TCHAR FKUITextGapBuffer::GetChar( int32 iIndex ) const
+{
+	if ( iIndex < iGapStart )
+		return arBuffer[ iIndex ];
+
+	return arBuffer[ iIndex + ( iGapEnd - iGapStart ) ];
+}
+
+
+void FKUITextGapBuffer::SetString( const FString& strString )
+{
+	const int32 iLength = strString.Len();
+
+	arBuffer.SetNumUninitialized( iLength + KUI_TEXT_GAP_BUFFER_MIN_GAP );
+
+	if ( iLength > 0 )
+		FMemory::Memcpy( arBuffer.GetData(), *strString, iLength * sizeof( TCHAR ) );
+
+	// New text is usually appended to, so leave the gap at the end.
+	iGapStart = iLength;
+	iGapEnd = arBuffer.Num();
+}
+
+
+void FKUITextGapBuffer::Insert( int32 iIndex, const FString& strString )
+{
+	const int32 iCount = strString.Len();
+
+	if ( iCount == 0 )
+		return;
+
+	iIndex = clamp( iIndex, 0, Len() );
+
+	MoveGap( iIndex );
+	ReserveGap( iCount );
+
+	FMemory::Memcpy( &arBuffer[ iGapStart ], *strString, iCount * sizeof( TCHAR ) );
+	iGapStart += iCount;
+}
+
+
+void FKUITextGapBuffer::Remove( int32 iIndex, int32 iCount )
+{
+	if ( iIndex < 0 || iIndex >= Len() )
+		return;
+
+	iCount = min( iCount, Len() - iIndex );
+
+	if ( iCount <= 0 )
+		return;
+
+	MoveGap( iIndex );
+	iGapEnd += iCount;
+}
+
+
+FString FKUITextGapBuffer::Mid( int32 iStart, int32 iCount ) const
+{
+	iStart = clamp( iStart, 0, Len() );
+	iCount = clamp( iCount, 0, Len() - iStart );
+
+	FString strString;
+
+	if ( iCount == 0 )
+		return strString;
+
+	TArray<TCHAR>& arChars = strString.GetCharArray();
+	arChars.SetNumUninitialized( iCount + 1 );
+
+	// Copy the part before the gap, then the part after it.
+	const int32 iBeforeGap = clamp( iGapStart - iStart, 0, iCount );
+
+	if ( iBeforeGap > 0 )
+		FMemory::Memcpy( arChars.GetData(), &arBuffer[ iStart ], iBeforeGap * sizeof( TCHAR ) );
+
+	if ( iCount > iBeforeGap )
+		FMemory::Memcpy( &arChars[ iBeforeGap ], &arBuffer[ iStart + iBeforeGap + ( iGapEnd - iGapStart ) ], ( iCount - iBeforeGap ) * sizeof( TCHAR ) );
+
+	arChars[ iCount ] = 0;
+
+	return strString;
+}
+
+
+void FKUITextGapBuffer::CopyTo( FString& strString ) const
+{
+	TArray<TCHAR>& arChars = strString.GetCharArray();
+	const int32 iLength = Len();
+
+	if ( iLength == 0 )
+	{
+		arChars.Reset();
+		return;
+	}
+
+	// Reset keeps the allocation, so a string reused between edits doesn't reallocate.
+	arChars.Reset();
+	arChars.AddUninitialized( iLength + 1 );
+
+	if ( iGapStart > 0 )
+		FMemory::Memcpy( arChars.GetData(), arBuffer.GetData(), iGapStart * sizeof( TCHAR ) );
+
+	if ( iGapEnd < arBuffer.Num() )
+		FMemory::Memcpy( &arChars[ iGapStart ], &arBuffer[ iGapEnd ], ( arBuffer.Num() - iGapEnd ) * sizeof( TCHAR ) );
+
+	arChars[ iLength ] = 0;
+}
+
+
+void FKUITextGapBuffer::Empty()
+{
+	arBuffer.Empty();
+	iGapStart = 0;
+	iGapEnd = 0;
+}
+
+
+void FKUITextGapBuffer::MoveGap( int32 iIndex )
+{
+	if ( iIndex == iGapStart )
+		return;
+
+	const int32 iGapSize = iGapEnd - iGapStart;
+
+	if ( iIndex < iGapStart )
+	{
+		// Shift the characters between the index and the gap to after the gap.
+		const int32 iCount = iGapStart - iIndex;
+		FMemory::Memmove( &arBuffer[ iIndex + iGapSize ], &arBuffer[ iIndex ], iCount * sizeof( TCHAR ) );
+	}
+
+	else
+	{
+		// Shift the characters between the gap and the index to before the gap.
+		const int32 iCount = iIndex - iGapStart;
+		FMemory::Memmove( &arBuffer[ iGapStart ], &arBuffer[ iGapEnd ], iCount * sizeof( TCHAR ) );
+	}
+
+	iGapStart = iIndex;
+	iGapEnd = iIndex + iGapSize;
+}
+
+
+void FKUITextGapBuffer::ReserveGap( int32 iCount )
+{
+	const int32 iGapSize = iGapEnd - iGapStart;
+
+	if ( iGapSize >= iCount )
+		return;
+
+	// Grow geometrically so repeated inserts stay amortized constant time.
+	const int32 iOldNum = arBuffer.Num();
+	const int32 iAfterGap = iOldNum - iGapEnd;
+	const int32 iGrowth = max( max( iCount - iGapSize, iOldNum ), KUI_TEXT_GAP_BUFFER_MIN_GAP );
+
+	arBuffer.AddUninitialized( iGrowth );
+
+	if ( iAfterGap > 0 )
+		FMemory::Memmove( &arBuffer[ iGapEnd + iGrowth ], &arBuffer[ iGapEnd ], iAfterGap * sizeof( TCHAR ) );
+
+	iGapEnd += iGrowth;
+}
@@ -0,0 +1,55 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#define KUI_TEXT_GAP_BUFFER_MIN_GAP 64
+
+/**
+ * Editable text stored with a gap at the last edit position.  Inserting or removing at the same
+ * place as the previous edit only moves the gap's edges, so typing at a caret is amortized O(1)
+ * regardless of the length of the text.  Moving the edit position costs the distance moved.
+ */
+class KESHUI_API FKUITextGapBuffer
+{
+
+public:
+
+	FKUITextGapBuffer();
+
+	/* Returns the number of characters in the buffer. */
+	int32 Len() const;
+
+	/* Returns the character at the given index. */
+	TCHAR GetChar( int32 iIndex ) const;
+
+	/* Replaces the contents of the buffer. */
+	void SetString( const FString& strString );
+
+	/* Inserts a string at the given index. */
+	void Insert( int32 iIndex, const FString& strString );
+
+	/* Removes characters starting at the given index. */
+	void Remove( int32 iIndex, int32 iCount = 1 );
+
+	/* Returns a copy of part of the buffer. */
+	FString Mid( int32 iStart, int32 iCount ) const;
+
+	/* Copies the whole buffer into the string, reusing its allocation. */
+	void CopyTo( FString& strString ) const;
+
+	/* Empties the buffer. */
+	void Empty();
+
+protected:
+
+	TArray<TCHAR> arBuffer;
+	int32 iGapStart;
+	int32 iGapEnd;
+
+	/* Moves the gap so it starts at the given index. */
+	void MoveGap( int32 iIndex );
+
+	/* Makes sure the gap can hold at least the given number of characters. */
+	void ReserveGap( int32 iCount );
+
+};
@@ -0,0 +1,203 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUITextMeasureCache.h"
+
+
+FKUITextMeasureCache::FKUITextMeasureCache()
+{
+	arEntries.SetNum( 0 );
+	iCapacity = KUI_TEXT_MEASURE_CACHE_CAPACITY;
+	iHead = INDEX_NONE;
+	iTail = INDEX_NONE;
+	iHits = 0;
+	iMisses = 0;
+	iEvictions = 0;
+}
+
+
+bool FKUITextMeasureCache::Find( const FKUITextMeasureKey& stKey, const FString& strString, FVector2D& v2Size )
+{
+	if ( iCapacity == 0 )
+		return false;
+
+	const int32* const iEntry = mpEntries.Find( GetHash( stKey, strString ) );
+
+	if ( iEntry == NULL || !Matches( arEntries[ *iEntry ], stKey, strString ) )
+	{
+		++iMisses;
+		return false;
+	}
+
+	++iHits;
+
+	if ( *iEntry != iHead )
+	{
+		Unlink( *iEntry );
+		LinkAtHead( *iEntry );
+	}
+
+	v2Size = arEntries[ *iEntry ].v2Size;
+	return true;
+}
+
+
+void FKUITextMeasureCache::Add( const FKUITextMeasureKey& stKey, const FString& strString, const FVector2D& v2Size )
+{
+	if ( iCapacity == 0 )
+		return;
+
+	const uint32 iHash = GetHash( stKey, strString );
+	const int32* const iExisting = mpEntries.Find( iHash );
+	int32 iEntry = INDEX_NONE;
+
+	// A hash collision replaces the older entry.
+	if ( iExisting != NULL )
+	{
+		iEntry = *iExisting;
+		Unlink( iEntry );
+	}
+
+	else if ( arEntries.Num() < iCapacity )
+		iEntry = arEntries.AddDefaulted();
+
+	else
+		iEntry = EvictTail();
+
+	FKUITextMeasureEntry& stEntry = arEntries[ iEntry ];
+	stEntry.iHash = iHash;
+	stEntry.stKey = stKey;
+	stEntry.strString = strString;
+	stEntry.v2Size = v2Size;
+
+	mpEntries.Add( iHash, iEntry );
+	LinkAtHead( iEntry );
+}
+
+
+int32 FKUITextMeasureCache::GetCapacity() const
+{
+	return iCapacity;
+}
+
+
+void FKUITextMeasureCache::SetCapacity( int32 iCapacity )
+{
+	iCapacity = max( 0, iCapacity );
+
+	if ( this->iCapacity == iCapacity )
+		return;
+
+	this->iCapacity = iCapacity;
+
+	// Entries are indexed by position, so shrinking starts again rather than compacting.
+	if ( arEntries.Num() > iCapacity )
+	{
+		iEvictions += arEntries.Num();
+		Empty();
+	}
+}
+
+
+void FKUITextMeasureCache::Empty()
+{
+	arEntries.Empty();
+	mpEntries.Empty();
+	iHead = INDEX_NONE;
+	iTail = INDEX_NONE;
+}
+
+
+FKUITextMeasureCacheStats FKUITextMeasureCache::GetStats() const
+{
+	FKUITextMeasureCacheStats stStats;
+	stStats.iEntries = arEntries.Num();
+	stStats.iCapacity = iCapacity;
+	stStats.iHits = iHits;
+	stStats.iMisses = iMisses;
+	stStats.iEvictions = iEvictions;
+
+	return stStats;
+}
+
+
+void FKUITextMeasureCache::ResetStats()
+{
+	iHits = 0;
+	iMisses = 0;
+	iEvictions = 0;
+}
+
+
+uint32 FKUITextMeasureCache::GetHash( const FKUITextMeasureKey& stKey, const FString& strString )
+{
+	uint32 iHash = FCrc::StrCrc32( *strString );
+	iHash = HashCombine( iHash, GetTypeHash( stKey.foFont ) );
+	iHash = HashCombine( iHash, GetTypeHash( stKey.v2Scale ) );
+	iHash = HashCombine( iHash, GetTypeHash( stKey.fHorizontalSpacingAdjust ) );
+	iHash = HashCombine( iHash, ( stKey.bShadow ? GetTypeHash( stKey.v2ShadowOffset ) : 0 ) );
+	iHash = HashCombine( iHash, ( stKey.bOutlined ? 1 : 0 ) );
+
+	return iHash;
+}
+
+
+bool FKUITextMeasureCache::Matches( const FKUITextMeasureEntry& stEntry, const FKUITextMeasureKey& stKey, const FString& strString )
+{
+	return ( stEntry.stKey.foFont == stKey.foFont &&
+			 stEntry.stKey.v2Scale == stKey.v2Scale &&
+			 stEntry.stKey.fHorizontalSpacingAdjust == stKey.fHorizontalSpacingAdjust &&
+			 stEntry.stKey.bShadow == stKey.bShadow &&
+			 ( !stKey.bShadow || stEntry.stKey.v2ShadowOffset == stKey.v2ShadowOffset ) &&
+			 stEntry.stKey.bOutlined == stKey.bOutlined &&
+			 stEntry.strString.Equals( strString, ESearchCase::CaseSensitive ) );
+}
+
+
+void FKUITextMeasureCache::Unlink( int32 iEntry )
+{
+	FKUITextMeasureEntry& stEntry = arEntries[ iEntry ];
+
+	if ( stEntry.iPrev != INDEX_NONE )
+		arEntries[ stEntry.iPrev ].iNext = stEntry.iNext;
+
+	else
+		iHead = stEntry.iNext;
+
+	if ( stEntry.iNext != INDEX_NONE )
+		arEntries[ stEntry.iNext ].iPrev = stEntry.iPrev;
+
+	else
+		iTail = stEntry.iPrev;
+
+	stEntry.iPrev = INDEX_NONE;
+	stEntry.iNext = INDEX_NONE;
+}
+
+
+void FKUITextMeasureCache::LinkAtHead( int32 iEntry )
+{
+	FKUITextMeasureEntry& stEntry = arEntries[ iEntry ];
+	stEntry.iPrev = INDEX_NONE;
+	stEntry.iNext = iHead;
+
+	if ( iHead != INDEX_NONE )
+		arEntries[ iHead ].iPrev = iEntry;
+
+	iHead = iEntry;
+
+	if ( iTail == INDEX_NONE )
+		iTail = iEntry;
+}
+
+
+int32 FKUITextMeasureCache::EvictTail()
+{
+	const int32 iEntry = iTail;
+
+	Unlink( iEntry );
+	mpEntries.Remove( arEntries[ iEntry ].iHash );
+	++iEvictions;
+
+	return iEntry;
+}
@@ -0,0 +1,111 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#define KUI_TEXT_MEASURE_CACHE_CAPACITY 1024
+
+class UFont;
+
+/* The text settings that affect a measured size, apart from the string itself. */
+struct FKUITextMeasureKey
+{
+	UFont* foFont;
+	FVector2D v2Scale;
+	float fHorizontalSpacingAdjust;
+	bool bShadow;
+	FVector2D v2ShadowOffset;
+	bool bOutlined;
+};
+
+
+/* Usage statistics for a text measure cache. */
+struct FKUITextMeasureCacheStats
+{
+	int32 iEntries;
+	int32 iCapacity;
+	int32 iHits;
+	int32 iMisses;
+	int32 iEvictions;
+
+	/* Returns the fraction of lookups that found a size. */
+	float GetHitRate() const
+	{
+		if ( iHits + iMisses == 0 )
+			return 0.f;
+
+		return static_cast<float>( iHits ) / static_cast<float>( iHits + iMisses );
+	}
+};
+
+
+/**
+ * Remembers the sizes of recently measured strings so labels measured with the same text and settings
+ * over and over don't walk their characters each time.  Entries are found by a hash of the string and
+ * settings and checked against the stored copy.  When full, the least recently used entry is replaced.
+ */
+class KESHUI_API FKUITextMeasureCache
+{
+
+public:
+
+	FKUITextMeasureCache();
+
+	/* Returns true and sets the size if the string has been measured with these settings. */
+	bool Find( const FKUITextMeasureKey& stKey, const FString& strString, FVector2D& v2Size );
+
+	/* Remembers the size of a string measured with these settings. */
+	void Add( const FKUITextMeasureKey& stKey, const FString& strString, const FVector2D& v2Size );
+
+	/* Returns the maximum number of sizes kept. */
+	int32 GetCapacity() const;
+
+	/* Sets the maximum number of sizes kept, dropping the least recently used.  0 disables the cache. */
+	void SetCapacity( int32 iCapacity );
+
+	/* Forgets every size. */
+	void Empty();
+
+	/* Returns the usage statistics. */
+	FKUITextMeasureCacheStats GetStats() const;
+
+	/* Resets the hit, miss and eviction counters. */
+	void ResetStats();
+
+protected:
+
+	/* A remembered size, linked into the recently used list. */
+	struct FKUITextMeasureEntry
+	{
+		uint32 iHash;
+		FKUITextMeasureKey stKey;
+		FString strString;
+		FVector2D v2Size;
+		int32 iPrev;
+		int32 iNext;
+	};
+
+	TArray<FKUITextMeasureEntry> arEntries;
+	TMap<uint32, int32> mpEntries;
+	int32 iCapacity;
+	int32 iHead;
+	int32 iTail;
+	int32 iHits;
+	int32 iMisses;
+	int32 iEvictions;
+
+	/* Returns the hash of a string and its settings. */
+	static uint32 GetHash( const FKUITextMeasureKey& stKey, const FString& strString );
+
+	/* Returns true if the entry was measured from the same string and settings. */
+	static bool Matches( const FKUITextMeasureEntry& stEntry, const FKUITextMeasureKey& stKey, const FString& strString );
+
+	/* Takes an entry out of the recently used list. */
+	void Unlink( int32 iEntry );
+
+	/* Puts an entry at the front of the recently used list. */
+	void LinkAtHead( int32 iEntry );
+
+	/* Removes the least recently used entry, returning its index for reuse. */
+	int32 EvictTail();
+
+};
@@ -6,4 +6,19 @@
 
 DECLARE_LOG_CATEGORY_EXTERN( LogKeshUI, Log, All );
 
+DECLARE_STATS_GROUP( TEXT( "KeshUI" ), STATGROUP_KeshUI, STATCAT_Advanced );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Tick" ), STAT_KUITick, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Layout" ), STAT_KUILayout, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Broadcast Event" ), STAT_KUIBroadcastEvent, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Mouse Dispatch" ), STAT_KUIMouseDispatch, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Render" ), STAT_KUIRender, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Render Cache Update" ), STAT_KUIRenderCacheUpdate, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_CYCLE_STAT_EXTERN( TEXT( "Batch Update Flush" ), STAT_KUIBatchUpdateFlush, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Batch Updates Coalesced" ), STAT_KUIBatchUpdatesCoalesced, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Mouse Event Targets" ), STAT_KUIMouseTargets, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Layout Measures" ), STAT_KUILayoutMeasured, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Layout Arranges" ), STAT_KUILayoutArranged, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Flex Solves" ), STAT_KUIFlexSolves, STATGROUP_KeshUI, KESHUI_API );
+DECLARE_DWORD_COUNTER_STAT_EXTERN( TEXT( "Text Item Syncs" ), STAT_KUITextItemSyncs, STATGROUP_KeshUI, KESHUI_API );
+
 #include "KeshUI/KUIMacros.h"
@@ -0,0 +1,73 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "AutomationTest.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/Component/KUIBoxInterfaceComponent.h"
+#include "KeshUI/Tests/KUITestInterface.h"
+
+#define KUI_ADD_CHILD_BENCHMARK_CHILDREN 10000
+#define KUI_ADD_CHILD_BENCHMARK_Z_INDICES 16
+
+
+/* Returns true if the container's children are in z-order with no nulls. */
+static bool AreChildrenInZOrder( UKUIInterfaceContainer* ctContainer )
+{
+	for ( int32 i = 0; i < ctContainer->GetChildCount(); ++i )
+	{
+		if ( ctContainer->GetChildAtIndex( i ) == NULL )
+			return false;
+
+		if ( i > 0 && ctContainer->GetChildAtIndex( i - 1 )->GetZIndex() > ctContainer->GetChildAtIndex( i )->GetZIndex() )
+			return false;
+	}
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIAddChildBenchmark, "KeshUI.Benchmark.AddChild", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIAddChildBenchmark::RunTest( const FString& strParameters )
+{
+	FKUITestInterface stTest;
+	FRandomStream stRandom( 1234 );
+	TArray<UKUIInterfaceElement*> arElements;
+	arElements.SetNum( KUI_ADD_CHILD_BENCHMARK_CHILDREN );
+
+	for ( int32 i = 0; i < arElements.Num(); ++i )
+	{
+		arElements[ i ] = stTest.NewElement<UKUIBoxInterfaceComponent>();
+		arElements[ i ]->SetZIndex( stRandom.RandHelper( KUI_ADD_CHILD_BENCHMARK_Z_INDICES ) );
+	}
+
+	// One at a time, each inserted in z-order.
+	UKUIInterfaceContainer* ctContainer = stTest.NewElement<UKUIInterfaceContainer>();
+	double fStart = FPlatformTime::Seconds();
+
+	for ( int32 i = 0; i < arElements.Num(); ++i )
+		ctContainer->AddChild( arElements[ i ] );
+
+	const double fInsertMs = FKUITestInterface::GetMillisecondsSince( fStart );
+
+	TestEqual( TEXT( "All inserted" ), ctContainer->GetChildCount(), static_cast<int32>( KUI_ADD_CHILD_BENCHMARK_CHILDREN ) );
+	TestTrue( TEXT( "Inserted in z-order" ), AreChildrenInZOrder( ctContainer ) );
+
+	// All at once, sorted at the end.
+	UKUIInterfaceContainer* const ctBulkContainer = stTest.NewElement<UKUIInterfaceContainer>();
+	fStart = FPlatformTime::Seconds();
+
+	ctBulkContainer->AddChildren( arElements );
+
+	const double fBulkMs = FKUITestInterface::GetMillisecondsSince( fStart );
+
+	TestEqual( TEXT( "All moved" ), ctBulkContainer->GetChildCount(), static_cast<int32>( KUI_ADD_CHILD_BENCHMARK_CHILDREN ) );
+	TestEqual( TEXT( "Old container emptied" ), ctContainer->GetChildCount(), 0 );
+	TestTrue( TEXT( "Bulk added in z-order" ), AreChildrenInZOrder( ctBulkContainer ) );
+
+	AddLogItem( FString::Printf( TEXT( "%d children: %.3f ms inserting one at a time, %.3f ms in a bulk update" ),
+		KUI_ADD_CHILD_BENCHMARK_CHILDREN, fInsertMs, fBulkMs ) );
+
+	return true;
+}
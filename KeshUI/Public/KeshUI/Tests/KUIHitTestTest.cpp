@@ -0,0 +1,199 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "AutomationTest.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIHitTestGrid.h"
+#include "KeshUI/Container/KUISubContainer.h"
+#include "KeshUI/Widget/KUISimpleClickWidget.h"
+#include "KeshUI/Tests/KUITestInterface.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIHitTestGridTest, "KeshUI.HitTest.Grid", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIHitTestGridTest::RunTest( const FString& strParameters )
+{
+	FKUITestInterface stTest;
+	UKUIInterfaceElement* const oBottom = stTest.NewElement<UKUISimpleClickWidget>();
+	UKUIInterfaceElement* const oTop = stTest.NewElement<UKUISimpleClickWidget>();
+
+	FKUIHitTestGrid oGrid;
+	oGrid.BeginFrame( FVector2D( 256.f, 256.f ) );
+	oGrid.AddEntry( oBottom, FVector2D( 0.f, 0.f ), FVector2D( 100.f, 100.f ) );
+	oGrid.AddEntry( oTop, FVector2D( 50.f, 50.f ), FVector2D( 150.f, 150.f ) );
+	oGrid.EndFrame();
+
+	TestEqual( TEXT( "Entries" ), oGrid.GetEntryCount(), 2 );
+	TestEqual( TEXT( "Rebuilds" ), oGrid.GetRebuildCount(), 1 );
+	TestTrue( TEXT( "Bottom only" ), oGrid.GetTopmostElementAt( FVector2D( 10.f, 10.f ) ) == oBottom );
+	TestTrue( TEXT( "Overlap picks the later entry" ), oGrid.GetTopmostElementAt( FVector2D( 75.f, 75.f ) ) == oTop );
+	TestTrue( TEXT( "Max edge is exclusive" ), oGrid.GetTopmostElementAt( FVector2D( 150.f, 150.f ) ) == NULL );
+	TestTrue( TEXT( "Off the grid" ), oGrid.GetTopmostElementAt( FVector2D( -1.f, 10.f ) ) == NULL );
+
+	TArray<UKUIInterfaceElement*> arElements;
+	oGrid.GetElementsAt( FVector2D( 75.f, 75.f ), arElements );
+
+	TestEqual( TEXT( "Both contain the overlap" ), arElements.Num(), 2 );
+
+	if ( arElements.Num() == 2 )
+	{
+		TestTrue( TEXT( "Topmost first" ), arElements[ 0 ] == oTop );
+		TestTrue( TEXT( "Then the one below" ), arElements[ 1 ] == oBottom );
+	}
+
+	// The same entries again don't rebuild the cells.
+	oGrid.BeginFrame( FVector2D( 256.f, 256.f ) );
+	oGrid.AddEntry( oBottom, FVector2D( 0.f, 0.f ), FVector2D( 100.f, 100.f ) );
+	oGrid.AddEntry( oTop, FVector2D( 50.f, 50.f ), FVector2D( 150.f, 150.f ) );
+	oGrid.EndFrame();
+
+	TestEqual( TEXT( "Unchanged frame" ), oGrid.GetRebuildCount(), 1 );
+
+	// Swapping the order swaps which one is on top.
+	oGrid.BeginFrame( FVector2D( 256.f, 256.f ) );
+	oGrid.AddEntry( oTop, FVector2D( 50.f, 50.f ), FVector2D( 150.f, 150.f ) );
+	oGrid.AddEntry( oBottom, FVector2D( 0.f, 0.f ), FVector2D( 100.f, 100.f ) );
+	oGrid.EndFrame();
+
+	TestEqual( TEXT( "Changed frame" ), oGrid.GetRebuildCount(), 2 );
+	TestTrue( TEXT( "Reordered overlap" ), oGrid.GetTopmostElementAt( FVector2D( 75.f, 75.f ) ) == oBottom );
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIHitTestTreeTest, "KeshUI.HitTest.Tree", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIHitTestTreeTest::RunTest( const FString& strParameters )
+{
+	FKUITestInterface stTest;
+	AKUIInterface* const aInterface = stTest.GetInterface();
+
+	// Children follow their z-index, not the order they were added in.
+	UKUISimpleClickWidget* const ctFront = stTest.NewElement<UKUISimpleClickWidget>();
+	ctFront->SetLocation( 0.f, 0.f );
+	ctFront->SetSize( 100.f, 100.f );
+	ctFront->SetZIndex( 2 );
+	aInterface->AddElement( EKUIInterfaceRoot::R_Root, ctFront );
+
+	UKUISimpleClickWidget* const ctBack = stTest.NewElement<UKUISimpleClickWidget>();
+	ctBack->SetLocation( 50.f, 50.f );
+	ctBack->SetSize( 100.f, 100.f );
+	ctBack->SetZIndex( 1 );
+	aInterface->AddElement( EKUIInterfaceRoot::R_Root, ctBack );
+
+	// A scrolled sub container: its children are drawn from the cache, moved by the corner offset and clipped to it.
+	UKUISubContainer* const ctScroll = stTest.NewElement<UKUISubContainer>();
+	ctScroll->SetLocation( 300.f, 100.f );
+	ctScroll->SetSize( 200.f, 100.f );
+	ctScroll->SetTotalSize( 200.f, 1000.f );
+	ctScroll->SetCornerOffset( 0.f, 300.f );
+	aInterface->AddElement( EKUIInterfaceRoot::R_Root, ctScroll );
+
+	UKUISimpleClickWidget* const ctVisible = stTest.NewElement<UKUISimpleClickWidget>();
+	ctVisible->SetLocation( 0.f, 320.f );
+	ctVisible->SetSize( 50.f, 20.f );
+	ctScroll->AddChild( ctVisible );
+
+	UKUISimpleClickWidget* const ctClipped = stTest.NewElement<UKUISimpleClickWidget>();
+	ctClipped->SetLocation( 0.f, 390.f );
+	ctClipped->SetSize( 50.f, 20.f );
+	ctScroll->AddChild( ctClipped );
+
+	stTest.Render();
+
+	TestTrue( TEXT( "Higher z-index on top" ), aInterface->GetElementAtPoint( FVector2D( 75.f, 75.f ) ) == ctFront );
+	TestTrue( TEXT( "Lower z-index outside the overlap" ), aInterface->GetElementAtPoint( FVector2D( 125.f, 125.f ) ) == ctBack );
+	TestTrue( TEXT( "Scrolled child" ), aInterface->GetElementAtPoint( FVector2D( 310.f, 125.f ) ) == ctVisible );
+	TestTrue( TEXT( "Clipped child, inside" ), aInterface->GetElementAtPoint( FVector2D( 310.f, 195.f ) ) == ctClipped );
+	TestTrue( TEXT( "Clipped child, outside" ), aInterface->GetElementAtPoint( FVector2D( 310.f, 205.f ) ) == NULL );
+
+	// Only the widget under the press gets it.
+	aInterface->OnMouseMove( aInterface->GetCursorLocation(), FVector2D( 75.f, 75.f ) );
+	aInterface->OnMouseButtonDown( EMouseButtons::Left, FVector2D( 75.f, 75.f ) );
+
+	TestTrue( TEXT( "Front pressed" ), ctFront->IsDown() );
+	TestFalse( TEXT( "Back not pressed" ), ctBack->IsDown() );
+
+	// The release reaches the pressed widget even if the cursor has left it.
+	aInterface->OnMouseMove( FVector2D( 75.f, 75.f ), FVector2D( 700.f, 700.f ) );
+	aInterface->OnMouseButtonUp( EMouseButtons::Left, FVector2D( 700.f, 700.f ) );
+
+	TestFalse( TEXT( "Front released" ), ctFront->IsDown() );
+
+	aInterface->OnMouseMove( FVector2D( 700.f, 700.f ), FVector2D( 310.f, 125.f ) );
+	aInterface->OnMouseButtonDown( EMouseButtons::Left, FVector2D( 310.f, 125.f ) );
+
+	TestTrue( TEXT( "Scrolled child pressed" ), ctVisible->IsDown() );
+
+	aInterface->OnMouseButtonUp( EMouseButtons::Left, FVector2D( 310.f, 125.f ) );
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIMouseDispatchBenchmark, "KeshUI.Benchmark.MouseDispatch", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIMouseDispatchBenchmark::RunTest( const FString& strParameters )
+{
+	const int32 arElementCounts[] = { 100, 1000, 10000 };
+	const int32 iIterations = 1000;
+	const float fCellSize = 16.f;
+
+	for ( int32 iCountIndex = 0; iCountIndex < ARRAY_COUNT( arElementCounts ); ++iCountIndex )
+	{
+		const int32 iCount = arElementCounts[ iCountIndex ];
+		FKUITestInterface stTest;
+		AKUIInterface* const aInterface = stTest.GetInterface();
+		const FVector2D v2Resolution = aInterface->GetScreenResolution();
+		const int32 iColumns = v2Resolution.X / fCellSize;
+		const int32 iRows = v2Resolution.Y / fCellSize;
+
+		aInterface->BeginBatchUpdate();
+
+		for ( int32 i = 0; i < iCount; ++i )
+		{
+			UKUISimpleClickWidget* const ctWidget = stTest.NewElement<UKUISimpleClickWidget>();
+			ctWidget->SetLocation( ( i % iColumns ) * fCellSize, ( ( i / iColumns ) % iRows ) * fCellSize );
+			ctWidget->SetSize( fCellSize, fCellSize );
+			aInterface->AddElement( EKUIInterfaceRoot::R_Root, ctWidget );
+		}
+
+		aInterface->EndBatchUpdate();
+
+		stTest.Render();
+
+		FVector2D v2Cursor = aInterface->GetCursorLocation();
+		double fStart = FPlatformTime::Seconds();
+
+		for ( int32 i = 0; i < iIterations; ++i )
+		{
+			const FVector2D v2Next( ( i * 37 ) % static_cast<int32>( v2Resolution.X ), ( i * 53 ) % static_cast<int32>( v2Resolution.Y ) );
+			aInterface->OnMouseMove( v2Cursor, v2Next );
+			v2Cursor = v2Next;
+		}
+
+		const double fMoveMs = FKUITestInterface::GetMillisecondsSince( fStart );
+
+		// Click on the first widget.
+		aInterface->OnMouseMove( v2Cursor, FVector2D( fCellSize / 2.f, fCellSize / 2.f ) );
+		v2Cursor = aInterface->GetCursorLocation();
+
+		TestTrue( TEXT( "Widget under the cursor" ), aInterface->GetElementUnderCursor() != NULL );
+
+		fStart = FPlatformTime::Seconds();
+
+		for ( int32 i = 0; i < iIterations; ++i )
+		{
+			aInterface->OnMouseButtonDown( EMouseButtons::Left, v2Cursor );
+			aInterface->OnMouseButtonUp( EMouseButtons::Left, v2Cursor );
+		}
+
+		const double fClickMs = FKUITestInterface::GetMillisecondsSince( fStart );
+
+		AddLogItem( FString::Printf( TEXT( "%d elements: %.3f us per move, %.3f us per click" ),
+			iCount, fMoveMs * 1000.0 / iIterations, fClickMs * 1000.0 / iIterations ) );
+	}
+
+	return true;
+}
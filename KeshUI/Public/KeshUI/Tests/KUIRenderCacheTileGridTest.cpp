@@ -0,0 +1,215 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "AutomationTest.h"
+#include "KeshUI/KUIRenderCacheTileGrid.h"
+
+
+/* Returns the index of the resident tile at the given column and row, or INDEX_NONE. */
+static int32 FindResidentTile( const FKUIRenderCacheTileGrid& oGrid, int32 iColumn, int32 iRow )
+{
+	const TArray<FKUIRenderCacheTile>& arTiles = oGrid.GetTiles();
+
+	for ( int32 i = 0; i < arTiles.Num(); ++i )
+	{
+		if ( arTiles[ i ].iColumn == iColumn && arTiles[ i ].iRow == iRow )
+			return i;
+	}
+
+	return INDEX_NONE;
+}
+
+
+/* Marks every resident tile as redrawn. */
+static void ValidateAllTiles( FKUIRenderCacheTileGrid& oGrid )
+{
+	for ( int32 i = 0; i < oGrid.GetTiles().Num(); ++i )
+		oGrid.ValidateTile( i );
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIRenderCacheTileGridAllocationTest, "KeshUI.RenderCache.TileGrid.Allocation", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIRenderCacheTileGridAllocationTest::RunTest( const FString& strParameters )
+{
+	FKUIRenderCacheTileGrid oGrid( 100, 0 );
+	oGrid.SetContentSize( FVector2D( 1000.f, 1000.f ) );
+
+	TestEqual( TEXT( "Nothing resident before a visible region" ), oGrid.GetTiles().Num(), 0 );
+
+	// Partly covered tiles are resident too.
+	oGrid.SetVisibleRegion( FVector2D( 0.f, 0.f ), FVector2D( 250.f, 150.f ) );
+
+	TestEqual( TEXT( "Tiles covering the region" ), oGrid.GetTiles().Num(), 6 );
+	TestEqual( TEXT( "One slot per tile" ), oGrid.GetSlotCount(), 6 );
+	TestTrue( TEXT( "Last column" ), FindResidentTile( oGrid, 2, 1 ) != INDEX_NONE );
+	TestTrue( TEXT( "Nothing past the region" ), FindResidentTile( oGrid, 3, 0 ) == INDEX_NONE );
+	TestTrue( TEXT( "New tiles need drawing" ), oGrid.HasInvalidTiles() );
+
+	const int32 iCorner = FindResidentTile( oGrid, 2, 1 );
+
+	if ( iCorner != INDEX_NONE )
+		TestTrue( TEXT( "Tile origin" ), oGrid.GetTileOrigin( oGrid.GetTiles()[ iCorner ] ) == FVector2D( 200.f, 100.f ) );
+
+	// The margin adds a ring of tiles, clamped to the content.
+	FKUIRenderCacheTileGrid oMarginGrid( 100, 1 );
+	oMarginGrid.SetContentSize( FVector2D( 1000.f, 1000.f ) );
+	oMarginGrid.SetVisibleRegion( FVector2D( 300.f, 300.f ), FVector2D( 400.f, 400.f ) );
+
+	TestEqual( TEXT( "Margin around the region" ), oMarginGrid.GetTiles().Num(), 9 );
+
+	oMarginGrid.SetVisibleRegion( FVector2D( 0.f, 0.f ), FVector2D( 100.f, 100.f ) );
+
+	TestEqual( TEXT( "Margin clamped at the content edge" ), oMarginGrid.GetTiles().Num(), 4 );
+
+	// Nothing is resident for an empty region.
+	oMarginGrid.SetVisibleRegion( FVector2D( 0.f, 0.f ), FVector2D( 0.f, 0.f ) );
+
+	TestEqual( TEXT( "Empty region" ), oMarginGrid.GetTiles().Num(), 0 );
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIRenderCacheTileGridDirtyRectTest, "KeshUI.RenderCache.TileGrid.DirtyRect", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIRenderCacheTileGridDirtyRectTest::RunTest( const FString& strParameters )
+{
+	FKUIRenderCacheTileGrid oGrid( 100, 0 );
+	oGrid.SetContentSize( FVector2D( 1000.f, 1000.f ) );
+	oGrid.SetVisibleRegion( FVector2D( 0.f, 0.f ), FVector2D( 300.f, 300.f ) );
+	ValidateAllTiles( oGrid );
+
+	TestFalse( TEXT( "All drawn" ), oGrid.HasInvalidTiles() );
+
+	// A rect inside one tile only dirties that tile.
+	oGrid.InvalidateRect( FVector2D( 150.f, 50.f ), FVector2D( 160.f, 60.f ) );
+
+	for ( int32 i = 0; i < oGrid.GetTiles().Num(); ++i )
+	{
+		const FKUIRenderCacheTile& stTile = oGrid.GetTiles()[ i ];
+		const bool bExpectInvalid = ( stTile.iColumn == 1 && stTile.iRow == 0 );
+
+		TestEqual( FString::Printf( TEXT( "Tile %d,%d after a small rect" ), stTile.iColumn, stTile.iRow ), !stTile.bValid, bExpectInvalid );
+	}
+
+	ValidateAllTiles( oGrid );
+
+	// Tile edges are exclusive at the far side.
+	oGrid.InvalidateRect( FVector2D( 200.f, 0.f ), FVector2D( 210.f, 10.f ) );
+
+	const int32 iBefore = FindResidentTile( oGrid, 1, 0 );
+	const int32 iAfter = FindResidentTile( oGrid, 2, 0 );
+
+	if ( iBefore != INDEX_NONE && iAfter != INDEX_NONE )
+	{
+		TestTrue( TEXT( "Rect starting on an edge leaves the tile before it" ), oGrid.GetTiles()[ iBefore ].bValid );
+		TestFalse( TEXT( "Rect starting on an edge dirties the tile after it" ), oGrid.GetTiles()[ iAfter ].bValid );
+	}
+
+	ValidateAllTiles( oGrid );
+
+	// A rect across a corner dirties all four tiles around it.
+	oGrid.InvalidateRect( FVector2D( 90.f, 90.f ), FVector2D( 110.f, 110.f ) );
+
+	int32 iInvalid = 0;
+
+	for ( int32 i = 0; i < oGrid.GetTiles().Num(); ++i )
+	{
+		if ( !oGrid.GetTiles()[ i ].bValid )
+			++iInvalid;
+	}
+
+	TestEqual( TEXT( "Rect across a corner" ), iInvalid, 4 );
+
+	ValidateAllTiles( oGrid );
+
+	// Rects outside the resident tiles or with no area do nothing.
+	oGrid.InvalidateRect( FVector2D( 500.f, 500.f ), FVector2D( 600.f, 600.f ) );
+	oGrid.InvalidateRect( FVector2D( 50.f, 50.f ), FVector2D( 50.f, 80.f ) );
+
+	TestFalse( TEXT( "Rects that miss" ), oGrid.HasInvalidTiles() );
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIRenderCacheTileGridRecycleTest, "KeshUI.RenderCache.TileGrid.Recycle", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIRenderCacheTileGridRecycleTest::RunTest( const FString& strParameters )
+{
+	FKUIRenderCacheTileGrid oGrid( 100, 0 );
+	oGrid.SetContentSize( FVector2D( 10000.f, 10000.f ) );
+	oGrid.SetVisibleRegion( FVector2D( 0.f, 0.f ), FVector2D( 200.f, 100.f ) );
+
+	TestEqual( TEXT( "Initial slots" ), oGrid.GetSlotCount(), 2 );
+
+	ValidateAllTiles( oGrid );
+
+	// Scrolling by a tile evicts one and reuses its slot for the one that comes into view.
+	oGrid.SetVisibleRegion( FVector2D( 100.f, 0.f ), FVector2D( 300.f, 100.f ) );
+
+	TestEqual( TEXT( "Tiles after scrolling" ), oGrid.GetTiles().Num(), 2 );
+	TestEqual( TEXT( "Slots after scrolling" ), oGrid.GetSlotCount(), 2 );
+	TestTrue( TEXT( "Evicted tile" ), FindResidentTile( oGrid, 0, 0 ) == INDEX_NONE );
+
+	const int32 iKept = FindResidentTile( oGrid, 1, 0 );
+	const int32 iExposed = FindResidentTile( oGrid, 2, 0 );
+
+	if ( iKept != INDEX_NONE && iExposed != INDEX_NONE )
+	{
+		TestTrue( TEXT( "Kept tile is still drawn" ), oGrid.GetTiles()[ iKept ].bValid );
+		TestFalse( TEXT( "Recycled tile needs drawing" ), oGrid.GetTiles()[ iExposed ].bValid );
+		TestTrue( TEXT( "Different slots" ), oGrid.GetTiles()[ iKept ].iSlot != oGrid.GetTiles()[ iExposed ].iSlot );
+	}
+
+	// Scrolling a long way never needs more slots than fit on screen.
+	for ( int32 i = 0; i < 50; ++i )
+		oGrid.SetVisibleRegion( FVector2D( i * 170.f, i * 130.f ), FVector2D( i * 170.f + 200.f, i * 130.f + 100.f ) );
+
+	TestTrue( TEXT( "Slots bounded by the viewport" ), oGrid.GetSlotCount() <= 6 );
+
+	// Reset forgets the slots.
+	oGrid.Reset();
+
+	TestEqual( TEXT( "Tiles after a reset" ), oGrid.GetTiles().Num(), 0 );
+	TestEqual( TEXT( "Slots after a reset" ), oGrid.GetSlotCount(), 0 );
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIRenderCacheTileGridInvalidateAllTest, "KeshUI.RenderCache.TileGrid.InvalidateAll", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIRenderCacheTileGridInvalidateAllTest::RunTest( const FString& strParameters )
+{
+	FKUIRenderCacheTileGrid oGrid( 100, 0 );
+	oGrid.SetContentSize( FVector2D( 1000.f, 1000.f ) );
+	oGrid.SetVisibleRegion( FVector2D( 0.f, 0.f ), FVector2D( 300.f, 300.f ) );
+	ValidateAllTiles( oGrid );
+
+	oGrid.InvalidateAll();
+
+	for ( int32 i = 0; i < oGrid.GetTiles().Num(); ++i )
+		TestFalse( FString::Printf( TEXT( "Tile %d invalidated" ), i ), oGrid.GetTiles()[ i ].bValid );
+
+	ValidateAllTiles( oGrid );
+
+	// Content that still has the same number of tiles keeps them.
+	oGrid.SetContentSize( FVector2D( 950.f, 990.f ) );
+
+	TestEqual( TEXT( "Same tile layout" ), oGrid.GetTiles().Num(), 9 );
+	TestFalse( TEXT( "Same tile layout stays drawn" ), oGrid.HasInvalidTiles() );
+
+	// A different tile layout evicts everything, but the slots can be reused.
+	oGrid.SetContentSize( FVector2D( 2000.f, 1000.f ) );
+
+	TestEqual( TEXT( "New tile layout" ), oGrid.GetTiles().Num(), 0 );
+
+	oGrid.SetVisibleRegion( FVector2D( 0.f, 0.f ), FVector2D( 300.f, 300.f ) );
+
+	TestEqual( TEXT( "Slots reused after the layout change" ), oGrid.GetSlotCount(), 9 );
+	TestTrue( TEXT( "Tiles redrawn after the layout change" ), oGrid.HasInvalidTiles() );
+
+	return true;
+}
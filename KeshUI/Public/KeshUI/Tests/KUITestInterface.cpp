@@ -0,0 +1,58 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/Tests/KUITestInterface.h"
+
+
+FKUITestInterface::FKUITestInterface( const FVector2D& v2Resolution )
+{
+	oWorld = UWorld::CreateWorld( EWorldType::Game, false );
+	aInterface = oWorld->SpawnActor<AKUIInterface>();
+
+	stRenderBackend = MakeShareable( new FKUIRecordingRenderBackend() );
+	aInterface->SetRenderBackend( stRenderBackend );
+	aInterface->SetScreenResolution( v2Resolution );
+
+	oCanvas = NewObject<UCanvas>( GetTransientPackage() );
+	oCanvas->AddToRoot();
+	oCanvas->Init( v2Resolution.X, v2Resolution.Y, NULL );
+}
+
+
+FKUITestInterface::~FKUITestInterface()
+{
+	oCanvas->RemoveFromRoot();
+	oWorld->DestroyWorld( false );
+}
+
+
+AKUIInterface* FKUITestInterface::GetInterface() const
+{
+	return aInterface;
+}
+
+
+FKUIRecordingRenderBackend& FKUITestInterface::GetRenderBackend() const
+{
+	return *stRenderBackend;
+}
+
+
+void FKUITestInterface::Tick( float fDeltaTime )
+{
+	aInterface->Tick( fDeltaTime );
+}
+
+
+void FKUITestInterface::Render()
+{
+	stRenderBackend->Reset();
+	aInterface->Render( oCanvas );
+}
+
+
+double FKUITestInterface::GetMillisecondsSince( double fStartSeconds )
+{
+	return ( FPlatformTime::Seconds() - fStartSeconds ) * 1000.0;
+}
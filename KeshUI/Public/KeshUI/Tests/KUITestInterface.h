@@ -0,0 +1,56 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#pragma once
+
+#include "KeshUI/KUIRenderBackend.h"
+
+class AKUIInterface;
+class UKUIInterfaceElement;
+class UCanvas;
+class UWorld;
+
+/**
+ * An interface spawned in a world of its own that draws through a recording backend, so element trees can
+ * be built, laid out, rendered and sent input without a viewport.  Used by the automation tests.
+ */
+class FKUITestInterface
+{
+
+public:
+
+	FKUITestInterface( const FVector2D& v2Resolution = FVector2D( 1920.f, 1080.f ) );
+
+	~FKUITestInterface();
+
+	/* Returns the interface. */
+	AKUIInterface* GetInterface() const;
+
+	/* Returns the backend the interface draws through. */
+	FKUIRecordingRenderBackend& GetRenderBackend() const;
+
+	/* Creates an element owned by the interface. */
+	template<class T>
+	T* NewElement() const
+	{
+		T* const oElement = NewObject<T>( GetInterface() );
+		oElement->InitializeElement();
+		return oElement;
+	}
+
+	/* Ticks the interface. */
+	void Tick( float fDeltaTime = 1.f / 60.f );
+
+	/* Lays out and renders one frame, clearing the recorded draw calls first. */
+	void Render();
+
+	/* Returns the number of milliseconds since the given FPlatformTime::Seconds() value. */
+	static double GetMillisecondsSince( double fStartSeconds );
+
+protected:
+
+	UWorld* oWorld;
+	AKUIInterface* aInterface;
+	UCanvas* oCanvas;
+	TSharedPtr<FKUIRecordingRenderBackend> stRenderBackend;
+
+};
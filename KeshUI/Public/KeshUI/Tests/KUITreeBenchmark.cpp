@@ -0,0 +1,216 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "AutomationTest.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIInterfaceContainer.h"
+#include "KeshUI/Component/KUIBoxInterfaceComponent.h"
+#include "KeshUI/Component/KUITextInterfaceComponent.h"
+#include "KeshUI/Container/KUIListContainer.h"
+#include "KeshUI/Container/KUIListRowContainer.h"
+#include "KeshUI/Tests/KUITestInterface.h"
+
+#define KUI_TREE_BENCHMARK_FRAMES 100
+#define KUI_TREE_BENCHMARK_DEPTH 64
+#define KUI_TREE_BENCHMARK_WIDTH 5000
+#define KUI_TREE_BENCHMARK_ROWS 2000
+#define KUI_TREE_BENCHMARK_TEXTS 2000
+
+
+namespace EKUITreeBenchmark
+{
+	enum Type
+	{
+		TB_Deep,
+		TB_Wide,
+		TB_List,
+		TB_Text,
+		TB_Max
+	};
+}
+
+
+static const TCHAR* GetTreeBenchmarkName( EKUITreeBenchmark::Type eTree )
+{
+	switch ( eTree )
+	{
+		case EKUITreeBenchmark::TB_Deep: return TEXT( "Deep" );
+		case EKUITreeBenchmark::TB_Wide: return TEXT( "Wide" );
+		case EKUITreeBenchmark::TB_List: return TEXT( "List" );
+		case EKUITreeBenchmark::TB_Text: return TEXT( "Text" );
+
+		default:
+			break;
+	}
+
+	return TEXT( "Unknown" );
+}
+
+
+static UKUITextInterfaceComponent* NewBenchmarkText( const FKUITestInterface& stTest, int32 iIndex )
+{
+	UKUITextInterfaceComponent* const cmText = stTest.NewElement<UKUITextInterfaceComponent>();
+	cmText->SetFont( GEngine != NULL ? GEngine->GetSmallFont() : NULL );
+	cmText->SetTextString( FString::Printf( TEXT( "Benchmark text %d" ), iIndex ) );
+	return cmText;
+}
+
+
+/* Builds one of the synthetic trees.  Returns its root and adds every container in it to the array. */
+static UKUIInterfaceContainer* BuildBenchmarkTree( const FKUITestInterface& stTest, EKUITreeBenchmark::Type eTree,
+	TArray<UKUIInterfaceContainer*>& arContainers, int32& iElementCount )
+{
+	UKUIInterfaceContainer* const ctRoot = stTest.NewElement<UKUIInterfaceContainer>();
+	ctRoot->SetSize( 1920.f, 1080.f );
+	arContainers.Add( ctRoot );
+	iElementCount = 1;
+
+	switch ( eTree )
+	{
+		// Containers nested inside each other, each with a box.
+		case EKUITreeBenchmark::TB_Deep:
+		{
+			UKUIInterfaceContainer* ctParent = ctRoot;
+
+			for ( int32 i = 0; i < KUI_TREE_BENCHMARK_DEPTH; ++i )
+			{
+				UKUIBoxInterfaceComponent* const cmBox = stTest.NewElement<UKUIBoxInterfaceComponent>();
+				cmBox->SetSize( 10.f, 10.f );
+				ctParent->AddChild( cmBox );
+
+				UKUIInterfaceContainer* const ctChild = stTest.NewElement<UKUIInterfaceContainer>();
+				ctChild->SetLocation( 1.f, 1.f );
+				ctChild->SetSize( ctParent->GetSize().X - 2.f, ctParent->GetSize().Y - 2.f );
+				ctParent->AddChild( ctChild );
+
+				arContainers.Add( ctChild );
+				iElementCount += 2;
+				ctParent = ctChild;
+			}
+
+			break;
+		}
+
+		// One container with a lot of boxes in it.
+		case EKUITreeBenchmark::TB_Wide:
+			for ( int32 i = 0; i < KUI_TREE_BENCHMARK_WIDTH; ++i )
+			{
+				UKUIBoxInterfaceComponent* const cmBox = stTest.NewElement<UKUIBoxInterfaceComponent>();
+				cmBox->SetLocation( ( i % 100 ) * 19.f, ( i / 100 ) * 19.f );
+				cmBox->SetSize( 16.f, 16.f );
+				ctRoot->AddChild( cmBox );
+
+				++iElementCount;
+			}
+
+			break;
+
+		// A list of rows, each with a background box and a label.
+		case EKUITreeBenchmark::TB_List:
+		{
+			UKUIListContainer* const ctList = stTest.NewElement<UKUIListContainer>();
+			ctList->SetSize( 400.f, 0.f );
+			ctRoot->AddChild( ctList );
+			arContainers.Add( ctList );
+			++iElementCount;
+
+			for ( int32 i = 0; i < KUI_TREE_BENCHMARK_ROWS; ++i )
+			{
+				UKUIListRowContainer* const ctRow = stTest.NewElement<UKUIListRowContainer>();
+
+				UKUIBoxInterfaceComponent* const cmBox = stTest.NewElement<UKUIBoxInterfaceComponent>();
+				cmBox->SetSize( 400.f, 18.f );
+				ctRow->AddChild( cmBox );
+				ctRow->AddChild( NewBenchmarkText( stTest, i ) );
+
+				ctList->AddRow( ctRow );
+				arContainers.Add( ctRow );
+				iElementCount += 3;
+			}
+
+			break;
+		}
+
+		// Lots of different strings.
+		case EKUITreeBenchmark::TB_Text:
+			for ( int32 i = 0; i < KUI_TREE_BENCHMARK_TEXTS; ++i )
+			{
+				UKUITextInterfaceComponent* const cmText = NewBenchmarkText( stTest, i );
+				cmText->SetLocation( ( i % 10 ) * 190.f, ( i / 10 ) * 5.f );
+				ctRoot->AddChild( cmText );
+
+				++iElementCount;
+			}
+
+			break;
+
+		default:
+			break;
+	}
+
+	return ctRoot;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUITreeBenchmark, "KeshUI.Benchmark.Tree", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUITreeBenchmark::RunTest( const FString& strParameters )
+{
+	for ( int32 iTree = 0; iTree < EKUITreeBenchmark::TB_Max; ++iTree )
+	{
+		const EKUITreeBenchmark::Type eTree = static_cast<EKUITreeBenchmark::Type>( iTree );
+		FKUITestInterface stTest;
+		AKUIInterface* const aInterface = stTest.GetInterface();
+		TArray<UKUIInterfaceContainer*> arContainers;
+		int32 iElementCount = 0;
+
+		aInterface->BeginBatchUpdate();
+		aInterface->AddElement( EKUIInterfaceRoot::R_Root, BuildBenchmarkTree( stTest, eTree, arContainers, iElementCount ) );
+		aInterface->EndBatchUpdate();
+
+		// Warm up caches before timing anything.
+		stTest.Render();
+
+		double fTickMs = 0.0;
+		double fLayoutMs = 0.0;
+		double fBroadcastMs = 0.0;
+		double fRenderMs = 0.0;
+
+		for ( int32 iFrame = 0; iFrame < KUI_TREE_BENCHMARK_FRAMES; ++iFrame )
+		{
+			double fStart = FPlatformTime::Seconds();
+			stTest.Tick();
+			fTickMs += FKUITestInterface::GetMillisecondsSince( fStart );
+
+			// Lay out the whole tree every frame, not just what changed.
+			for ( int32 i = 0; i < arContainers.Num(); ++i )
+				arContainers[ i ]->InvalidateLayout();
+
+			fStart = FPlatformTime::Seconds();
+			aInterface->UpdateLayout();
+			fLayoutMs += FKUITestInterface::GetMillisecondsSince( fStart );
+
+			FKUIInterfaceEvent stEventInfo( EKUIInterfaceContainerEventList::E_MatchStart );
+
+			fStart = FPlatformTime::Seconds();
+			aInterface->BroadcastEvent( stEventInfo );
+			fBroadcastMs += FKUITestInterface::GetMillisecondsSince( fStart );
+
+			// The layout is already valid, so this is the traversal and draw call recording.
+			fStart = FPlatformTime::Seconds();
+			stTest.Render();
+			fRenderMs += FKUITestInterface::GetMillisecondsSince( fStart );
+		}
+
+		const int32 iDrawCalls = stTest.GetRenderBackend().GetDrawCalls().Num();
+
+		TestTrue( FString::Printf( TEXT( "%s tree draws something" ), GetTreeBenchmarkName( eTree ) ), iDrawCalls > 0 );
+
+		AddLogItem( FString::Printf( TEXT( "%s tree, %d elements, %d draw calls: %.3f ms tick, %.3f ms layout, %.3f ms broadcast, %.3f ms render per frame" ),
+			GetTreeBenchmarkName( eTree ), iElementCount, iDrawCalls,
+			fTickMs / KUI_TREE_BENCHMARK_FRAMES, fLayoutMs / KUI_TREE_BENCHMARK_FRAMES,
+			fBroadcastMs / KUI_TREE_BENCHMARK_FRAMES, fRenderMs / KUI_TREE_BENCHMARK_FRAMES ) );
+	}
+
+	return true;
+}
@@ -0,0 +1,102 @@
+// Copyright 2014-2015 Matt Chapman. All Rights Reserved.
+
+#include "KeshUI/KeshUI.h"
+#include "AutomationTest.h"
+#include "KeshUI/KUIInterface.h"
+#include "KeshUI/KUIRowOffsetTree.h"
+#include "KeshUI/Container/KUIListRowContainer.h"
+#include "KeshUI/Container/KUIVirtualListContainer.h"
+#include "KeshUI/Tests/KUITestInterface.h"
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIRowOffsetTreeTest, "KeshUI.VirtualList.RowOffsetTree", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIRowOffsetTreeTest::RunTest( const FString& strParameters )
+{
+	TArray<float> arExtents;
+	arExtents.SetNum( 5 );
+
+	for ( int32 i = 0; i < arExtents.Num(); ++i )
+		arExtents[ i ] = 10.f * ( i + 1 );
+
+	FKUIRowOffsetTree oTree;
+	oTree.Build( arExtents );
+
+	TestEqual( TEXT( "Rows" ), oTree.Num(), 5 );
+	TestEqual( TEXT( "First offset" ), oTree.GetOffset( 0 ), 0.f );
+	TestEqual( TEXT( "Middle offset" ), oTree.GetOffset( 3 ), 60.f );
+	TestEqual( TEXT( "Total" ), oTree.GetTotal(), 150.f );
+
+	float fRemaining = 0.f;
+	TestEqual( TEXT( "Row at the start" ), oTree.FindRow( 0.f, fRemaining ), 0 );
+	TestEqual( TEXT( "Row at a boundary" ), oTree.FindRow( 30.f, fRemaining ), 2 );
+	TestEqual( TEXT( "Row inside" ), oTree.FindRow( 65.f, fRemaining ), 3 );
+	TestEqual( TEXT( "Offset into the row" ), fRemaining, 5.f );
+	TestEqual( TEXT( "Past the end" ), oTree.FindRow( 150.f, fRemaining ), static_cast<int32>( INDEX_NONE ) );
+	TestEqual( TEXT( "Before the start" ), oTree.FindRow( -1.f, fRemaining ), static_cast<int32>( INDEX_NONE ) );
+
+	// Changing one row moves only the rows after it.
+	oTree.SetExtent( 1, 5.f );
+
+	TestEqual( TEXT( "Changed extent" ), oTree.GetExtent( 1 ), 5.f );
+	TestEqual( TEXT( "Offset above the change" ), oTree.GetOffset( 1 ), 10.f );
+	TestEqual( TEXT( "Offset below the change" ), oTree.GetOffset( 3 ), 45.f );
+	TestEqual( TEXT( "Changed total" ), oTree.GetTotal(), 135.f );
+	TestEqual( TEXT( "Row after the change" ), oTree.FindRow( 15.f, fRemaining ), 2 );
+
+	oTree.Reset( 3 );
+
+	TestEqual( TEXT( "Reset rows" ), oTree.Num(), 3 );
+	TestEqual( TEXT( "Reset total" ), oTree.GetTotal(), 0.f );
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST( FKUIVirtualListRowSizeTest, "KeshUI.VirtualList.RowSize", EAutomationTestFlags::ATF_Editor | EAutomationTestFlags::ATF_Game )
+
+bool FKUIVirtualListRowSizeTest::RunTest( const FString& strParameters )
+{
+	FKUITestInterface stTest;
+	AKUIInterface* const aInterface = stTest.GetInterface();
+
+	UKUIVirtualListContainer* const ctList = stTest.NewElement<UKUIVirtualListContainer>();
+	ctList->SetSize( 200.f, 200.f );
+	ctList->SetDefaultRowHeight( 20.f );
+	ctList->SetRowSpacing( 2.f );
+	ctList->SetVirtualRowCount( 1000 );
+	ctList->SetVirtualRowHeight( 1, 40.f );
+	aInterface->AddElement( EKUIInterfaceRoot::R_Root, ctList );
+
+	stTest.Render();
+
+	// Empty rows would measure to no height, so the pooled rows must keep the height the list gave them.
+	for ( int32 iRow = 0; iRow < 5; ++iRow )
+	{
+		UKUIListRowContainer* const ctRow = ctList->GetBoundRow( iRow );
+		TestTrue( FString::Printf( TEXT( "Row %d bound" ), iRow ), ctRow != NULL );
+
+		if ( ctRow == NULL )
+			continue;
+
+		TestFalse( TEXT( "Pooled rows don't measure themselves" ), ctRow->IsMeasuringHeight() );
+		TestEqual( FString::Printf( TEXT( "Row %d height" ), iRow ), ctRow->GetSize().Y, ctList->GetVirtualRowHeight( iRow ) );
+		TestEqual( FString::Printf( TEXT( "Row %d offset" ), iRow ), ctRow->GetLocation().Y, ctList->GetRowOffset( iRow ) );
+	}
+
+	// Changing a row height after the offsets are built moves the rows below it.
+	ctList->SetVirtualRowHeight( 0, 30.f );
+
+	TestEqual( TEXT( "Offset after a height change" ), ctList->GetRowOffset( 2 ), 30.f + 2.f + 40.f + 2.f );
+	TestEqual( TEXT( "Total after a height change" ), ctList->GetTotalRowHeight(), 30.f + 40.f + 998.f * 20.f + 999.f * 2.f );
+	TestEqual( TEXT( "Row at an offset after a height change" ), ctList->GetRowAtOffset( 33.f ), 1 );
+
+	stTest.Render();
+
+	UKUIListRowContainer* const ctRow = ctList->GetBoundRow( 2 );
+
+	if ( ctRow != NULL )
+		TestEqual( TEXT( "Bound row moved" ), ctRow->GetLocation().Y, ctList->GetRowOffset( 2 ) );
+
+	return true;
+}
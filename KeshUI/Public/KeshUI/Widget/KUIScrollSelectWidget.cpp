@@ -133,13 +133,10 @@ void UKUIScrollSelectWidget::OnRightButtonClick( UKUISimpleClickWidget* cmButton
 }
 
 
-void UKUIScrollSelectWidget::DoLayout()
+void UKUIScrollSelectWidget::MeasureLayout()
 {
 	UpdateLargestTextSize();
 
-	if ( cmLeftButton.IsValid() )
-		cmText->SetLocation( cmLeftButton->GetSize().X + cmLeftButton->GetMarginSize().X, 0.f );
-
 	FVector2D v2Size = FVector2D::ZeroVector;
 
 	v2Size.X = v2LargestTextSize.X + cmText->GetMarginSize().X;
@@ -159,6 +156,14 @@ void UKUIScrollSelectWidget::DoLayout()
 		v2Size.Y = max( v2Size.Y, cmRightButton->GetSize().Y + cmRightButton->GetMarginSize().Y );
 
 	SetSizeStruct( v2Size );
+}
+
+
+void UKUIScrollSelectWidget::DoLayout()
+{
+	if ( cmLeftButton.IsValid() )
+		cmText->SetLocation( cmLeftButton->GetSize().X + cmLeftButton->GetMarginSize().X, 0.f );
+
 	UpdateDisabledStates();
 
 	Super::DoLayout();
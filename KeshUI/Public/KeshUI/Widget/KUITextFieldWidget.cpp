@@ -26,19 +26,26 @@ UKUITextFieldWidget::UKUITextFieldWidget( const class FObjectInitializer& oObjec
 
 	v2CaretOffset = FVector2D::ZeroVector;
 	strFullString = "";
+	bFullStringDirty = false;
 	strEditStart = "";
-	strUndo = "";
+	strUndoRemoved = "";
 	strLastAdd = "";
 	iRenderStringLength = 0;
 	iRenderStringStart = 0;
 	iCaretPosition = 0;
 	iUndoCaretPosition = 0;
+	iUndoIndex = 0;
+	iUndoLength = 0;
 	iMaxLength = KUI_TEXT_FIELD_NO_MAX_LENGTH;
 	bMouseDown = false;
-	dgInlineValueChange.BindUObject( this, &UKUITextFieldWidget::OnInlineValueChange );
 	dgValueChanged.BindUObject( this, &UKUITextFieldWidget::OnValueChange );
 	iCharacterFilter = EKUITextFilter::F_All;
 	eLastAction = EKUITextFieldWidgetLastAction::LA_None;
+	arCharOffsets.SetNum( 0 );
+	bValidCharOffsets = false;
+	foCharOffsetFont = NULL;
+	v2CharOffsetScale = FVector2D::ZeroVector;
+	fCharOffsetSpacing = 0.f;
 
 	dgSimpleClickWidgetClick.BindUObject( this, &UKUITextFieldWidget::OnTextBoxClick );
 }
@@ -91,26 +98,84 @@ void UKUITextFieldWidget::SetCaretOffset( const FVector2D& v2Offset )
 
 const FString& UKUITextFieldWidget::GetString() const
 {
+	if ( bFullStringDirty )
+	{
+		oTextBuffer.CopyTo( strFullString );
+		bFullStringDirty = false;
+	}
+
 	return strFullString;
 }
 
 
 void UKUITextFieldWidget::SetString( const FString& strString )
 {
-	if ( strFullString.Equals( strString ) )
+	if ( GetString().Equals( strString ) )
+		return;
+
+	ReplaceChars( 0, oTextBuffer.Len(), strString );
+}
+
+
+void UKUITextFieldWidget::ReplaceChars( uint16 iIndex, uint16 iCount, const FString& strString )
+{
+	if ( iCount == 0 && strString.Len() == 0 )
 		return;
 
-	KUISendEvent( FKUIInterfaceWidgetInlineValueChangeEvent, EKUIInterfaceWidgetEventList::E_InlineValueChange, static_cast< const void* >( &strFullString ), static_cast< const void* >( &strString ) );
+	// Only build the whole new string if something is listening for it.
+	const bool bObserved = IsInlineValueChangeObserved();
+	FString strNewString;
+
+	if ( bObserved )
+	{
+		const FString& strOldString = GetString();
+		strNewString = strOldString.Left( iIndex ) + strString + strOldString.Mid( iIndex + iCount );
+
+		KUISendEvent( FKUIInterfaceWidgetInlineValueChangeEvent, EKUIInterfaceWidgetEventList::E_InlineValueChange, static_cast< const void* >( &strFullString ), static_cast< const void* >( &strNewString ) );
+	}
 
+	// Undo only keeps what this edit replaced, so it costs the size of the edit.
 	iUndoCaretPosition = iCaretPosition;
-	strUndo = strFullString;
-	strFullString = strString;
-	iCaretPosition = min( iCaretPosition, strFullString.Len() );
+	iUndoIndex = iIndex;
+	iUndoLength = strString.Len();
+	strUndoRemoved = oTextBuffer.Mid( iIndex, iCount );
+
+	if ( iCount > 0 )
+	{
+		RemoveCharOffsets( iIndex, iCount );
+		oTextBuffer.Remove( iIndex, iCount );
+	}
+
+	if ( strString.Len() > 0 )
+	{
+		InsertCharOffsets( iIndex, strString );
+		oTextBuffer.Insert( iIndex, strString );
+	}
+
+	if ( bObserved )
+	{
+		Swap( strFullString, strNewString );
+		bFullStringDirty = false;
+	}
+
+	else
+		bFullStringDirty = true;
+
+	iCaretPosition = min( iCaretPosition, oTextBuffer.Len() );
 
 	KUISendSubEvent( FKUIInterfaceEvent, EKUIInterfaceWidgetEventList::E_StateChange );	
 }
 
 
+bool UKUITextFieldWidget::IsInlineValueChangeObserved() const
+{
+	if ( dgInlineValueChange.IsBound() )
+		return true;
+
+	return GetClass()->IsFunctionImplementedInBlueprint( GET_FUNCTION_NAME_CHECKED( UKUITextFieldWidget, OnInlineValueChangeBP ) );
+}
+
+
 uint16 UKUITextFieldWidget::GetMaxLength() const
 {
 	return iMaxLength;
@@ -165,7 +230,7 @@ void UKUITextFieldWidget::OnFocus( const FKUIInterfaceEvent& stEventInfo )
 		cmCaret->SetVisible( true );
 
 	//KUILogUO( "Focus: \"%s\", \"%s\"", *strEditStart, *strFullString );
-	strEditStart = strFullString;
+	strEditStart = GetString();
 
 	KUISendSubEvent( FKUIInterfaceEvent, EKUIInterfaceWidgetEventList::E_StateChange );
 }
@@ -244,7 +309,7 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 
 				for ( uint16 i = iCaretPosition - 1; i >= 0; --i )
 				{
-					if ( !IsPunctuation( strFullString[ i ] ) )
+					if ( !IsPunctuation( oTextBuffer.GetChar( i ) ) )
 						continue;
 
 					iWordStart = i + 1;
@@ -256,9 +321,9 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 
 				int32 iWordEnd = -1;
 
-				for ( uint16 i = iWordStart + 1; i < strFullString.Len(); ++i )
+				for ( uint16 i = iWordStart + 1; i < oTextBuffer.Len(); ++i )
 				{
-					if ( !IsPunctuation( strFullString[ i ] ) )
+					if ( !IsPunctuation( oTextBuffer.GetChar( i ) ) )
 						continue;
 
 					iWordEnd = i - 1;
@@ -266,7 +331,7 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 				}
 
 				if ( iWordEnd == -1 )
-					iWordEnd = strFullString.Len() - 1;
+					iWordEnd = oTextBuffer.Len() - 1;
 
 				iCaretPosition = iWordStart;
 				RemoveChars( iWordStart, iWordEnd - iWordStart + 1);
@@ -282,8 +347,9 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 
 		else if ( stEventInfo.eKey == EKeys::Z )
 		{
+			// Replacing the last edit with what it removed records the reverse, so undoing again redoes it.
 			iCaretPosition = iUndoCaretPosition;
-			SetString( strUndo );
+			ReplaceChars( iUndoIndex, iUndoLength, FString( strUndoRemoved ) );
 		}
 
 		else if ( stEventInfo.eKey == EKeys::Y )
@@ -304,7 +370,7 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 					break;
 
 				case EKUITextFieldWidgetLastAction::LA_Delete:
-					if ( iCaretPosition < strFullString.Len() )
+					if ( iCaretPosition < oTextBuffer.Len() )
 						RemoveChars( iCaretPosition );
 
 					break;
@@ -325,7 +391,7 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 
 	else if ( stEventInfo.eKey == EKeys::Delete )
 	{
-		if ( iCaretPosition < strFullString.Len() )
+		if ( iCaretPosition < oTextBuffer.Len() )
 			RemoveChars( iCaretPosition );
 
 		eLastAction = EKUITextFieldWidgetLastAction::LA_Delete;
@@ -342,7 +408,7 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 
 	else if ( stEventInfo.eKey == EKeys::Right )
 	{
-		if ( iCaretPosition < strFullString.Len() )
+		if ( iCaretPosition < oTextBuffer.Len() )
 		{
 			++iCaretPosition;
 			KUISendSubEvent( FKUIInterfaceEvent, EKUIInterfaceWidgetEventList::E_StateChange );
@@ -360,9 +426,9 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 
 	else if ( stEventInfo.eKey == EKeys::End )
 	{
-		if ( iCaretPosition < strFullString.Len() )
+		if ( iCaretPosition < oTextBuffer.Len() )
 		{
-			iCaretPosition = strFullString.Len();
+			iCaretPosition = oTextBuffer.Len();
 			KUISendSubEvent( FKUIInterfaceEvent, EKUIInterfaceWidgetEventList::E_StateChange );
 		}
 	}
@@ -373,10 +439,11 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 		eLastAction = EKUITextFieldWidgetLastAction::LA_None;
 
 		//KUILogUO( "Enter: \"%s\", \"%s\"", *strTemp, *strFullString );
-		if ( !strEditStart.Equals( strFullString ) )
+		if ( !strEditStart.Equals( GetString() ) )
 		{
 			strEditStart = "";
-			strUndo = strFullString;
+			iUndoLength = 0;
+			strUndoRemoved = "";
 			iUndoCaretPosition = iCaretPosition;
 			KUISendSubEvent( FKUIInterfaceEvent, EKUIInterfaceWidgetEventList::E_StateChange );
 
@@ -391,10 +458,14 @@ bool UKUITextFieldWidget::OnKeyDown( const FKUIInterfaceContainerKeyEvent& stEve
 		eLastAction = EKUITextFieldWidgetLastAction::LA_None;
 
 		//KUILogUO( "Escape: \"%s\", \"%s\"", *strTemp, *strFullString );
-		if ( !strEditStart.Equals( strFullString ) )
+		if ( !strEditStart.Equals( GetString() ) )
 		{
 			strFullString = strEditStart;
-			strUndo = strFullString;
+			bFullStringDirty = false;
+			oTextBuffer.SetString( strFullString );
+			bValidCharOffsets = false;
+			iUndoLength = 0;
+			strUndoRemoved = "";
 			iUndoCaretPosition = iCaretPosition;
 			KUISendSubEvent( FKUIInterfaceEvent, EKUIInterfaceWidgetEventList::E_StateChange );
 		}
@@ -533,17 +604,20 @@ void UKUITextFieldWidget::AddString( const FString& strString )
 {
 	if ( iMaxLength != KUI_TEXT_FIELD_NO_MAX_LENGTH )
 	{
-		if ( strFullString.Len() == iMaxLength )
+		if ( oTextBuffer.Len() == iMaxLength )
 			return;
 
-		if ( ( strFullString.Len() + strString.Len() ) > iMaxLength )
+		if ( ( oTextBuffer.Len() + strString.Len() ) > iMaxLength )
 		{
-			AddString( strString.Left( iMaxLength - strFullString.Len() ) );
+			AddString( strString.Left( iMaxLength - oTextBuffer.Len() ) );
 			return;
 		}
 	}
 
-	SetString( strFullString.Left( iCaretPosition ) + strString + strFullString.Right( strFullString.Len() - iCaretPosition ) );
+	if ( strString.Len() == 0 )
+		return;
+
+	ReplaceChars( iCaretPosition, 0, strString );
 	strLastAdd = strString;
 	eLastAction = EKUITextFieldWidgetLastAction::LA_Add;
 
@@ -553,159 +627,203 @@ void UKUITextFieldWidget::AddString( const FString& strString )
 
 void UKUITextFieldWidget::RemoveChars( uint16 iIndex, uint16 iCount )
 {
-	if ( iIndex < 0 || iIndex >= strFullString.Len() )
+	if ( iIndex < 0 || iIndex >= oTextBuffer.Len() )
 	{
 		KUIErrorUO( "Invalid index: %d", iIndex );
 		return;
 	}
 
+	iCount = min( iCount, oTextBuffer.Len() - iIndex );
+
+	if ( iCount == 0 )
+		return;
+
 	//KUILogUO( "Remove Char: %d: %s -> %s", iIndex, *strFullString.Left( iIndex ), *strFullString.Right( strFullString.Len() - iIndex - 1 ) );
-	SetString( strFullString.Left( iIndex ) + strFullString.Right( strFullString.Len() - iIndex - iCount ) );
+	ReplaceChars( iIndex, iCount, FString() );
 }
 
 
-void UKUITextFieldWidget::OnWidgetStateChange_Implementation()
+const TArray<float>& UKUITextFieldWidget::GetCharOffsets()
 {
-	Super::OnWidgetStateChange_Implementation();
+	if ( !AreCharOffsetsValid() )
+	{
+		cmTextComponent->GetCharacterOffsets( GetString(), arCharOffsets );
+		foCharOffsetFont = cmTextComponent->GetFont();
+		v2CharOffsetScale = cmTextComponent->GetScale();
+		fCharOffsetSpacing = cmTextComponent->GetHorizontalSpacingAdjustment();
+		bValidCharOffsets = true;
+	}
 
-	//KUILogUO( "OnWidgetStateChange_Implementation() %s", *strFullString );
+	return arCharOffsets;
+}
 
-	if ( iCaretPosition < 0 )
-		iCaretPosition = 0;
 
-	else if ( iCaretPosition > strFullString.Len() )
-		iCaretPosition = strFullString.Len();
+bool UKUITextFieldWidget::AreCharOffsetsValid() const
+{
+	if ( !bValidCharOffsets )
+		return false;
 
-	//KUILogUO( "Caret Position: %d, %d, %d", iCaretPosition, iRenderStringStart, iRenderStringLength );
+	if ( arCharOffsets.Num() != oTextBuffer.Len() + 1 )
+		return false;
 
-	// Move the rendered text so the caret is on the far left.
-	if ( iCaretPosition < iRenderStringStart )
+	if ( foCharOffsetFont != cmTextComponent->GetFont() )
+		return false;
+
+	if ( v2CharOffsetScale != cmTextComponent->GetScale() )
+		return false;
+
+	if ( fCharOffsetSpacing != cmTextComponent->GetHorizontalSpacingAdjustment() )
+		return false;
+
+	return true;
+}
+
+
+void UKUITextFieldWidget::InsertCharOffsets( uint16 iIndex, const FString& strString )
+{
+	// Stale offsets get rebuilt from the new string the next time they're used.
+	if ( !AreCharOffsetsValid() || iIndex > oTextBuffer.Len() )
 	{
-		//KUILogUO( "iCaretPosition < iRenderStringStart" );
+		bValidCharOffsets = false;
+		return;
+	}
 
-		iRenderStringStart = iCaretPosition;
-		iRenderStringLength = 0;
-		const FVector2D v2Size = GetSize();
+	if ( strString.Len() == 0 )
+		return;
 
-		while ( true )
-		{
-			++iRenderStringLength;
-			//KUILogUO( "iRenderStringLength: %d", iRenderStringLength );
+	TArray<float> arInserted;
+	cmTextComponent->GetCharacterOffsets( strString, arInserted );
 
-			if ( ( iRenderStringStart + iRenderStringLength ) > strFullString.Len() )
-				break;
+	const float fBase = arCharOffsets[ iIndex ];
+	const float fShift = arInserted.Last();
 
-			//KUILogUO( "Text Size: %f", cmTextComponent->GetSize().X );
+	for ( int32 i = iIndex + 1; i < arCharOffsets.Num(); ++i )
+		arCharOffsets[ i ] += fShift;
 
-			if ( cmTextComponent->GetSizeString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) ).X > v2Size.X )
-				break;
-		}
+	arCharOffsets.InsertUninitialized( iIndex + 1, strString.Len() );
 
-		--iRenderStringLength;
-		cmTextComponent->SetTextString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) );
+	for ( int32 i = 1; i < arInserted.Num(); ++i )
+		arCharOffsets[ iIndex + i ] = fBase + arInserted[ i ];
+}
 
-		//KUILogUO( "Done: %d, %d, %s", iRenderStringStart, iRenderStringLength, *cmTextComponent->GetText().ToString() );
-	}
 
-	// Move the rendered text so the caret is on the far right.
-	else if ( iCaretPosition > ( iRenderStringStart + iRenderStringLength ) )
+void UKUITextFieldWidget::RemoveCharOffsets( uint16 iIndex, uint16 iCount )
+{
+	if ( !AreCharOffsetsValid() || iIndex >= oTextBuffer.Len() )
 	{
-		//KUILogUO( "iCaretPosition > ( iRenderStringStart + iRenderStringLength )" );
-		iRenderStringStart = iCaretPosition;
-		iRenderStringLength = 0;
-		const FVector2D v2Size = GetSize();
+		bValidCharOffsets = false;
+		return;
+	}
 
-		while ( true )
-		{
-			if ( iRenderStringStart > 0 )
-			{
-				--iRenderStringStart;
-				++iRenderStringLength;
+	iCount = min( iCount, oTextBuffer.Len() - iIndex );
 
-				//KUILogUO( "iRenderStringStart: %d, iRenderStringLength: %d", iRenderStringStart, iRenderStringLength );
-				//KUILogUO( "Text Size: %f", cmTextComponent->GetSize().X );
+	if ( iCount == 0 )
+		return;
 
-				if ( cmTextComponent->GetSizeString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) ).X > v2Size.X )
-				{
-					++iRenderStringStart;
-					--iRenderStringLength;
-					break;
-				}
-			}
+	const float fShift = arCharOffsets[ iIndex + iCount ] - arCharOffsets[ iIndex ];
 
-			else
-			{
-				++iRenderStringLength;
-				//KUILogUO( "iRenderStringLength: %d", iRenderStringLength );
+	arCharOffsets.RemoveAt( iIndex + 1, iCount );
 
-				if ( ( iRenderStringStart + iRenderStringLength ) > strFullString.Len() )
-				{
-					--iRenderStringLength;
-					break;
-				}
+	for ( int32 i = iIndex + 1; i < arCharOffsets.Num(); ++i )
+		arCharOffsets[ i ] -= fShift;
+}
 
-				//KUILogUO( "Text Size: %f", cmTextComponent->GetSize().X );
 
-				if ( cmTextComponent->GetSizeString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) ).X > v2Size.X )
-				{
-					--iRenderStringLength;
-					break;
-				}
-			}
-		}
+float UKUITextFieldWidget::GetRangeWidth( uint16 iStart, uint16 iEnd )
+{
+	return cmTextComponent->GetRangeWidth( GetCharOffsets(), iStart, iEnd );
+}
+
+
+uint16 UKUITextFieldWidget::GetFittingEnd( uint16 iStart, float fMaxWidth )
+{
+	uint16 iLow = min( iStart, oTextBuffer.Len() );
+	uint16 iHigh = oTextBuffer.Len();
+
+	while ( iLow < iHigh )
+	{
+		const uint16 iMid = ( iLow + iHigh + 1 ) / 2;
 
-		cmTextComponent->SetTextString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) );
-		//KUILogUO( "Done: %d, %d, %s", iRenderStringStart, iRenderStringLength, *cmTextComponent->GetText().ToString() );
+		if ( GetRangeWidth( iStart, iMid ) > fMaxWidth )
+			iHigh = iMid - 1;
+
+		else
+			iLow = iMid;
 	}
 
-	// Re-set the rendered text so that it does not overlap the bounds.
-	else
+	return iLow;
+}
+
+
+uint16 UKUITextFieldWidget::GetFittingStart( uint16 iEnd, float fMaxWidth )
+{
+	uint16 iLow = 0;
+	uint16 iHigh = min( iEnd, oTextBuffer.Len() );
+
+	while ( iLow < iHigh )
 	{
-		//KUILogUO( "else" ) );
-		iRenderStringLength = 0;
-		const FVector2D v2Size = GetSize();
+		const uint16 iMid = ( iLow + iHigh ) / 2;
 
-		while ( true )
-		{
-			if ( ( iRenderStringStart + iRenderStringLength ) < strFullString.Len() )
-			{
-				++iRenderStringLength;
+		if ( GetRangeWidth( iMid, iEnd ) > fMaxWidth )
+			iLow = iMid + 1;
 
-				//KUILogUO( "iRenderStringLength: %d", iRenderStringLength );
-				//float fTextWidth = cmTextComponent->GetSize( strFullString.Mid( iRenderStringStart, iRenderStringLength ) ).X;
-				//KUILogUO( "Text Size: %f %f", fTextWidth, v2Size.X );
+		else
+			iHigh = iMid;
+	}
 
-				if ( cmTextComponent->GetSizeString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) ).X > v2Size.X )
-				{
-					--iRenderStringLength;
-					break;
-				}
-			}
+	return iLow;
+}
 
-			else
-			{
-				if ( iRenderStringStart == 0 )
-					break;
 
-				--iRenderStringStart;
-				++iRenderStringLength;
+void UKUITextFieldWidget::OnWidgetStateChange_Implementation()
+{
+	Super::OnWidgetStateChange_Implementation();
 
-				//KUILogUO( "iRenderStringStart: %d, iRenderStringLength: %d", iRenderStringStart, iRenderStringLength );
-				//KUILogUO( LogTemp, Log, TEXT( "Text Size: %f", cmTextComponent->GetSize().X );
+	//KUILogUO( "OnWidgetStateChange_Implementation() %s", *strFullString );
 
-				if ( cmTextComponent->GetSizeString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) ).X > v2Size.X )
-				{
-					++iRenderStringStart;
-					--iRenderStringLength;
-					break;
-				}
-			}
-		}
+	if ( iCaretPosition < 0 )
+		iCaretPosition = 0;
+
+	else if ( iCaretPosition > oTextBuffer.Len() )
+		iCaretPosition = oTextBuffer.Len();
+
+	//KUILogUO( "Caret Position: %d, %d, %d", iCaretPosition, iRenderStringStart, iRenderStringLength );
+
+	const FVector2D v2Size = GetSize();
 
-		cmTextComponent->SetTextString( strFullString.Mid( iRenderStringStart, iRenderStringLength ) );
-		//KUILogUO( "Done: %d, %d, %s", iRenderStringStart, iRenderStringLength, *cmTextComponent->GetText().ToString() );
+	// Move the rendered text so the caret is on the far left.
+	if ( iCaretPosition < iRenderStringStart )
+	{
+		iRenderStringStart = iCaretPosition;
+		iRenderStringLength = GetFittingEnd( iRenderStringStart, v2Size.X ) - iRenderStringStart;
 	}
 
+	// Move the rendered text so the caret is on the far right, filling to the right if it reaches the start.
+	else if ( iCaretPosition > ( iRenderStringStart + iRenderStringLength ) )
+	{
+		iRenderStringStart = GetFittingStart( iCaretPosition, v2Size.X );
+
+		if ( iRenderStringStart == 0 )
+			iRenderStringLength = GetFittingEnd( 0, v2Size.X );
+
+		else
+			iRenderStringLength = iCaretPosition - iRenderStringStart;
+	}
+
+	// Re-set the rendered text so that it does not overlap the bounds, filling to the left if it reaches the end.
+	else
+	{
+		const uint16 iRenderStringEnd = GetFittingEnd( iRenderStringStart, v2Size.X );
+
+		if ( iRenderStringEnd == oTextBuffer.Len() )
+			iRenderStringStart = GetFittingStart( iRenderStringEnd, v2Size.X );
+
+		iRenderStringLength = iRenderStringEnd - iRenderStringStart;
+	}
+
+	//KUILogUO( "Done: %d, %d", iRenderStringStart, iRenderStringLength );
+	cmTextComponent->SetTextString( oTextBuffer.Mid( iRenderStringStart, iRenderStringLength ) );
+
 	// Find where to render our caret.
 	const uint16 iCaretRenderOffset = iCaretPosition - iRenderStringStart;
 
@@ -715,7 +833,7 @@ void UKUITextFieldWidget::OnWidgetStateChange_Implementation()
 		cmCaret->SetLocation( v2CaretOffset.X + cmTextComponent->GetMargin().X, v2CaretOffset.Y + cmTextComponent->GetMargin().Y );
 
 	else
-		cmCaret->SetLocation( v2CaretOffset.X + cmTextComponent->GetMargin().X + cmTextComponent->GetSizeString( strFullString.Mid( iRenderStringStart, iCaretRenderOffset ) ).X, v2CaretOffset.Y + cmTextComponent->GetMargin().Y );
+		cmCaret->SetLocation( v2CaretOffset.X + cmTextComponent->GetMargin().X + GetRangeWidth( iRenderStringStart, iCaretPosition ), v2CaretOffset.Y + cmTextComponent->GetMargin().Y );
 
 	//KUILogUO( "-----------" );
 	//KUILogUO( "--" );
@@ -736,21 +854,7 @@ void UKUITextFieldWidget::OnTextBoxClick( UKUISimpleClickWidget* cmClicked, cons
 	//KUILogUO( "Focusing" ) );
 	GetInterface()->SetFocus( this );
 
-	float fOffset = 0.f;
-	uint16 iChars = 0;
-
-	while ( true )
-	{
-		++iChars;
-
-		if ( iChars > strFullString.Len() )
-			break;
-
-		if ( cmTextComponent->GetSizeString( strFullString.Mid( iRenderStringStart, iChars ) ).X > v2ClickOffset.X )
-			break;
-	}
-
-	iCaretPosition = iRenderStringStart + iChars - 1;
+	iCaretPosition = GetFittingEnd( iRenderStringStart, v2ClickOffset.X );
 
 	KUISendEvent( FKUIInterfaceEvent, EKUIInterfaceWidgetEventList::E_StateChange );
 }